@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+# Copyright (c) 2022 Tan Li Boon
+
+"""Compares two favonius benchmark logs and flags regressions."""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    results = {}
+    with open(path, encoding="utf-8", errors="replace") as log:
+        for line in log:
+            start = line.find("{")
+            if start < 0:
+                continue
+            try:
+                record = json.loads(line[start:])
+            except ValueError:
+                continue
+            if "bench" in record and record.get("ops"):
+                results[(record["bench"], record["impl"])] = record["cycles"] / record["ops"]
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0, help="regression threshold in percent")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    regressed = False
+    print(f"{'bench':<28} {'impl':<6} {'before':>10} {'after':>10} {'delta':>8}")
+    for key in sorted(baseline.keys() | current.keys()):
+        before = baseline.get(key)
+        after = current.get(key)
+        if before is None or after is None:
+            print(f"{key[0]:<28} {key[1]:<6} {before or '-':>10} {after or '-':>10} {'':>8}")
+            continue
+        delta = (after - before) / before * 100.0 if before else 0.0
+        flag = ""
+        if delta > args.threshold:
+            flag = "  REGRESSION"
+            regressed = True
+        print(f"{key[0]:<28} {key[1]:<6} {before:>10.1f} {after:>10.1f} {delta:>7.1f}%{flag}")
+    return 1 if regressed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,254 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include <sys/dlist.h>
+#include <sys/printk.h>
+#include <sys/ring_buffer.h>
+#include <kernel.h>
+
+#include "latency.hpp"
+#include "list.hpp"
+#include "memory.hpp"
+#include "mutex.hpp"
+#include "ringbuffer.hpp"
+#include "semaphore.hpp"
+
+// Each benchmark runs the same operation through a favonius wrapper ("fav") and through the raw C API ("raw"),
+// and reports the best total of several repetitions. See README.md for the output format.
+
+namespace {
+
+constexpr uint32_t Iterations = 1000;
+constexpr uint32_t Repetitions = 5;
+constexpr size_t HeapSize = 4096;
+
+} // namespace
+
+// Kernel objects of the raw C benchmarks. These are defined at file scope, like in any C application.
+K_HEAP_DEFINE(raw_list_heap, HeapSize);
+K_HEAP_DEFINE(raw_heap, HeapSize);
+RING_BUF_DECLARE(raw_ring, 16 * sizeof(uint32_t));
+K_MUTEX_DEFINE(raw_mutex);
+K_SEM_DEFINE(raw_ping, 0, 1);
+K_SEM_DEFINE(raw_pong, 0, 1);
+
+// A second thread of the same priority as main, for the contended benchmarks.
+K_THREAD_STACK_DEFINE(worker_stack, 2048);
+struct k_thread worker_thread;
+
+namespace {
+
+// Keeps the compiler from discarding results of the measured operations.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    __asm__ volatile("" : : "r,m"(value) : "memory");
+}
+
+void Report(const char* bench, const char* impl, uint32_t ops, uint32_t cycles) {
+    printk("{\"bench\":\"%s\",\"impl\":\"%s\",\"ops\":%u,\"cycles\":%u}\n", bench, impl, ops, cycles);
+}
+
+// Runs body Repetitions times and reports the fastest run.
+template <typename Body>
+void Run(const char* bench, const char* impl, uint32_t ops, Body&& body) {
+    uint32_t best = UINT32_MAX;
+    for (uint32_t r = 0; r < Repetitions; ++r) {
+        fav::Stopwatch stopwatch;
+        body();
+        const uint32_t elapsed = stopwatch.ElapsedCycles();
+        best = (elapsed < best) ? elapsed : best;
+    }
+    Report(bench, impl, ops, best);
+}
+
+template <typename Function>
+void StartWorker(Function& fn) {
+    k_thread_create(&worker_thread, worker_stack, K_THREAD_STACK_SIZEOF(worker_stack),
+                    [](void* p1, void*, void*) { (*static_cast<Function*>(p1))(); },
+                    &fn, nullptr, nullptr, k_thread_priority_get(k_current_get()), 0, K_NO_WAIT);
+}
+
+void JoinWorker() {
+    [[maybe_unused]] int ec = k_thread_join(&worker_thread, K_FOREVER);
+}
+
+void BenchLoopOverhead() {
+    Run("loop_overhead", "raw", Iterations, [] {
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            DoNotOptimize(i);
+        }
+    });
+}
+
+struct RawNode {
+    uint32_t value;
+    sys_dnode_t dnode;
+};
+
+fav::List<uint32_t, HeapSize> fav_list;
+
+void BenchList() {
+    Run("list_push_pop", "raw", Iterations, [] {
+        sys_dlist_t list;
+        sys_dlist_init(&list);
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            RawNode* node = static_cast<RawNode*>(k_heap_alloc(&raw_list_heap, sizeof(RawNode), K_NO_WAIT));
+            node->value = i;
+            sys_dlist_append(&list, &node->dnode);
+            sys_dnode_t* head = sys_dlist_peek_head(&list);
+            sys_dlist_remove(head);
+            RawNode* popped = CONTAINER_OF(head, RawNode, dnode);
+            DoNotOptimize(popped->value);
+            k_heap_free(&raw_list_heap, popped);
+        }
+    });
+    Run("list_push_pop", "fav", Iterations, [] {
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            fav_list.PushBack(i);
+            DoNotOptimize(fav_list.PopFront());
+        }
+    });
+}
+
+struct Item {
+    uint32_t words[4];
+};
+
+ztd::allocator<Item, HeapSize> fav_allocator;
+
+void BenchAllocator() {
+    Run("alloc_free", "raw", Iterations, [] {
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            void* p = k_heap_alloc(&raw_heap, sizeof(Item), K_NO_WAIT);
+            DoNotOptimize(p);
+            k_heap_free(&raw_heap, p);
+        }
+    });
+    Run("alloc_free", "fav", Iterations, [] {
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            Item* p = fav_allocator.allocate(1);
+            DoNotOptimize(p);
+            fav_allocator.deallocate(p, 1);
+        }
+    });
+}
+
+fav::RingBuffer<uint32_t, 16> fav_ring;
+
+void BenchRingBuffer() {
+    Run("ringbuffer_push_pop", "raw", Iterations, [] {
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            uint32_t value = i;
+            [[maybe_unused]] uint32_t put = ring_buf_put(&raw_ring, reinterpret_cast<uint8_t*>(&value), sizeof(value));
+            [[maybe_unused]] uint32_t got = ring_buf_get(&raw_ring, reinterpret_cast<uint8_t*>(&value), sizeof(value));
+            DoNotOptimize(value);
+        }
+    });
+    Run("ringbuffer_push_pop", "fav", Iterations, [] {
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            uint32_t value = i;
+            fav_ring.Push(value);
+            fav_ring.Pop(value);
+            DoNotOptimize(value);
+        }
+    });
+}
+
+ztd::mutex fav_mutex;
+
+void BenchMutexUncontended() {
+    Run("mutex_uncontended", "raw", Iterations, [] {
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            [[maybe_unused]] int ec = k_mutex_lock(&raw_mutex, K_FOREVER);
+            ec = k_mutex_unlock(&raw_mutex);
+        }
+    });
+    Run("mutex_uncontended", "fav", Iterations, [] {
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            fav_mutex.lock();
+            fav_mutex.unlock();
+        }
+    });
+}
+
+// Both threads yield while holding the lock, so every acquisition by the other thread has to block.
+void BenchMutexContended() {
+    auto raw_loop = [] {
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            [[maybe_unused]] int ec = k_mutex_lock(&raw_mutex, K_FOREVER);
+            k_yield();
+            ec = k_mutex_unlock(&raw_mutex);
+        }
+    };
+    Run("mutex_contended", "raw", 2 * Iterations, [&raw_loop] {
+        StartWorker(raw_loop);
+        raw_loop();
+        JoinWorker();
+    });
+
+    auto fav_loop = [] {
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            fav_mutex.lock();
+            k_yield();
+            fav_mutex.unlock();
+        }
+    };
+    Run("mutex_contended", "fav", 2 * Iterations, [&fav_loop] {
+        StartWorker(fav_loop);
+        fav_loop();
+        JoinWorker();
+    });
+}
+
+ztd::binary_semaphore fav_ping(0);
+ztd::binary_semaphore fav_pong(0);
+
+// One operation is a full round trip: main signals the worker and waits for its answer.
+void BenchSemaphorePingPong() {
+    auto raw_echo = [] {
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            [[maybe_unused]] int ec = k_sem_take(&raw_ping, K_FOREVER);
+            k_sem_give(&raw_pong);
+        }
+    };
+    Run("semaphore_ping_pong", "raw", Iterations, [&raw_echo] {
+        StartWorker(raw_echo);
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            k_sem_give(&raw_ping);
+            [[maybe_unused]] int ec = k_sem_take(&raw_pong, K_FOREVER);
+        }
+        JoinWorker();
+    });
+
+    auto fav_echo = [] {
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            fav_ping.acquire();
+            fav_pong.release();
+        }
+    };
+    Run("semaphore_ping_pong", "fav", Iterations, [&fav_echo] {
+        StartWorker(fav_echo);
+        for (uint32_t i = 0; i < Iterations; ++i) {
+            fav_ping.release();
+            fav_pong.acquire();
+        }
+        JoinWorker();
+    });
+}
+
+} // namespace
+
+void main(void) {
+    printk("{\"suite\":\"favonius\",\"board\":\"%s\",\"cycles_per_sec\":%u}\n", CONFIG_BOARD,
+           static_cast<uint32_t>(sys_clock_hw_cycles_per_sec()));
+
+    BenchLoopOverhead();
+    BenchList();
+    BenchAllocator();
+    BenchRingBuffer();
+    BenchMutexUncontended();
+    BenchMutexContended();
+    BenchSemaphorePingPong();
+
+    printk("{\"done\":true}\n");
+}
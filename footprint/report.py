@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+# Copyright (c) 2022 Tan Li Boon
+
+"""Per-type ROM/RAM footprint report of favonius, with growth checks against a stored baseline.
+
+Symbols from `nm --size-sort` are attributed to the class template instantiation (or class, or namespace)
+that owns them, e.g. every member function of fav::List<unsigned int, 0u, ztd::allocator> is summed into one row.
+Objects in namespace footprint are listed under their own names, which is where embedded heaps,
+buffers and thread stacks show up. The linker map gives the totals of the non-template library code.
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+
+ROM_TYPES = set("tTrRwW")
+RAM_TYPES = set("bBdDvV")
+INIT_DATA_TYPES = set("dDvV")  # Initialized data also occupies ROM for its initializer.
+PREFIXES = ("vtable for ", "typeinfo for ", "typeinfo name for ", "guard variable for ", "non-virtual thunk to ")
+
+
+def split_scope(name):
+    """Splits a demangled name on '::' outside of template arguments and parameter lists."""
+    parts, depth, start, i = [], 0, 0, 0
+    while i < len(name):
+        c = name[i]
+        if c in "<({[":
+            depth += 1
+        elif c in ">)}]":
+            depth -= 1
+        elif depth == 0 and name.startswith("::", i):
+            parts.append(name[start:i])
+            start = i + 2
+            i += 1
+        i += 1
+    parts.append(name[start:])
+    return parts
+
+
+def owner_of(symbol):
+    """Returns the type a symbol belongs to, or the symbol itself for free objects."""
+    for prefix in PREFIXES:
+        if symbol.startswith(prefix):
+            symbol = symbol[len(prefix):]
+    depth = 0
+    for i, c in enumerate(symbol):
+        if c in "<{[":
+            depth += 1
+        elif c in ">}]":
+            depth -= 1
+        elif c == "(" and depth == 0:
+            # A function: drop the parameter list and the function name.
+            parts = split_scope(symbol[:i])
+            break
+    else:
+        return symbol
+    scope = []
+    for part in parts[:-1]:
+        scope.append(part)
+        if "<" in part:
+            # Nested classes (e.g. List<...>::Node) count towards the enclosing instantiation.
+            break
+    return "::".join(scope) if scope else symbol
+
+
+def read_symbols(nm, elf, namespaces):
+    output = subprocess.run([nm, "--size-sort", "--print-size", "--demangle", elf],
+                            check=True, capture_output=True, text=True).stdout
+    types = {}
+    for line in output.splitlines():
+        fields = line.split(None, 3)
+        if len(fields) != 4:
+            continue
+        size, kind, name = int(fields[1], 16), fields[2], fields[3]
+        if not name.startswith(namespaces) and not any(name.startswith(p + ns) for p in PREFIXES for ns in namespaces):
+            continue
+        entry = types.setdefault(owner_of(name), {"rom": 0, "ram": 0})
+        if kind in ROM_TYPES:
+            entry["rom"] += size
+        elif kind in RAM_TYPES:
+            entry["ram"] += size
+            if kind in INIT_DATA_TYPES:
+                entry["rom"] += size
+    return types
+
+
+MAP_SECTION = re.compile(r"^ (\.[\w.$]+)(?:\s+0x[0-9a-f]+\s+0x([0-9a-f]+)\s+(\S+))?\s*$")
+MAP_CONTINUATION = re.compile(r"^\s+0x[0-9a-f]+\s+0x([0-9a-f]+)\s+(\S+)\s*$")
+
+
+def read_map(path, library):
+    """Sums input sections of the favonius library's object files, per object file."""
+    objects = {}
+    pending = None
+
+    def add(section, size, source):
+        match = re.search(r"\(([^)]+)\)$", source)
+        if library not in source or not match:
+            return
+        entry = objects.setdefault(match.group(1), {"rom": 0, "ram": 0})
+        if section.startswith((".text", ".rodata")):
+            entry["rom"] += size
+        elif section.startswith(".data"):
+            entry["rom"] += size
+            entry["ram"] += size
+        elif section.startswith((".bss", ".noinit")):
+            entry["ram"] += size
+
+    with open(path, encoding="utf-8", errors="replace") as mapfile:
+        for line in mapfile:
+            if pending is not None:
+                match = MAP_CONTINUATION.match(line)
+                if match:
+                    add(pending, int(match.group(1), 16), match.group(2))
+                pending = None
+                continue
+            match = MAP_SECTION.match(line)
+            if match:
+                if match.group(2) is None:
+                    pending = match.group(1)  # Long section names wrap onto the next line.
+                else:
+                    add(match.group(1), int(match.group(2), 16), match.group(3))
+    return objects
+
+
+def print_table(title, rows, baseline, threshold):
+    grown = []
+    print(f"\n{title}")
+    print(f"{'ROM':>8} {'RAM':>8} {'dROM':>8} {'dRAM':>8}  name")
+    for name, sizes in sorted(rows.items(), key=lambda item: -(item[1]["rom"] + item[1]["ram"])):
+        before = baseline.get(name)
+        flag, delta_rom, delta_ram = "", "", ""
+        if before is None:
+            if baseline:
+                flag = "  NEW"
+                grown.append(name)
+        else:
+            d_rom, d_ram = sizes["rom"] - before["rom"], sizes["ram"] - before["ram"]
+            delta_rom, delta_ram = f"{d_rom:+d}", f"{d_ram:+d}"
+            if d_rom > before["rom"] * threshold / 100.0 or d_ram > before["ram"] * threshold / 100.0:
+                flag = "  GREW"
+                grown.append(name)
+        print(f"{sizes['rom']:>8} {sizes['ram']:>8} {delta_rom:>8} {delta_ram:>8}  {name}{flag}")
+    total_rom = sum(sizes["rom"] for sizes in rows.values())
+    total_ram = sum(sizes["ram"] for sizes in rows.values())
+    print(f"{total_rom:>8} {total_ram:>8} {'':>8} {'':>8}  (total)")
+    return grown
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--nm", default="nm")
+    parser.add_argument("--elf", required=True)
+    parser.add_argument("--map", required=True)
+    parser.add_argument("--baseline", required=True, help="JSON file with the stored baseline")
+    parser.add_argument("--library", default="favonius", help="substring of the library archive in the map")
+    parser.add_argument("--namespace", action="append", default=None,
+                        help="namespaces to report (default: fav::, ztd::, footprint::)")
+    parser.add_argument("--threshold", type=float, default=0.0, help="allowed growth in percent")
+    parser.add_argument("--update-baseline", action="store_true")
+    args = parser.parse_args()
+
+    namespaces = tuple(args.namespace or ["fav::", "ztd::", "footprint::"])
+    report = {
+        "types": read_symbols(args.nm, args.elf, namespaces),
+        "library": read_map(args.map, args.library),
+    }
+
+    if args.update_baseline:
+        os.makedirs(os.path.dirname(os.path.abspath(args.baseline)), exist_ok=True)
+        with open(args.baseline, "w", encoding="utf-8") as out:
+            json.dump(report, out, indent=2, sort_keys=True)
+            out.write("\n")
+        print(f"Baseline written to {args.baseline}")
+        return 0
+
+    baseline = {"types": {}, "library": {}}
+    if os.path.exists(args.baseline):
+        with open(args.baseline, encoding="utf-8") as stored:
+            baseline = json.load(stored)
+    else:
+        print(f"No baseline at {args.baseline}; build the footprint_baseline target to record one.")
+
+    grown = print_table("Per type (nm)", report["types"], baseline.get("types", {}), args.threshold)
+    grown += print_table("Library objects (linker map)", report["library"], baseline.get("library", {}), args.threshold)
+    if grown:
+        print(f"\n{len(grown)} entries grew beyond {args.threshold}% of the baseline.")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
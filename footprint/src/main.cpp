@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include <sys/printk.h>
+#include <kernel.h>
+
+#include "barrier.hpp"
+#include "condition_variable.hpp"
+#include "latch.hpp"
+#include "list.hpp"
+#include "memory.hpp"
+#include "mutex.hpp"
+#include "ringbuffer.hpp"
+#include "semaphore.hpp"
+#include "seqlock.hpp"
+#include "shared_mutex.hpp"
+#include "thread.hpp"
+
+// Representative instantiations for the footprint report (see report.py).
+// Every object lives in namespace footprint, so that its static RAM shows up under its own name,
+// and each is used once below so that the member functions it needs are instantiated and linked in.
+// The code is run once at boot, but it only exists to be measured.
+
+namespace footprint {
+
+struct Item {
+    uint32_t id;
+    uint32_t words[3];
+};
+
+fav::List<uint32_t> list_u32_global_heap;
+fav::List<Item, 512> list_item_512;
+
+fav::RingBuffer<uint32_t, 16> ring_u32_16;
+fav::RingBuffer<Item, 64> ring_item_64;
+
+ztd::allocator<Item, 256> allocator_item_256;
+
+ztd::mutex mutex;
+ztd::timed_mutex timed_mutex;
+ztd::shared_mutex shared_mutex;
+ztd::condition_variable condition_variable;
+ztd::counting_semaphore<8> semaphore_8(0);
+ztd::latch latch(1);
+ztd::barrier<> barrier(1);
+fav::SeqLock<Item> seqlock_item;
+
+// ztd::thread embeds its stack, which dominates its RAM cost.
+ztd::thread thread;
+
+void Exercise() {
+    list_u32_global_heap.PushBack(1);
+    list_u32_global_heap.PopFront();
+    list_item_512.PushBack(Item{});
+    list_item_512.PopFront();
+
+    ring_u32_16.Push(1);
+    ring_u32_16.Pop();
+    ring_item_64.Push(Item{});
+    Item item;
+    ring_item_64.Pop(item);
+
+    allocator_item_256.deallocate(allocator_item_256.allocate(1), 1);
+
+    {
+        ztd::unique_lock<ztd::mutex> lock(mutex);
+        condition_variable.notify_all();
+        [[maybe_unused]] ztd::cv_status status = condition_variable.wait_for(lock, ztd::milliseconds(1));
+    }
+    if (timed_mutex.try_lock_for(1)) {
+        timed_mutex.unlock();
+    }
+    {
+        ztd::shared_lock<ztd::shared_mutex> lock(shared_mutex);
+    }
+
+    semaphore_8.release();
+    semaphore_8.acquire();
+
+    latch.count_down();
+    latch.wait();
+    barrier.arrive_and_wait();
+
+    seqlock_item.Write(item);
+    item = seqlock_item.Read();
+
+    printk("%p %p\n", static_cast<void*>(&thread), static_cast<void*>(&item));
+}
+
+} // namespace footprint
+
+void main(void) {
+    footprint::Exercise();
+    printk("footprint: done\n");
+}
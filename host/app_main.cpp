@@ -0,0 +1,12 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+// Runs a Zephyr application on the host. Zephyr 2.7 applications define void main(void), which is not a valid
+// hosted main(), so the application's sources are compiled with main renamed to z_host_app_main.
+
+void z_host_app_main(void);
+
+int main() {
+    z_host_app_main();
+    return 0;
+}
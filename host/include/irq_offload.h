@@ -0,0 +1,15 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_HOST_IRQ_OFFLOAD_H_
+#define _FAVONIUS_HOST_IRQ_OFFLOAD_H_
+
+// Host stand-in for Zephyr's irq_offload.h. The routine runs on the calling thread with k_is_in_isr() returning true,
+// so that the kernel stand-in asserts on calls which Zephyr forbids in an ISR. It does not keep other threads from
+// running meanwhile.
+
+typedef void (*irq_offload_routine_t)(const void* parameter);
+
+void irq_offload(irq_offload_routine_t routine, const void* parameter);
+
+#endif // _FAVONIUS_HOST_IRQ_OFFLOAD_H_
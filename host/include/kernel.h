@@ -0,0 +1,261 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_HOST_KERNEL_H_
+#define _FAVONIUS_HOST_KERNEL_H_
+
+// Host stand-in for the subset of the Zephyr 2.7 kernel API used by favonius, so that the library can be
+// compiled, tested and profiled on a workstation (see FAVONIUS_HOST_BUILD in CMakeLists.txt).
+// Threads are pthreads, kernel objects are built on pthread mutexes and monotonic condition variables,
+// and the cycle counter is CLOCK_MONOTONIC in nanoseconds. Scheduling is up to the host: priorities, EDF deadlines,
+// suspend and resume are recorded or ignored. There is no user mode, so k_futex is not available.
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <spinlock.h>
+#include <toolchain.h>
+#include <sys/atomic.h>
+#include <sys/dlist.h>
+#include <sys/printk.h>
+#include <sys/slist.h>
+#include <sys/util.h>
+
+#ifndef CONFIG_BOARD
+#define CONFIG_BOARD "host"
+#endif
+#ifndef CONFIG_SYS_CLOCK_TICKS_PER_SEC
+#define CONFIG_SYS_CLOCK_TICKS_PER_SEC 10000
+#endif
+#define CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC 1000000000
+#define CONFIG_SYS_CLOCK_EXISTS 1
+#define CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER 1
+#define CONFIG_TIMEOUT_64BIT 1
+
+// Assertions are checked unless NDEBUG is defined, which makes them useful under fuzzers and sanitizers.
+#if defined(NDEBUG)
+#define __ASSERT(test, fmt, ...) ((void)sizeof(test))
+#else
+#define __ASSERT(test, fmt, ...)                                                     \
+    do {                                                                             \
+        if (!(test)) {                                                               \
+            printk("ASSERTION FAIL [%s] @ %s:%d: " fmt "\n", #test, __FILE__, __LINE__, ##__VA_ARGS__); \
+            abort();                                                                 \
+        }                                                                            \
+    } while (false)
+#endif
+#define __ASSERT_NO_MSG(test) __ASSERT(test, "")
+
+// Timeouts
+
+typedef int64_t k_ticks_t;
+
+typedef struct {
+    k_ticks_t ticks;
+} k_timeout_t;
+
+#define K_TICKS_FOREVER ((k_ticks_t)-1)
+#define Z_TIMEOUT_TICKS(t) (k_timeout_t{(k_ticks_t)(t)})
+#define K_NO_WAIT Z_TIMEOUT_TICKS(0)
+#define K_FOREVER Z_TIMEOUT_TICKS(K_TICKS_FOREVER)
+#define K_TICKS(t) Z_TIMEOUT_TICKS((t) < 0 ? 0 : (t))
+#define K_NSEC(t) Z_TIMEOUT_TICKS(k_ns_to_ticks_ceil64(t))
+#define K_USEC(t) Z_TIMEOUT_TICKS(k_us_to_ticks_ceil64(t))
+#define K_MSEC(t) Z_TIMEOUT_TICKS(k_ms_to_ticks_ceil64(t))
+#define K_SECONDS(s) K_MSEC((s) * 1000)
+#define K_MINUTES(m) K_SECONDS((m) * 60)
+#define K_HOURS(h) K_MINUTES((h) * 60)
+// Absolute timeouts are encoded below K_TICKS_FOREVER, as in Zephyr.
+#define Z_TICK_ABS(t) (K_TICKS_FOREVER - 1 - (t))
+#define K_TIMEOUT_ABS_TICKS(t) Z_TIMEOUT_TICKS(Z_TICK_ABS((k_ticks_t)(t) < 0 ? 0 : (t)))
+#define K_TIMEOUT_ABS_MS(t) K_TIMEOUT_ABS_TICKS(k_ms_to_ticks_ceil64(t))
+#define K_TIMEOUT_EQ(a, b) ((a).ticks == (b).ticks)
+
+static inline uint64_t z_ceil_div(uint64_t value, uint64_t divisor) { return (value + divisor - 1) / divisor; }
+
+static inline uint64_t k_ns_to_ticks_ceil64(uint64_t ns) { return z_ceil_div(ns * CONFIG_SYS_CLOCK_TICKS_PER_SEC, 1000000000ULL); }
+static inline uint64_t k_us_to_ticks_ceil64(uint64_t us) { return z_ceil_div(us * CONFIG_SYS_CLOCK_TICKS_PER_SEC, 1000000ULL); }
+static inline uint64_t k_ms_to_ticks_ceil64(uint64_t ms) { return z_ceil_div(ms * CONFIG_SYS_CLOCK_TICKS_PER_SEC, 1000ULL); }
+static inline uint64_t k_ticks_to_ms_floor64(uint64_t ticks) { return ticks * 1000ULL / CONFIG_SYS_CLOCK_TICKS_PER_SEC; }
+static inline uint64_t k_ticks_to_us_floor64(uint64_t ticks) { return ticks * 1000000ULL / CONFIG_SYS_CLOCK_TICKS_PER_SEC; }
+static inline uint64_t k_ticks_to_ns_floor64(uint64_t ticks) { return ticks * (1000000000ULL / CONFIG_SYS_CLOCK_TICKS_PER_SEC); }
+
+// The host cycle counter counts nanoseconds.
+static inline uint32_t sys_clock_hw_cycles_per_sec(void) { return CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC; }
+static inline uint64_t k_cyc_to_ns_floor64(uint64_t cycles) { return cycles; }
+static inline uint64_t k_cyc_to_us_floor64(uint64_t cycles) { return cycles / 1000ULL; }
+static inline uint32_t k_ns_to_cyc_ceil32(uint64_t ns) { return (uint32_t)ns; }
+static inline uint64_t k_ns_to_cyc_ceil64(uint64_t ns) { return ns; }
+static inline uint32_t k_us_to_cyc_ceil32(uint64_t us) { return (uint32_t)(us * 1000ULL); }
+static inline uint32_t k_ticks_to_cyc_ceil32(uint64_t ticks) { return (uint32_t)k_ticks_to_ns_floor64(ticks); }
+
+int64_t k_uptime_ticks(void);
+static inline int64_t k_uptime_get(void) { return (int64_t)k_ticks_to_ms_floor64((uint64_t)k_uptime_ticks()); }
+static inline uint32_t k_uptime_get_32(void) { return (uint32_t)k_uptime_get(); }
+uint64_t k_cycle_get_64(void);
+static inline uint32_t k_cycle_get_32(void) { return (uint32_t)k_cycle_get_64(); }
+
+// Threads
+
+#define K_ESSENTIAL (1 << 0)
+#define K_FP_REGS (1 << 1)
+#define K_USER (1 << 2)
+#define K_INHERIT_PERMS (1 << 3)
+
+#define K_PRIO_COOP(x) (-16 + (x))
+#define K_PRIO_PREEMPT(x) (x)
+#define K_LOWEST_THREAD_PRIO 15
+#define K_IDLE_PRIO K_LOWEST_THREAD_PRIO
+
+typedef void (*k_thread_entry_t)(void* p1, void* p2, void* p3);
+
+struct z_thread_stack_element {
+    char data;
+};
+typedef struct z_thread_stack_element k_thread_stack_t;
+
+// Host threads run on their own pthread stacks; the Zephyr stack objects only reserve the memory.
+#define K_KERNEL_STACK_DEFINE(sym, size) struct z_thread_stack_element sym[size]
+#define K_KERNEL_STACK_MEMBER(sym, size) struct z_thread_stack_element sym[size]
+#define K_THREAD_STACK_DEFINE(sym, size) struct z_thread_stack_element sym[size]
+#define K_THREAD_STACK_MEMBER(sym, size) struct z_thread_stack_element sym[size]
+#define K_THREAD_STACK_SIZEOF(sym) sizeof(sym)
+#define K_KERNEL_STACK_SIZEOF(sym) sizeof(sym)
+
+struct k_thread {
+    pthread_t handle;
+    k_thread_entry_t entry;
+    void* p1;
+    void* p2;
+    void* p3;
+    k_timeout_t delay;
+    int priority;
+    int deadline;
+    void* custom_data;
+    char name[32];
+    atomic_t state; // See source/kernel.cpp.
+};
+
+typedef struct k_thread* k_tid_t;
+
+k_tid_t k_thread_create(struct k_thread* new_thread, k_thread_stack_t* stack, size_t stack_size, k_thread_entry_t entry,
+                        void* p1, void* p2, void* p3, int prio, uint32_t options, k_timeout_t delay);
+void k_thread_start(k_tid_t thread);
+int k_thread_join(struct k_thread* thread, k_timeout_t timeout);
+k_tid_t k_current_get(void);
+
+const char* k_thread_name_get(k_tid_t thread);
+int k_thread_name_set(k_tid_t thread, const char* str);
+const char* k_thread_state_str(k_tid_t thread);
+static inline int k_thread_priority_get(k_tid_t thread) { return thread->priority; }
+static inline void k_thread_priority_set(k_tid_t thread, int prio) { thread->priority = prio; }
+static inline void k_thread_deadline_set(k_tid_t thread, int deadline) { thread->deadline = deadline; }
+// Not supported on the host.
+static inline void k_thread_suspend(k_tid_t thread) { ARG_UNUSED(thread); }
+static inline void k_thread_resume(k_tid_t thread) { ARG_UNUSED(thread); }
+static inline void k_thread_custom_data_set(void* value) { k_current_get()->custom_data = value; }
+static inline void* k_thread_custom_data_get(void) { return k_current_get()->custom_data; }
+
+void k_yield(void);
+int32_t k_sleep(k_timeout_t timeout);
+static inline int32_t k_msleep(int32_t ms) { return k_sleep(K_MSEC(ms)); }
+static inline int32_t k_usleep(int32_t us) { return k_sleep(K_USEC(us)); }
+void k_busy_wait(uint32_t usec_to_wait);
+
+// Interrupts. The host has none; see irq_offload.h for running code as if in an ISR.
+
+bool k_is_in_isr(void);
+
+// Synchronization. Every object must be initialized with its k_*_init() function, or defined with K_*_DEFINE().
+// The K_*_DEFINE() macros initialize the object during static initialization of the defining translation unit.
+
+#define Z_HOST_STATIC_INIT(name, init) [[maybe_unused]] static const int _z_host_init_##name = ((init), 0)
+
+struct k_mutex {
+    pthread_mutex_t guard;
+    pthread_cond_t unlocked;
+    struct k_thread* owner;
+    uint32_t lock_count;
+};
+
+#define K_MUTEX_DEFINE(name) \
+    struct k_mutex name;     \
+    Z_HOST_STATIC_INIT(name, k_mutex_init(&name))
+
+int k_mutex_init(struct k_mutex* mutex);
+int k_mutex_lock(struct k_mutex* mutex, k_timeout_t timeout);
+int k_mutex_unlock(struct k_mutex* mutex);
+
+// Unlike Zephyr's, waits may end spuriously, as with pthread condition variables. Callers must recheck their condition.
+struct k_condvar {
+    pthread_cond_t cond;
+    struct k_mutex* mutex; // The mutex of the current waiters, set by k_condvar_wait().
+};
+
+#define K_CONDVAR_DEFINE(name) \
+    struct k_condvar name;     \
+    Z_HOST_STATIC_INIT(name, k_condvar_init(&name))
+
+int k_condvar_init(struct k_condvar* condvar);
+int k_condvar_signal(struct k_condvar* condvar);
+int k_condvar_broadcast(struct k_condvar* condvar);
+int k_condvar_wait(struct k_condvar* condvar, struct k_mutex* mutex, k_timeout_t timeout);
+
+struct k_sem {
+    pthread_mutex_t guard;
+    pthread_cond_t available;
+    unsigned int count;
+    unsigned int limit;
+};
+
+#define K_SEM_MAX_LIMIT UINT32_MAX
+
+#define K_SEM_DEFINE(name, initial_count, count_limit) \
+    struct k_sem name;                                 \
+    Z_HOST_STATIC_INIT(name, k_sem_init(&name, initial_count, count_limit))
+
+int k_sem_init(struct k_sem* sem, unsigned int initial_count, unsigned int limit);
+void k_sem_give(struct k_sem* sem);
+int k_sem_take(struct k_sem* sem, k_timeout_t timeout);
+void k_sem_reset(struct k_sem* sem);
+unsigned int k_sem_count_get(struct k_sem* sem);
+
+// Memory. A k_heap hands out blocks from the host allocator, so that sanitizers see every block,
+// but refuses allocations beyond its capacity. Its bookkeeping overhead differs from sys_heap.
+
+#define Z_HEAP_MIN_SIZE 16
+
+struct sys_heap {
+    void* init_mem;
+    size_t init_bytes;
+};
+
+struct k_heap {
+    struct sys_heap heap;
+    pthread_mutex_t guard;
+    size_t used;
+};
+
+#define K_HEAP_DEFINE(name, bytes) \
+    struct k_heap name;            \
+    Z_HOST_STATIC_INIT(name, k_heap_init(&name, NULL, bytes))
+
+void k_heap_init(struct k_heap* heap, void* mem, size_t bytes);
+// Never waits; the timeout is ignored.
+void* k_heap_alloc(struct k_heap* heap, size_t bytes, k_timeout_t timeout);
+void* k_heap_aligned_alloc(struct k_heap* heap, size_t align, size_t bytes, k_timeout_t timeout);
+void k_heap_free(struct k_heap* heap, void* mem);
+
+static inline void* k_malloc(size_t size) { return malloc(size); }
+static inline void* k_aligned_alloc(size_t align, size_t size) {
+    void* ptr = NULL;
+    return (posix_memalign(&ptr, align, size) == 0) ? ptr : NULL;
+}
+static inline void* k_calloc(size_t nmemb, size_t size) { return calloc(nmemb, size); }
+static inline void k_free(void* ptr) { free(ptr); }
+
+#endif // _FAVONIUS_HOST_KERNEL_H_
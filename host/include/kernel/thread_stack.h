@@ -0,0 +1,11 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_HOST_KERNEL_THREAD_STACK_H_
+#define _FAVONIUS_HOST_KERNEL_THREAD_STACK_H_
+
+// The stack macros are defined in kernel.h on the host.
+
+#include <kernel.h>
+
+#endif // _FAVONIUS_HOST_KERNEL_THREAD_STACK_H_
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_HOST_NET_BUF_H_
+#define _FAVONIUS_HOST_NET_BUF_H_
+
+// Host stand-in for the fixed-size pools and the data and fragment API of Zephyr's net/buf.h.
+// Buffers find their pool through a pointer rather than a pool index in a linker section. Allocation with a timeout
+// polls the pool. Reference counts are guarded by the pool, as the original guards them by locking interrupts.
+
+#include <kernel.h>
+
+#ifndef CONFIG_NET_BUF_POOL_USAGE
+#define CONFIG_NET_BUF_POOL_USAGE 1
+#endif
+
+struct net_buf_pool;
+
+struct net_buf {
+    // The next fragment of the chain, or of the free list of the pool.
+    struct net_buf* frags;
+    uint8_t ref;
+    uint8_t flags;
+    uint8_t pool_id;
+    uint8_t* data;
+    uint16_t len;
+    uint16_t size;
+    uint8_t* __buf;
+    struct net_buf_pool* pool;
+};
+
+struct net_buf_pool {
+    uint16_t buf_count;
+    uint16_t uninit_count;
+    uint16_t avail_count;
+    uint16_t data_size;
+    struct net_buf* bufs;
+    uint8_t* data;
+    struct net_buf* free;
+    void (*destroy)(struct net_buf* buf);
+    pthread_mutex_t guard;
+};
+
+#define NET_BUF_POOL_FIXED_DEFINE(_name, _count, _data_size, _destroy)                                    \
+    static struct net_buf _net_buf_##_name[(_count)];                                                     \
+    static uint8_t _net_buf_data_##_name[(_count) * (_data_size)];                                        \
+    static struct net_buf_pool _name = {(_count), (_count), (_count), (_data_size), _net_buf_##_name,    \
+                                        _net_buf_data_##_name, NULL, (_destroy), PTHREAD_MUTEX_INITIALIZER}
+
+struct net_buf* net_buf_alloc_fixed(struct net_buf_pool* pool, k_timeout_t timeout);
+#define net_buf_alloc net_buf_alloc_fixed
+
+struct net_buf* net_buf_ref(struct net_buf* buf);
+// Drops a reference. The last one frees the buffer and drops the reference it held to the next fragment.
+void net_buf_unref(struct net_buf* buf);
+void net_buf_destroy(struct net_buf* buf);
+
+static inline void net_buf_reset(struct net_buf* buf) {
+    buf->len = 0;
+    buf->data = buf->__buf;
+}
+
+static inline void net_buf_reserve(struct net_buf* buf, size_t reserve) {
+    buf->data = buf->__buf + reserve;
+}
+
+static inline size_t net_buf_headroom(struct net_buf* buf) { return (size_t)(buf->data - buf->__buf); }
+static inline size_t net_buf_tailroom(struct net_buf* buf) { return buf->size - net_buf_headroom(buf) - buf->len; }
+static inline uint8_t* net_buf_tail(struct net_buf* buf) { return buf->data + buf->len; }
+
+void* net_buf_add(struct net_buf* buf, size_t len);
+void* net_buf_add_mem(struct net_buf* buf, const void* mem, size_t len);
+uint8_t* net_buf_add_u8(struct net_buf* buf, uint8_t val);
+void net_buf_add_le16(struct net_buf* buf, uint16_t val);
+void net_buf_add_be16(struct net_buf* buf, uint16_t val);
+void net_buf_add_le32(struct net_buf* buf, uint32_t val);
+void net_buf_add_be32(struct net_buf* buf, uint32_t val);
+void* net_buf_remove_mem(struct net_buf* buf, size_t len);
+
+void* net_buf_push(struct net_buf* buf, size_t len);
+void net_buf_push_u8(struct net_buf* buf, uint8_t val);
+void net_buf_push_le16(struct net_buf* buf, uint16_t val);
+void net_buf_push_be16(struct net_buf* buf, uint16_t val);
+
+// Returns the new start of the data.
+void* net_buf_pull(struct net_buf* buf, size_t len);
+// Returns the old start of the data, i.e. the bytes pulled.
+void* net_buf_pull_mem(struct net_buf* buf, size_t len);
+uint8_t net_buf_pull_u8(struct net_buf* buf);
+uint16_t net_buf_pull_le16(struct net_buf* buf);
+uint16_t net_buf_pull_be16(struct net_buf* buf);
+uint32_t net_buf_pull_le32(struct net_buf* buf);
+uint32_t net_buf_pull_be32(struct net_buf* buf);
+
+struct net_buf* net_buf_frag_last(struct net_buf* frags);
+// Inserts frag, and any fragments after it, after parent. The reference to frag is taken over.
+void net_buf_frag_insert(struct net_buf* parent, struct net_buf* frag);
+// Adds frag at the end of the chain of head. The reference to frag is taken over, unless head is NULL.
+struct net_buf* net_buf_frag_add(struct net_buf* head, struct net_buf* frag);
+// Unlinks frag from parent (which may be NULL) and drops its reference. Returns the fragment after it.
+struct net_buf* net_buf_frag_del(struct net_buf* parent, struct net_buf* frag);
+
+size_t net_buf_linearize(void* dst, size_t dst_len, struct net_buf* src, size_t offset, size_t len);
+
+static inline size_t net_buf_frags_len(struct net_buf* buf) {
+    size_t bytes = 0;
+    for (; buf != NULL; buf = buf->frags) {
+        bytes += buf->len;
+    }
+    return bytes;
+}
+
+#endif // _FAVONIUS_HOST_NET_BUF_H_
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_HOST_SPINLOCK_H_
+#define _FAVONIUS_HOST_SPINLOCK_H_
+
+// Host stand-in for Zephyr's spinlock.h. There are no interrupts to mask, so the lock only spins, and a holder can be
+// preempted by the host scheduler; the spinning threads then yield to it, which Zephyr never needs to do.
+
+#include <sched.h>
+
+#include <sys/atomic.h>
+#include <sys/util.h>
+
+struct k_spinlock {
+    atomic_t locked;
+};
+
+typedef struct {
+    int key;
+} k_spinlock_key_t;
+
+static inline k_spinlock_key_t k_spin_lock(struct k_spinlock* l) {
+    while (!atomic_cas(&l->locked, 0, 1)) {
+        sched_yield();
+    }
+    return k_spinlock_key_t{0};
+}
+
+static inline void k_spin_unlock(struct k_spinlock* l, k_spinlock_key_t key) {
+    ARG_UNUSED(key);
+    atomic_clear(&l->locked);
+}
+
+#endif // _FAVONIUS_HOST_SPINLOCK_H_
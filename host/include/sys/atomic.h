@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_HOST_SYS_ATOMIC_H_
+#define _FAVONIUS_HOST_SYS_ATOMIC_H_
+
+// Host stand-in for Zephyr's sys/atomic.h, over the GCC __atomic builtins.
+// As in Zephyr, every operation is sequentially consistent and returns the previous value.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef long atomic_t;
+typedef atomic_t atomic_val_t;
+typedef void* atomic_ptr_t;
+
+#define ATOMIC_INIT(i) (i)
+#define ATOMIC_BITS (sizeof(atomic_val_t) * 8)
+
+static inline bool atomic_cas(atomic_t* target, atomic_val_t old_value, atomic_val_t new_value) {
+    return __atomic_compare_exchange_n(target, &old_value, new_value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline bool atomic_ptr_cas(atomic_ptr_t* target, void* old_value, void* new_value) {
+    return __atomic_compare_exchange_n(target, &old_value, new_value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_get(const atomic_t* target) { return __atomic_load_n(target, __ATOMIC_SEQ_CST); }
+static inline void* atomic_ptr_get(const atomic_ptr_t* target) { return __atomic_load_n(target, __ATOMIC_SEQ_CST); }
+static inline atomic_val_t atomic_set(atomic_t* target, atomic_val_t value) { return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST); }
+static inline void* atomic_ptr_set(atomic_ptr_t* target, void* value) { return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST); }
+static inline atomic_val_t atomic_clear(atomic_t* target) { return atomic_set(target, 0); }
+static inline atomic_val_t atomic_add(atomic_t* target, atomic_val_t value) { return __atomic_fetch_add(target, value, __ATOMIC_SEQ_CST); }
+static inline atomic_val_t atomic_sub(atomic_t* target, atomic_val_t value) { return __atomic_fetch_sub(target, value, __ATOMIC_SEQ_CST); }
+static inline atomic_val_t atomic_inc(atomic_t* target) { return atomic_add(target, 1); }
+static inline atomic_val_t atomic_dec(atomic_t* target) { return atomic_sub(target, 1); }
+static inline atomic_val_t atomic_or(atomic_t* target, atomic_val_t value) { return __atomic_fetch_or(target, value, __ATOMIC_SEQ_CST); }
+static inline atomic_val_t atomic_and(atomic_t* target, atomic_val_t value) { return __atomic_fetch_and(target, value, __ATOMIC_SEQ_CST); }
+static inline atomic_val_t atomic_xor(atomic_t* target, atomic_val_t value) { return __atomic_fetch_xor(target, value, __ATOMIC_SEQ_CST); }
+static inline atomic_val_t atomic_nand(atomic_t* target, atomic_val_t value) { return __atomic_fetch_nand(target, value, __ATOMIC_SEQ_CST); }
+
+static inline bool atomic_test_bit(const atomic_t* target, int bit) {
+    return (atomic_get(&target[bit / ATOMIC_BITS]) & (1L << (bit % ATOMIC_BITS))) != 0;
+}
+static inline bool atomic_test_and_set_bit(atomic_t* target, int bit) {
+    const atomic_val_t mask = 1L << (bit % ATOMIC_BITS);
+    return (atomic_or(&target[bit / ATOMIC_BITS], mask) & mask) != 0;
+}
+static inline bool atomic_test_and_clear_bit(atomic_t* target, int bit) {
+    const atomic_val_t mask = 1L << (bit % ATOMIC_BITS);
+    return (atomic_and(&target[bit / ATOMIC_BITS], ~mask) & mask) != 0;
+}
+static inline void atomic_set_bit(atomic_t* target, int bit) { (void)atomic_test_and_set_bit(target, bit); }
+static inline void atomic_clear_bit(atomic_t* target, int bit) { (void)atomic_test_and_clear_bit(target, bit); }
+
+#endif // _FAVONIUS_HOST_SYS_ATOMIC_H_
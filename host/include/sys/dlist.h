@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_HOST_SYS_DLIST_H_
+#define _FAVONIUS_HOST_SYS_DLIST_H_
+
+// Host stand-in for Zephyr's sys/dlist.h: the same circular, doubly-linked list with a sentinel head.
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct _dnode {
+    union {
+        struct _dnode* head; // For the list itself.
+        struct _dnode* next; // For nodes.
+    };
+    union {
+        struct _dnode* tail;
+        struct _dnode* prev;
+    };
+};
+
+typedef struct _dnode sys_dlist_t;
+typedef struct _dnode sys_dnode_t;
+
+#define SYS_DLIST_STATIC_INIT(ptr_to_list) { {(ptr_to_list)}, {(ptr_to_list)} }
+
+#define SYS_DLIST_FOR_EACH_NODE(list, node) \
+    for (node = sys_dlist_peek_head(list); node != NULL; node = sys_dlist_peek_next(list, node))
+
+#define SYS_DLIST_FOR_EACH_NODE_SAFE(list, node, safe_node)                                           \
+    for (node = sys_dlist_peek_head(list), safe_node = sys_dlist_peek_next(list, node); node != NULL; \
+         node = safe_node, safe_node = sys_dlist_peek_next(list, node))
+
+static inline void sys_dlist_init(sys_dlist_t* list) {
+    list->head = list;
+    list->tail = list;
+}
+
+static inline void sys_dnode_init(sys_dnode_t* node) {
+    node->next = NULL;
+    node->prev = NULL;
+}
+
+static inline bool sys_dnode_is_linked(const sys_dnode_t* node) { return node->next != NULL; }
+static inline bool sys_dlist_is_head(sys_dlist_t* list, sys_dnode_t* node) { return list->head == node; }
+static inline bool sys_dlist_is_tail(sys_dlist_t* list, sys_dnode_t* node) { return list->tail == node; }
+static inline bool sys_dlist_is_empty(sys_dlist_t* list) { return list->head == list; }
+static inline bool sys_dlist_has_multiple_nodes(sys_dlist_t* list) { return list->head != list->tail; }
+
+static inline sys_dnode_t* sys_dlist_peek_head(sys_dlist_t* list) { return sys_dlist_is_empty(list) ? NULL : list->head; }
+static inline sys_dnode_t* sys_dlist_peek_head_not_empty(sys_dlist_t* list) { return list->head; }
+static inline sys_dnode_t* sys_dlist_peek_tail(sys_dlist_t* list) { return sys_dlist_is_empty(list) ? NULL : list->tail; }
+
+static inline sys_dnode_t* sys_dlist_peek_next_no_check(sys_dlist_t* list, sys_dnode_t* node) {
+    return (node == list->tail) ? NULL : node->next;
+}
+static inline sys_dnode_t* sys_dlist_peek_next(sys_dlist_t* list, sys_dnode_t* node) {
+    return (node != NULL) ? sys_dlist_peek_next_no_check(list, node) : NULL;
+}
+static inline sys_dnode_t* sys_dlist_peek_prev_no_check(sys_dlist_t* list, sys_dnode_t* node) {
+    return (node == list->head) ? NULL : node->prev;
+}
+static inline sys_dnode_t* sys_dlist_peek_prev(sys_dlist_t* list, sys_dnode_t* node) {
+    return (node != NULL) ? sys_dlist_peek_prev_no_check(list, node) : NULL;
+}
+
+static inline void sys_dlist_append(sys_dlist_t* list, sys_dnode_t* node) {
+    sys_dnode_t* const tail = list->tail;
+    node->next = list;
+    node->prev = tail;
+    tail->next = node;
+    list->tail = node;
+}
+
+static inline void sys_dlist_prepend(sys_dlist_t* list, sys_dnode_t* node) {
+    sys_dnode_t* const head = list->head;
+    node->next = head;
+    node->prev = list;
+    head->prev = node;
+    list->head = node;
+}
+
+static inline void sys_dlist_insert(sys_dnode_t* successor, sys_dnode_t* node) {
+    sys_dnode_t* const prev = successor->prev;
+    node->prev = prev;
+    node->next = successor;
+    prev->next = node;
+    successor->prev = node;
+}
+
+static inline void sys_dlist_remove(sys_dnode_t* node) {
+    sys_dnode_t* const prev = node->prev;
+    sys_dnode_t* const next = node->next;
+    prev->next = next;
+    next->prev = prev;
+    sys_dnode_init(node);
+}
+
+static inline sys_dnode_t* sys_dlist_get(sys_dlist_t* list) {
+    sys_dnode_t* node = NULL;
+    if (!sys_dlist_is_empty(list)) {
+        node = list->head;
+        sys_dlist_remove(node);
+    }
+    return node;
+}
+
+#endif // _FAVONIUS_HOST_SYS_DLIST_H_
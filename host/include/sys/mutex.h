@@ -0,0 +1,11 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_HOST_SYS_MUTEX_H_
+#define _FAVONIUS_HOST_SYS_MUTEX_H_
+
+// Zephyr's sys/mutex.h pulls in the kernel API. There is no user mode on the host, so nothing else is needed.
+
+#include <kernel.h>
+
+#endif // _FAVONIUS_HOST_SYS_MUTEX_H_
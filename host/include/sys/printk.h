@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_HOST_SYS_PRINTK_H_
+#define _FAVONIUS_HOST_SYS_PRINTK_H_
+
+// Host stand-in for Zephyr's sys/printk.h. Prints to stdout.
+
+#include <stdarg.h>
+#include <stddef.h>
+
+__attribute__((format(printf, 1, 2))) int printk(const char* fmt, ...);
+int vprintk(const char* fmt, va_list args);
+// Like snprintf: return the length the output would have had without truncation.
+__attribute__((format(printf, 3, 4))) int snprintk(char* str, size_t size, const char* fmt, ...);
+int vsnprintk(char* str, size_t size, const char* fmt, va_list args);
+
+#endif // _FAVONIUS_HOST_SYS_PRINTK_H_
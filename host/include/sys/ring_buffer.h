@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_HOST_SYS_RING_BUFFER_H_
+#define _FAVONIUS_HOST_SYS_RING_BUFFER_H_
+
+// Host stand-in for the byte mode of Zephyr's sys/ring_buffer.h, including the claim/finish API.
+// Like the original, it is not thread safe; a single producer and a single consumer need external synchronization.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct ring_buf {
+    uint8_t* buffer;
+    uint32_t size;
+    // Free-running byte positions. Data is committed in [get_tail, put_tail),
+    // and claims extend the write end to put_head and the read end to get_head.
+    uint64_t put_head;
+    uint64_t put_tail;
+    uint64_t get_head;
+    uint64_t get_tail;
+};
+
+#define RING_BUF_DECLARE(name, size8)                     \
+    static uint8_t _ring_buffer_data_##name[(size8)];     \
+    struct ring_buf name = {_ring_buffer_data_##name, (size8), 0, 0, 0, 0}
+
+void ring_buf_init(struct ring_buf* buf, uint32_t size, void* data);
+void ring_buf_reset(struct ring_buf* buf);
+
+static inline bool ring_buf_is_empty(struct ring_buf* buf) { return buf->put_tail == buf->get_tail; }
+static inline uint32_t ring_buf_capacity_get(struct ring_buf* buf) { return buf->size; }
+static inline uint32_t ring_buf_size_get(struct ring_buf* buf) { return (uint32_t)(buf->put_tail - buf->get_tail); }
+static inline uint32_t ring_buf_space_get(struct ring_buf* buf) { return buf->size - (uint32_t)(buf->put_head - buf->get_tail); }
+
+uint32_t ring_buf_put_claim(struct ring_buf* buf, uint8_t** data, uint32_t size);
+int ring_buf_put_finish(struct ring_buf* buf, uint32_t size);
+uint32_t ring_buf_put(struct ring_buf* buf, const uint8_t* data, uint32_t size);
+
+uint32_t ring_buf_get_claim(struct ring_buf* buf, uint8_t** data, uint32_t size);
+int ring_buf_get_finish(struct ring_buf* buf, uint32_t size);
+// data may be NULL to discard.
+uint32_t ring_buf_get(struct ring_buf* buf, uint8_t* data, uint32_t size);
+uint32_t ring_buf_peek(struct ring_buf* buf, uint8_t* data, uint32_t size);
+
+#endif // _FAVONIUS_HOST_SYS_RING_BUFFER_H_
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_HOST_SYS_SLIST_H_
+#define _FAVONIUS_HOST_SYS_SLIST_H_
+
+// Host stand-in for Zephyr's sys/slist.h.
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct _snode {
+    struct _snode* next;
+};
+
+struct _slist {
+    struct _snode* head;
+    struct _snode* tail;
+};
+
+typedef struct _snode sys_snode_t;
+typedef struct _slist sys_slist_t;
+
+#define SYS_SLIST_STATIC_INIT(ptr_to_list) { NULL, NULL }
+
+#define SYS_SLIST_FOR_EACH_NODE(list, node) for (node = (list)->head; node != NULL; node = node->next)
+
+#define SYS_SLIST_FOR_EACH_NODE_SAFE(list, node, safe_node)                                   \
+    for (node = (list)->head, safe_node = (node != NULL) ? node->next : NULL; node != NULL; \
+         node = safe_node, safe_node = (node != NULL) ? node->next : NULL)
+
+static inline void sys_slist_init(sys_slist_t* list) {
+    list->head = NULL;
+    list->tail = NULL;
+}
+
+static inline bool sys_slist_is_empty(sys_slist_t* list) { return list->head == NULL; }
+static inline sys_snode_t* sys_slist_peek_head(sys_slist_t* list) { return list->head; }
+static inline sys_snode_t* sys_slist_peek_tail(sys_slist_t* list) { return list->tail; }
+static inline sys_snode_t* sys_slist_peek_next(sys_snode_t* node) { return (node != NULL) ? node->next : NULL; }
+
+static inline void sys_slist_prepend(sys_slist_t* list, sys_snode_t* node) {
+    node->next = list->head;
+    list->head = node;
+    if (list->tail == NULL) {
+        list->tail = node;
+    }
+}
+
+static inline void sys_slist_append(sys_slist_t* list, sys_snode_t* node) {
+    node->next = NULL;
+    if (list->tail == NULL) {
+        list->head = node;
+    } else {
+        list->tail->next = node;
+    }
+    list->tail = node;
+}
+
+static inline sys_snode_t* sys_slist_get(sys_slist_t* list) {
+    sys_snode_t* node = list->head;
+    if (node != NULL) {
+        list->head = node->next;
+        if (list->tail == node) {
+            list->tail = NULL;
+        }
+        node->next = NULL;
+    }
+    return node;
+}
+
+static inline void sys_slist_remove(sys_slist_t* list, sys_snode_t* prev_node, sys_snode_t* node) {
+    if (prev_node == NULL) {
+        list->head = node->next;
+        if (list->tail == node) {
+            list->tail = list->head;
+        }
+    } else {
+        prev_node->next = node->next;
+        if (list->tail == node) {
+            list->tail = prev_node;
+        }
+    }
+    node->next = NULL;
+}
+
+static inline bool sys_slist_find_and_remove(sys_slist_t* list, sys_snode_t* node) {
+    sys_snode_t* prev = NULL;
+    for (sys_snode_t* test = list->head; test != NULL; prev = test, test = test->next) {
+        if (test == node) {
+            sys_slist_remove(list, prev, node);
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif // _FAVONIUS_HOST_SYS_SLIST_H_
@@ -0,0 +1,11 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_HOST_SYS_TIMEUTIL_H_
+#define _FAVONIUS_HOST_SYS_TIMEUTIL_H_
+
+// Nothing from Zephyr's sys/timeutil.h is used by favonius yet.
+
+#include <kernel.h>
+
+#endif // _FAVONIUS_HOST_SYS_TIMEUTIL_H_
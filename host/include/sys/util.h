@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_HOST_SYS_UTIL_H_
+#define _FAVONIUS_HOST_SYS_UTIL_H_
+
+// Host stand-in for the subset of Zephyr's sys/util.h used by favonius.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CONTAINER_OF(ptr, type, field) ((type*)(((char*)(ptr)) - offsetof(type, field)))
+#define ARG_UNUSED(x) (void)(x)
+#define ARRAY_SIZE(array) (sizeof(array) / sizeof((array)[0]))
+#define BIT(n) (1UL << (n))
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#define ROUND_UP(x, align) ((((unsigned long)(x) + ((unsigned long)(align) - 1)) / (unsigned long)(align)) * (unsigned long)(align))
+
+static inline bool is_power_of_two(unsigned int x) { return (x != 0U) && ((x & (x - 1U)) == 0U); }
+
+#endif // _FAVONIUS_HOST_SYS_UTIL_H_
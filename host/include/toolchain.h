@@ -0,0 +1,14 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_HOST_TOOLCHAIN_H_
+#define _FAVONIUS_HOST_TOOLCHAIN_H_
+
+// Host stand-in for Zephyr's toolchain attribute macros.
+
+#define __packed __attribute__((__packed__))
+#define __aligned(x) __attribute__((__aligned__(x)))
+#define __weak __attribute__((__weak__))
+#define __unused __attribute__((__unused__))
+
+#endif // _FAVONIUS_HOST_TOOLCHAIN_H_
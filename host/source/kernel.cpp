@@ -0,0 +1,481 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include <irq_offload.h>
+#include <kernel.h>
+
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+// k_thread::state
+constexpr atomic_val_t ThreadUnused = 0;  // Never created, or a foreign thread (e.g. main).
+constexpr atomic_val_t ThreadPending = 1; // Created with K_FOREVER, waiting for k_thread_start().
+constexpr atomic_val_t ThreadRunning = 2;
+constexpr atomic_val_t ThreadDead = 3;
+
+int64_t MonotonicNs() noexcept {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+}
+
+// Uptime counts from the first use of the kernel, which is during static initialization in practice.
+const int64_t boot_ns = MonotonicNs();
+
+int64_t UptimeNs() noexcept {
+    return MonotonicNs() - boot_ns;
+}
+
+// Absolute CLOCK_MONOTONIC time at which a finite timeout expires.
+struct timespec Deadline(k_timeout_t timeout) noexcept {
+    int64_t ns;
+    if (timeout.ticks <= Z_TICK_ABS(0)) {
+        ns = boot_ns + static_cast<int64_t>(k_ticks_to_ns_floor64(static_cast<uint64_t>(Z_TICK_ABS(timeout.ticks))));
+    } else {
+        ns = MonotonicNs() + static_cast<int64_t>(k_ticks_to_ns_floor64(static_cast<uint64_t>(timeout.ticks)));
+    }
+    struct timespec deadline;
+    deadline.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+    deadline.tv_nsec = static_cast<long>(ns % 1000000000LL);
+    return deadline;
+}
+
+void InitCond(pthread_cond_t* cond) noexcept {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+// Waits on cond until woken or the timeout expires. K_NO_WAIT must be handled by the caller.
+// Returns false on timeout.
+bool Wait(pthread_cond_t* cond, pthread_mutex_t* guard, k_timeout_t timeout) noexcept {
+    if (K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+        pthread_cond_wait(cond, guard);
+        return true;
+    }
+    const struct timespec deadline = Deadline(timeout);
+    return pthread_cond_timedwait(cond, guard, &deadline) != ETIMEDOUT;
+}
+
+// The k_thread of threads which were not created with k_thread_create(), such as main().
+thread_local struct k_thread foreign_thread = {};
+thread_local struct k_thread* current_thread = nullptr;
+
+// Set while irq_offload() runs its routine.
+thread_local bool in_isr = false;
+
+void* ThreadTrampoline(void* arg) {
+    struct k_thread* thread = static_cast<struct k_thread*>(arg);
+    current_thread = thread;
+    if (!K_TIMEOUT_EQ(thread->delay, K_NO_WAIT)) {
+        [[maybe_unused]] int32_t remaining = k_sleep(thread->delay);
+    }
+    thread->entry(thread->p1, thread->p2, thread->p3);
+    atomic_set(&thread->state, ThreadDead);
+    return nullptr;
+}
+
+void StartThread(struct k_thread* thread) noexcept {
+    atomic_set(&thread->state, ThreadRunning);
+    if (pthread_create(&thread->handle, nullptr, ThreadTrampoline, thread) != 0) {
+        printk("k_thread_create: pthread_create failed\n");
+        abort();
+    }
+}
+
+} // namespace
+
+int printk(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    const int written = vprintk(fmt, args);
+    va_end(args);
+    return written;
+}
+
+int vprintk(const char* fmt, va_list args) {
+    const int written = vprintf(fmt, args);
+    fflush(stdout);
+    return written;
+}
+
+int snprintk(char* str, size_t size, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    const int written = vsnprintk(str, size, fmt, args);
+    va_end(args);
+    return written;
+}
+
+int vsnprintk(char* str, size_t size, const char* fmt, va_list args) {
+    return vsnprintf(str, size, fmt, args);
+}
+
+int64_t k_uptime_ticks(void) {
+    return static_cast<int64_t>(static_cast<uint64_t>(UptimeNs()) * CONFIG_SYS_CLOCK_TICKS_PER_SEC / 1000000000ULL);
+}
+
+uint64_t k_cycle_get_64(void) {
+    return static_cast<uint64_t>(MonotonicNs());
+}
+
+// Interrupts
+
+bool k_is_in_isr(void) {
+    return in_isr;
+}
+
+void irq_offload(irq_offload_routine_t routine, const void* parameter) {
+    const bool was_in_isr = in_isr;
+    in_isr = true;
+    routine(parameter);
+    in_isr = was_in_isr;
+}
+
+// Threads
+
+k_tid_t k_thread_create(struct k_thread* new_thread, k_thread_stack_t* stack, size_t stack_size, k_thread_entry_t entry,
+                        void* p1, void* p2, void* p3, int prio, uint32_t options, k_timeout_t delay) {
+    ARG_UNUSED(stack);
+    ARG_UNUSED(stack_size);
+    ARG_UNUSED(options);
+    new_thread->entry = entry;
+    new_thread->p1 = p1;
+    new_thread->p2 = p2;
+    new_thread->p3 = p3;
+    new_thread->delay = delay;
+    new_thread->priority = prio;
+    new_thread->deadline = 0;
+    new_thread->custom_data = nullptr;
+    new_thread->name[0] = '\0';
+    if (K_TIMEOUT_EQ(delay, K_FOREVER)) {
+        atomic_set(&new_thread->state, ThreadPending);
+    } else {
+        StartThread(new_thread);
+    }
+    return new_thread;
+}
+
+void k_thread_start(k_tid_t thread) {
+    if (atomic_cas(&thread->state, ThreadPending, ThreadRunning)) {
+        thread->delay = K_NO_WAIT;
+        StartThread(thread);
+    }
+}
+
+int k_thread_join(struct k_thread* thread, k_timeout_t timeout) {
+    if (thread == k_current_get()) {
+        return -EDEADLK;
+    }
+    const atomic_val_t state = atomic_get(&thread->state);
+    if (state == ThreadUnused) {
+        return 0;
+    }
+    if (state == ThreadPending) {
+        return K_TIMEOUT_EQ(timeout, K_NO_WAIT) ? -EBUSY : -EAGAIN;
+    }
+    int ec;
+    if (K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+        ec = pthread_join(thread->handle, nullptr);
+    } else if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+        ec = pthread_tryjoin_np(thread->handle, nullptr);
+        if (ec == EBUSY) {
+            return -EBUSY;
+        }
+    } else {
+        // pthread_timedjoin_np() measures against CLOCK_REALTIME.
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        const uint64_t ns = k_ticks_to_ns_floor64(static_cast<uint64_t>(timeout.ticks)) + static_cast<uint64_t>(deadline.tv_nsec);
+        deadline.tv_sec += static_cast<time_t>(ns / 1000000000ULL);
+        deadline.tv_nsec = static_cast<long>(ns % 1000000000ULL);
+        ec = pthread_timedjoin_np(thread->handle, nullptr, &deadline);
+        if (ec == ETIMEDOUT) {
+            return -EAGAIN;
+        }
+    }
+    if (ec == 0) {
+        atomic_set(&thread->state, ThreadUnused);
+    }
+    return -ec;
+}
+
+k_tid_t k_current_get(void) {
+    if (current_thread == nullptr) {
+        foreign_thread.handle = pthread_self();
+        current_thread = &foreign_thread;
+    }
+    return current_thread;
+}
+
+const char* k_thread_name_get(k_tid_t thread) {
+    return thread->name;
+}
+
+int k_thread_name_set(k_tid_t thread, const char* str) {
+    thread = (thread != nullptr) ? thread : k_current_get();
+    strncpy(thread->name, str, sizeof(thread->name) - 1);
+    thread->name[sizeof(thread->name) - 1] = '\0';
+    return 0;
+}
+
+const char* k_thread_state_str(k_tid_t thread) {
+    switch (atomic_get(&thread->state)) {
+    case ThreadPending: return "prestart";
+    case ThreadRunning: return "running";
+    case ThreadDead: return "dead";
+    default: return "unknown";
+    }
+}
+
+void k_yield(void) {
+    sched_yield();
+}
+
+int32_t k_sleep(k_timeout_t timeout) {
+    __ASSERT(!k_is_in_isr(), "k_sleep() called from an ISR");
+    if (K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+        while (true) {
+            pause();
+        }
+    }
+    const struct timespec deadline = Deadline(timeout);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {}
+    return 0;
+}
+
+void k_busy_wait(uint32_t usec_to_wait) {
+    const int64_t end = MonotonicNs() + static_cast<int64_t>(usec_to_wait) * 1000;
+    while (MonotonicNs() < end) {}
+}
+
+// Mutex. Recursive, like k_mutex, but without priority inheritance.
+
+int k_mutex_init(struct k_mutex* mutex) {
+    pthread_mutex_init(&mutex->guard, nullptr);
+    InitCond(&mutex->unlocked);
+    mutex->owner = nullptr;
+    mutex->lock_count = 0;
+    return 0;
+}
+
+int k_mutex_lock(struct k_mutex* mutex, k_timeout_t timeout) {
+    __ASSERT(!k_is_in_isr(), "mutexes cannot be used inside ISRs");
+    struct k_thread* const self = k_current_get();
+    int ec = 0;
+    pthread_mutex_lock(&mutex->guard);
+    if (mutex->owner == self) {
+        mutex->lock_count++;
+    } else {
+        while (mutex->owner != nullptr) {
+            if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+                ec = -EBUSY;
+                break;
+            }
+            if (!Wait(&mutex->unlocked, &mutex->guard, timeout) && mutex->owner != nullptr) {
+                ec = -EAGAIN;
+                break;
+            }
+        }
+        if (ec == 0) {
+            mutex->owner = self;
+            mutex->lock_count = 1;
+        }
+    }
+    pthread_mutex_unlock(&mutex->guard);
+    return ec;
+}
+
+int k_mutex_unlock(struct k_mutex* mutex) {
+    __ASSERT(!k_is_in_isr(), "mutexes cannot be used inside ISRs");
+    int ec = 0;
+    pthread_mutex_lock(&mutex->guard);
+    if (mutex->lock_count == 0) {
+        ec = -EINVAL;
+    } else if (mutex->owner != k_current_get()) {
+        ec = -EPERM;
+    } else if (--mutex->lock_count == 0) {
+        mutex->owner = nullptr;
+        pthread_cond_signal(&mutex->unlocked);
+    }
+    pthread_mutex_unlock(&mutex->guard);
+    return ec;
+}
+
+// Condition variable. Waiters sleep on the guard of the mutex they passed to k_condvar_wait(), so that a thread
+// which signals after changing state under that mutex cannot slip in between the unlock and the wait.
+
+int k_condvar_init(struct k_condvar* condvar) {
+    InitCond(&condvar->cond);
+    condvar->mutex = nullptr;
+    return 0;
+}
+
+int k_condvar_signal(struct k_condvar* condvar) {
+    struct k_mutex* const mutex = __atomic_load_n(&condvar->mutex, __ATOMIC_ACQUIRE);
+    if (mutex != nullptr) {
+        pthread_mutex_lock(&mutex->guard);
+        pthread_cond_signal(&condvar->cond);
+        pthread_mutex_unlock(&mutex->guard);
+    }
+    return 0;
+}
+
+int k_condvar_broadcast(struct k_condvar* condvar) {
+    struct k_mutex* const mutex = __atomic_load_n(&condvar->mutex, __ATOMIC_ACQUIRE);
+    if (mutex != nullptr) {
+        pthread_mutex_lock(&mutex->guard);
+        pthread_cond_broadcast(&condvar->cond);
+        pthread_mutex_unlock(&mutex->guard);
+    }
+    return 0;
+}
+
+int k_condvar_wait(struct k_condvar* condvar, struct k_mutex* mutex, k_timeout_t timeout) {
+    struct k_thread* const self = k_current_get();
+    __atomic_store_n(&condvar->mutex, mutex, __ATOMIC_RELEASE);
+
+    pthread_mutex_lock(&mutex->guard);
+    if (mutex->owner != self || mutex->lock_count == 0) {
+        pthread_mutex_unlock(&mutex->guard);
+        return -EPERM;
+    }
+    // Release one level of ownership, as k_mutex_unlock() would.
+    if (--mutex->lock_count == 0) {
+        mutex->owner = nullptr;
+        pthread_cond_signal(&mutex->unlocked);
+    }
+
+    const bool woken = !K_TIMEOUT_EQ(timeout, K_NO_WAIT) && Wait(&condvar->cond, &mutex->guard, timeout);
+
+    while (mutex->owner != nullptr && mutex->owner != self) {
+        pthread_cond_wait(&mutex->unlocked, &mutex->guard);
+    }
+    mutex->owner = self;
+    mutex->lock_count++;
+    pthread_mutex_unlock(&mutex->guard);
+    return woken ? 0 : -EAGAIN;
+}
+
+// Semaphore
+
+int k_sem_init(struct k_sem* sem, unsigned int initial_count, unsigned int limit) {
+    if (limit == 0 || initial_count > limit) {
+        return -EINVAL;
+    }
+    pthread_mutex_init(&sem->guard, nullptr);
+    InitCond(&sem->available);
+    sem->count = initial_count;
+    sem->limit = limit;
+    return 0;
+}
+
+void k_sem_give(struct k_sem* sem) {
+    pthread_mutex_lock(&sem->guard);
+    if (sem->count < sem->limit) {
+        sem->count++;
+    }
+    pthread_cond_signal(&sem->available);
+    pthread_mutex_unlock(&sem->guard);
+}
+
+int k_sem_take(struct k_sem* sem, k_timeout_t timeout) {
+    __ASSERT(!k_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "k_sem_take() may only wait outside of ISRs");
+    int ec = 0;
+    pthread_mutex_lock(&sem->guard);
+    while (sem->count == 0) {
+        if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+            ec = -EBUSY;
+            break;
+        }
+        if (!Wait(&sem->available, &sem->guard, timeout) && sem->count == 0) {
+            ec = -EAGAIN;
+            break;
+        }
+    }
+    if (ec == 0) {
+        sem->count--;
+    }
+    pthread_mutex_unlock(&sem->guard);
+    return ec;
+}
+
+void k_sem_reset(struct k_sem* sem) {
+    pthread_mutex_lock(&sem->guard);
+    sem->count = 0;
+    pthread_mutex_unlock(&sem->guard);
+}
+
+unsigned int k_sem_count_get(struct k_sem* sem) {
+    pthread_mutex_lock(&sem->guard);
+    const unsigned int count = sem->count;
+    pthread_mutex_unlock(&sem->guard);
+    return count;
+}
+
+// Heap
+
+namespace {
+
+// Precedes every k_heap block, keeping the payload aligned like malloc() does.
+struct alignas(max_align_t) HeapBlockHeader {
+    size_t bytes;
+    void* base; // What malloc() returned, which is before the header for over-aligned blocks.
+};
+
+} // namespace
+
+void k_heap_init(struct k_heap* heap, void* mem, size_t bytes) {
+    heap->heap.init_mem = mem;
+    heap->heap.init_bytes = bytes;
+    pthread_mutex_init(&heap->guard, nullptr);
+    heap->used = 0;
+}
+
+void* k_heap_alloc(struct k_heap* heap, size_t bytes, k_timeout_t timeout) {
+    return k_heap_aligned_alloc(heap, alignof(HeapBlockHeader), bytes, timeout);
+}
+
+void* k_heap_aligned_alloc(struct k_heap* heap, size_t align, size_t bytes, k_timeout_t timeout) {
+    ARG_UNUSED(timeout);
+    align = MAX(align, alignof(HeapBlockHeader));
+    pthread_mutex_lock(&heap->guard);
+    const bool fits = bytes <= heap->heap.init_bytes - heap->used;
+    if (fits) {
+        heap->used += bytes;
+    }
+    pthread_mutex_unlock(&heap->guard);
+    if (!fits) {
+        return nullptr;
+    }
+    void* base = malloc(sizeof(HeapBlockHeader) + align - alignof(HeapBlockHeader) + bytes);
+    if (base == nullptr) {
+        pthread_mutex_lock(&heap->guard);
+        heap->used -= bytes;
+        pthread_mutex_unlock(&heap->guard);
+        return nullptr;
+    }
+    const uintptr_t payload = ROUND_UP(reinterpret_cast<uintptr_t>(base) + sizeof(HeapBlockHeader), align);
+    HeapBlockHeader* header = reinterpret_cast<HeapBlockHeader*>(payload) - 1;
+    header->bytes = bytes;
+    header->base = base;
+    return header + 1;
+}
+
+void k_heap_free(struct k_heap* heap, void* mem) {
+    if (mem == nullptr) {
+        return;
+    }
+    HeapBlockHeader* header = static_cast<HeapBlockHeader*>(mem) - 1;
+    pthread_mutex_lock(&heap->guard);
+    heap->used -= header->bytes;
+    pthread_mutex_unlock(&heap->guard);
+    free(header->base);
+}
@@ -0,0 +1,218 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include <net/buf.h>
+
+#include <string.h>
+
+namespace {
+
+struct net_buf* TakeBuffer(struct net_buf_pool* pool) noexcept {
+    struct net_buf* buf = nullptr;
+    pthread_mutex_lock(&pool->guard);
+    if (pool->free != nullptr) {
+        buf = pool->free;
+        pool->free = buf->frags;
+    } else if (pool->uninit_count > 0) {
+        const uint16_t index = pool->buf_count - pool->uninit_count--;
+        buf = &pool->bufs[index];
+        buf->pool = pool;
+        buf->__buf = pool->data + static_cast<size_t>(index) * pool->data_size;
+        buf->size = pool->data_size;
+    }
+    if (buf != nullptr) {
+        --pool->avail_count;
+    }
+    pthread_mutex_unlock(&pool->guard);
+    return buf;
+}
+
+void PutLe(uint8_t* dst, uint32_t val, size_t bytes) noexcept {
+    for (size_t i = 0; i < bytes; ++i) {
+        dst[i] = static_cast<uint8_t>(val >> (8 * i));
+    }
+}
+
+void PutBe(uint8_t* dst, uint32_t val, size_t bytes) noexcept {
+    for (size_t i = 0; i < bytes; ++i) {
+        dst[bytes - 1 - i] = static_cast<uint8_t>(val >> (8 * i));
+    }
+}
+
+uint32_t GetLe(const uint8_t* src, size_t bytes) noexcept {
+    uint32_t val = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        val |= static_cast<uint32_t>(src[i]) << (8 * i);
+    }
+    return val;
+}
+
+uint32_t GetBe(const uint8_t* src, size_t bytes) noexcept {
+    uint32_t val = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        val = (val << 8) | src[i];
+    }
+    return val;
+}
+
+} // namespace
+
+struct net_buf* net_buf_alloc_fixed(struct net_buf_pool* pool, k_timeout_t timeout) {
+    const bool forever = K_TIMEOUT_EQ(timeout, K_FOREVER);
+    const int64_t deadline = k_uptime_ticks() + timeout.ticks;
+    struct net_buf* buf = TakeBuffer(pool);
+    while (buf == nullptr) {
+        if (!forever && k_uptime_ticks() >= deadline) {
+            return nullptr;
+        }
+        [[maybe_unused]] int32_t remaining = k_usleep(100);
+        buf = TakeBuffer(pool);
+    }
+    buf->ref = 1;
+    buf->flags = 0;
+    buf->frags = nullptr;
+    net_buf_reset(buf);
+    return buf;
+}
+
+struct net_buf* net_buf_ref(struct net_buf* buf) {
+    pthread_mutex_lock(&buf->pool->guard);
+    ++buf->ref;
+    pthread_mutex_unlock(&buf->pool->guard);
+    return buf;
+}
+
+void net_buf_destroy(struct net_buf* buf) {
+    struct net_buf_pool* pool = buf->pool;
+    pthread_mutex_lock(&pool->guard);
+    buf->frags = pool->free;
+    pool->free = buf;
+    ++pool->avail_count;
+    pthread_mutex_unlock(&pool->guard);
+}
+
+void net_buf_unref(struct net_buf* buf) {
+    while (buf != nullptr) {
+        struct net_buf* frags = buf->frags;
+        struct net_buf_pool* pool = buf->pool;
+        pthread_mutex_lock(&pool->guard);
+        const uint8_t ref = --buf->ref;
+        pthread_mutex_unlock(&pool->guard);
+        if (ref > 0) {
+            return;
+        }
+        buf->data = nullptr;
+        buf->frags = nullptr;
+        if (pool->destroy != nullptr) {
+            pool->destroy(buf);
+        } else {
+            net_buf_destroy(buf);
+        }
+        buf = frags;
+    }
+}
+
+void* net_buf_add(struct net_buf* buf, size_t len) {
+    uint8_t* tail = net_buf_tail(buf);
+    __ASSERT(net_buf_tailroom(buf) >= len, "net_buf_add: no tailroom");
+    buf->len += static_cast<uint16_t>(len);
+    return tail;
+}
+
+void* net_buf_add_mem(struct net_buf* buf, const void* mem, size_t len) {
+    return memcpy(net_buf_add(buf, len), mem, len);
+}
+
+uint8_t* net_buf_add_u8(struct net_buf* buf, uint8_t val) {
+    uint8_t* u8 = static_cast<uint8_t*>(net_buf_add(buf, 1));
+    *u8 = val;
+    return u8;
+}
+
+void net_buf_add_le16(struct net_buf* buf, uint16_t val) { PutLe(static_cast<uint8_t*>(net_buf_add(buf, 2)), val, 2); }
+void net_buf_add_be16(struct net_buf* buf, uint16_t val) { PutBe(static_cast<uint8_t*>(net_buf_add(buf, 2)), val, 2); }
+void net_buf_add_le32(struct net_buf* buf, uint32_t val) { PutLe(static_cast<uint8_t*>(net_buf_add(buf, 4)), val, 4); }
+void net_buf_add_be32(struct net_buf* buf, uint32_t val) { PutBe(static_cast<uint8_t*>(net_buf_add(buf, 4)), val, 4); }
+
+void* net_buf_remove_mem(struct net_buf* buf, size_t len) {
+    __ASSERT(buf->len >= len, "net_buf_remove_mem: not enough data");
+    buf->len -= static_cast<uint16_t>(len);
+    return buf->data + buf->len;
+}
+
+void* net_buf_push(struct net_buf* buf, size_t len) {
+    __ASSERT(net_buf_headroom(buf) >= len, "net_buf_push: no headroom");
+    buf->data -= len;
+    buf->len += static_cast<uint16_t>(len);
+    return buf->data;
+}
+
+void net_buf_push_u8(struct net_buf* buf, uint8_t val) { *static_cast<uint8_t*>(net_buf_push(buf, 1)) = val; }
+void net_buf_push_le16(struct net_buf* buf, uint16_t val) { PutLe(static_cast<uint8_t*>(net_buf_push(buf, 2)), val, 2); }
+void net_buf_push_be16(struct net_buf* buf, uint16_t val) { PutBe(static_cast<uint8_t*>(net_buf_push(buf, 2)), val, 2); }
+
+void* net_buf_pull(struct net_buf* buf, size_t len) {
+    __ASSERT(buf->len >= len, "net_buf_pull: not enough data");
+    buf->len -= static_cast<uint16_t>(len);
+    return buf->data += len;
+}
+
+void* net_buf_pull_mem(struct net_buf* buf, size_t len) {
+    uint8_t* data = buf->data;
+    net_buf_pull(buf, len);
+    return data;
+}
+
+uint8_t net_buf_pull_u8(struct net_buf* buf) { return *static_cast<uint8_t*>(net_buf_pull_mem(buf, 1)); }
+uint16_t net_buf_pull_le16(struct net_buf* buf) { return static_cast<uint16_t>(GetLe(static_cast<uint8_t*>(net_buf_pull_mem(buf, 2)), 2)); }
+uint16_t net_buf_pull_be16(struct net_buf* buf) { return static_cast<uint16_t>(GetBe(static_cast<uint8_t*>(net_buf_pull_mem(buf, 2)), 2)); }
+uint32_t net_buf_pull_le32(struct net_buf* buf) { return GetLe(static_cast<uint8_t*>(net_buf_pull_mem(buf, 4)), 4); }
+uint32_t net_buf_pull_be32(struct net_buf* buf) { return GetBe(static_cast<uint8_t*>(net_buf_pull_mem(buf, 4)), 4); }
+
+struct net_buf* net_buf_frag_last(struct net_buf* frags) {
+    while (frags->frags != nullptr) {
+        frags = frags->frags;
+    }
+    return frags;
+}
+
+void net_buf_frag_insert(struct net_buf* parent, struct net_buf* frag) {
+    if (parent->frags != nullptr) {
+        net_buf_frag_last(frag)->frags = parent->frags;
+    }
+    parent->frags = frag;
+}
+
+struct net_buf* net_buf_frag_add(struct net_buf* head, struct net_buf* frag) {
+    if (head == nullptr) {
+        return net_buf_ref(frag);
+    }
+    net_buf_frag_insert(net_buf_frag_last(head), frag);
+    return head;
+}
+
+struct net_buf* net_buf_frag_del(struct net_buf* parent, struct net_buf* frag) {
+    struct net_buf* next = frag->frags;
+    if (parent != nullptr) {
+        parent->frags = next;
+    }
+    frag->frags = nullptr;
+    net_buf_unref(frag);
+    return next;
+}
+
+size_t net_buf_linearize(void* dst, size_t dst_len, struct net_buf* src, size_t offset, size_t len) {
+    len = (len < dst_len) ? len : dst_len;
+    while (src != nullptr && offset >= src->len) {
+        offset -= src->len;
+        src = src->frags;
+    }
+    size_t copied = 0;
+    for (; src != nullptr && copied < len; src = src->frags, offset = 0) {
+        size_t chunk = src->len - offset;
+        chunk = (chunk < len - copied) ? chunk : len - copied;
+        memcpy(static_cast<uint8_t*>(dst) + copied, src->data + offset, chunk);
+        copied += chunk;
+    }
+    return copied;
+}
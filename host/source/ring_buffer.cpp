@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include <sys/ring_buffer.h>
+
+#include <errno.h>
+#include <string.h>
+
+void ring_buf_init(struct ring_buf* buf, uint32_t size, void* data) {
+    buf->buffer = static_cast<uint8_t*>(data);
+    buf->size = size;
+    ring_buf_reset(buf);
+}
+
+void ring_buf_reset(struct ring_buf* buf) {
+    buf->put_head = 0;
+    buf->put_tail = 0;
+    buf->get_head = 0;
+    buf->get_tail = 0;
+}
+
+uint32_t ring_buf_put_claim(struct ring_buf* buf, uint8_t** data, uint32_t size) {
+    const uint32_t offset = static_cast<uint32_t>(buf->put_head % buf->size);
+    const uint32_t space = buf->size - static_cast<uint32_t>(buf->put_head - buf->get_tail);
+    const uint32_t contiguous = buf->size - offset;
+    uint32_t claimed = (size < space) ? size : space;
+    claimed = (claimed < contiguous) ? claimed : contiguous;
+    *data = buf->buffer + offset;
+    buf->put_head += claimed;
+    return claimed;
+}
+
+int ring_buf_put_finish(struct ring_buf* buf, uint32_t size) {
+    if (size > buf->put_head - buf->put_tail) {
+        return -EINVAL;
+    }
+    buf->put_tail += size;
+    buf->put_head = buf->put_tail;
+    return 0;
+}
+
+uint32_t ring_buf_put(struct ring_buf* buf, const uint8_t* data, uint32_t size) {
+    uint32_t total = 0;
+    uint32_t claimed;
+    do {
+        uint8_t* dst;
+        claimed = ring_buf_put_claim(buf, &dst, size - total);
+        memcpy(dst, data + total, claimed);
+        total += claimed;
+    } while (total < size && claimed != 0);
+    [[maybe_unused]] int ec = ring_buf_put_finish(buf, total);
+    return total;
+}
+
+uint32_t ring_buf_get_claim(struct ring_buf* buf, uint8_t** data, uint32_t size) {
+    const uint32_t offset = static_cast<uint32_t>(buf->get_head % buf->size);
+    const uint32_t available = static_cast<uint32_t>(buf->put_tail - buf->get_head);
+    const uint32_t contiguous = buf->size - offset;
+    uint32_t claimed = (size < available) ? size : available;
+    claimed = (claimed < contiguous) ? claimed : contiguous;
+    *data = buf->buffer + offset;
+    buf->get_head += claimed;
+    return claimed;
+}
+
+int ring_buf_get_finish(struct ring_buf* buf, uint32_t size) {
+    if (size > buf->get_head - buf->get_tail) {
+        return -EINVAL;
+    }
+    buf->get_tail += size;
+    buf->get_head = buf->get_tail;
+    return 0;
+}
+
+namespace {
+
+uint32_t CopyOut(struct ring_buf* buf, uint8_t* data, uint32_t size) {
+    uint32_t total = 0;
+    uint32_t claimed;
+    do {
+        uint8_t* src;
+        claimed = ring_buf_get_claim(buf, &src, size - total);
+        if (data != nullptr) {
+            memcpy(data + total, src, claimed);
+        }
+        total += claimed;
+    } while (total < size && claimed != 0);
+    return total;
+}
+
+} // namespace
+
+uint32_t ring_buf_get(struct ring_buf* buf, uint8_t* data, uint32_t size) {
+    const uint32_t total = CopyOut(buf, data, size);
+    [[maybe_unused]] int ec = ring_buf_get_finish(buf, total);
+    return total;
+}
+
+uint32_t ring_buf_peek(struct ring_buf* buf, uint8_t* data, uint32_t size) {
+    const uint32_t total = CopyOut(buf, data, size);
+    buf->get_head = buf->get_tail;
+    return total;
+}
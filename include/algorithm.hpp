@@ -0,0 +1,504 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_ALGORITHM_HPP_
+#define _FAVONIUS_ALGORITHM_HPP_
+
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+#if defined(FAVONIUS_ALLOW_STD_HEADERS)
+#if FAVONIUS_ALLOW_STD_HEADERS
+
+#include <algorithm>
+
+namespace ztd = std;
+
+#else
+
+#include <stddef.h>
+
+// A subset of <algorithm> for contiguous ranges (arrays, ztd::array, pointers), which never allocates.
+// Ranges of pointers to trivially copyable types are copied with memmove and filled with memset where the result is
+// the same. These are compiler builtins, so <string.h> is not needed. They are only used outside of constant
+// evaluation, so every function here remains usable in constexpr context.
+
+namespace ztd {
+
+namespace _detail {
+
+constexpr bool is_constant_evaluated() noexcept {
+    return __builtin_is_constant_evaluated();
+}
+
+template <typename T>
+using pointee_t = typename remove_cv<typename remove_pointer<T>::type>::type;
+
+// Both iterators are pointers to the same trivially copyable type, so assignment is a byte copy.
+template <typename InputIt, typename OutputIt>
+struct is_bytewise_copyable : integral_constant<bool,
+    is_pointer<InputIt>::value && is_pointer<OutputIt>::value &&
+    is_same<pointee_t<InputIt>, pointee_t<OutputIt>>::value &&
+    is_trivially_copyable<pointee_t<InputIt>>::value> {};
+
+// Integers compare equal exactly when their bytes do.
+template <typename It>
+struct is_bytewise_comparable : integral_constant<bool,
+    is_pointer<It>::value && is_integral<pointee_t<It>>::value> {};
+
+// Whether every byte of value is the same, in which case a range of it can be filled with memset.
+template <typename T>
+bool repeated_byte(const T& value, unsigned char& byte) noexcept {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    for (size_t i = 1; i < sizeof(T); ++i) {
+        if (bytes[i] != bytes[0]) {
+            return false;
+        }
+    }
+    byte = bytes[0];
+    return true;
+}
+
+} // namespace
+
+template <typename T>
+constexpr const T& min(const T& a, const T& b) {
+    return (b < a) ? b : a;
+}
+
+template <typename T>
+constexpr const T& max(const T& a, const T& b) {
+    return (a < b) ? b : a;
+}
+
+template <typename ForwardIt1, typename ForwardIt2>
+constexpr void iter_swap(ForwardIt1 a, ForwardIt2 b) {
+    ztd::swap(*a, *b);
+}
+
+template <typename ForwardIt, typename T>
+constexpr void fill(ForwardIt first, ForwardIt last, const T& value) {
+    if constexpr (_detail::is_bytewise_copyable<ForwardIt, const T*>::value) {
+        unsigned char byte = 0;
+        if (!_detail::is_constant_evaluated() && _detail::repeated_byte(value, byte)) {
+            __builtin_memset(first, byte, static_cast<size_t>(last - first) * sizeof(T));
+            return;
+        }
+    }
+    for (; first != last; ++first) {
+        *first = value;
+    }
+}
+
+template <typename OutputIt, typename Size, typename T>
+constexpr OutputIt fill_n(OutputIt first, Size count, const T& value) {
+    if (count <= 0) {
+        return first;
+    }
+    if constexpr (_detail::is_bytewise_copyable<OutputIt, const T*>::value) {
+        fill(first, first + count, value);
+        return first + count;
+    } else {
+        for (Size i = 0; i < count; ++i, ++first) {
+            *first = value;
+        }
+        return first;
+    }
+}
+
+// Like std::copy, d_first must not be in [first, last).
+template <typename InputIt, typename OutputIt>
+constexpr OutputIt copy(InputIt first, InputIt last, OutputIt d_first) {
+    if constexpr (_detail::is_bytewise_copyable<InputIt, OutputIt>::value) {
+        if (!_detail::is_constant_evaluated()) {
+            const size_t n = static_cast<size_t>(last - first);
+            if (n > 0) {
+                __builtin_memmove(d_first, first, n * sizeof(*first));
+            }
+            return d_first + n;
+        }
+    }
+    for (; first != last; ++first, ++d_first) {
+        *d_first = *first;
+    }
+    return d_first;
+}
+
+template <typename InputIt, typename Size, typename OutputIt>
+constexpr OutputIt copy_n(InputIt first, Size count, OutputIt d_first) {
+    if (count <= 0) {
+        return d_first;
+    }
+    if constexpr (_detail::is_bytewise_copyable<InputIt, OutputIt>::value) {
+        return copy(first, first + count, d_first);
+    } else {
+        for (Size i = 0; i < count; ++i, ++first, ++d_first) {
+            *d_first = *first;
+        }
+        return d_first;
+    }
+}
+
+// Like std::copy_backward, d_last must not be in (first, last].
+template <typename BidirIt1, typename BidirIt2>
+constexpr BidirIt2 copy_backward(BidirIt1 first, BidirIt1 last, BidirIt2 d_last) {
+    if constexpr (_detail::is_bytewise_copyable<BidirIt1, BidirIt2>::value) {
+        if (!_detail::is_constant_evaluated()) {
+            const size_t n = static_cast<size_t>(last - first);
+            if (n > 0) {
+                __builtin_memmove(d_last - n, first, n * sizeof(*first));
+            }
+            return d_last - n;
+        }
+    }
+    while (first != last) {
+        *(--d_last) = *(--last);
+    }
+    return d_last;
+}
+
+template <typename ForwardIt1, typename ForwardIt2>
+constexpr ForwardIt2 swap_ranges(ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2) {
+    for (; first1 != last1; ++first1, ++first2) {
+        iter_swap(first1, first2);
+    }
+    return first2;
+}
+
+template <typename InputIt, typename UnaryPredicate>
+constexpr InputIt find_if(InputIt first, InputIt last, UnaryPredicate p) {
+    for (; first != last; ++first) {
+        if (p(*first)) {
+            return first;
+        }
+    }
+    return last;
+}
+
+template <typename InputIt, typename UnaryPredicate>
+constexpr InputIt find_if_not(InputIt first, InputIt last, UnaryPredicate q) {
+    for (; first != last; ++first) {
+        if (!q(*first)) {
+            return first;
+        }
+    }
+    return last;
+}
+
+template <typename InputIt, typename T>
+constexpr InputIt find(InputIt first, InputIt last, const T& value) {
+    if constexpr (_detail::is_bytewise_comparable<InputIt>::value && sizeof(_detail::pointee_t<InputIt>) == 1) {
+        if (!_detail::is_constant_evaluated()) {
+            // A value outside the range of the element type can not be found, and must not be truncated by memchr.
+            const _detail::pointee_t<InputIt> narrowed = static_cast<_detail::pointee_t<InputIt>>(value);
+            if (!(narrowed == value) || first == last) {
+                return last;
+            }
+            const void* found = __builtin_memchr(first, static_cast<unsigned char>(narrowed), static_cast<size_t>(last - first));
+            return (found != nullptr) ? first + (static_cast<const unsigned char*>(found) -
+                                                 reinterpret_cast<const unsigned char*>(first))
+                                      : last;
+        }
+    }
+    for (; first != last; ++first) {
+        if (*first == value) {
+            return first;
+        }
+    }
+    return last;
+}
+
+template <typename InputIt, typename UnaryPredicate>
+constexpr ptrdiff_t count_if(InputIt first, InputIt last, UnaryPredicate p) {
+    ptrdiff_t n = 0;
+    for (; first != last; ++first) {
+        if (p(*first)) {
+            ++n;
+        }
+    }
+    return n;
+}
+
+template <typename InputIt, typename T>
+constexpr ptrdiff_t count(InputIt first, InputIt last, const T& value) {
+    return count_if(first, last, [&value](const auto& element) { return element == value; });
+}
+
+template <typename ForwardIt, typename Compare>
+constexpr ForwardIt min_element(ForwardIt first, ForwardIt last, Compare comp) {
+    if (first == last) {
+        return last;
+    }
+    ForwardIt smallest = first;
+    while (++first != last) {
+        if (comp(*first, *smallest)) {
+            smallest = first;
+        }
+    }
+    return smallest;
+}
+
+template <typename ForwardIt>
+constexpr ForwardIt min_element(ForwardIt first, ForwardIt last) {
+    return min_element(first, last, [](const auto& a, const auto& b) { return a < b; });
+}
+
+template <typename ForwardIt, typename Compare>
+constexpr ForwardIt max_element(ForwardIt first, ForwardIt last, Compare comp) {
+    if (first == last) {
+        return last;
+    }
+    ForwardIt largest = first;
+    while (++first != last) {
+        if (comp(*largest, *first)) {
+            largest = first;
+        }
+    }
+    return largest;
+}
+
+template <typename ForwardIt>
+constexpr ForwardIt max_element(ForwardIt first, ForwardIt last) {
+    return max_element(first, last, [](const auto& a, const auto& b) { return a < b; });
+}
+
+template <typename InputIt1, typename InputIt2>
+constexpr bool equal(InputIt1 first1, InputIt1 last1, InputIt2 first2) {
+    if constexpr (_detail::is_bytewise_comparable<InputIt1>::value &&
+                  is_same<_detail::pointee_t<InputIt1>, _detail::pointee_t<InputIt2>>::value) {
+        if (!_detail::is_constant_evaluated()) {
+            const size_t n = static_cast<size_t>(last1 - first1);
+            return (n == 0) || (__builtin_memcmp(first1, first2, n * sizeof(*first1)) == 0);
+        }
+    }
+    for (; first1 != last1; ++first1, ++first2) {
+        if (!(*first1 == *first2)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename InputIt1, typename InputIt2>
+constexpr bool lexicographical_compare(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2) {
+    for (; (first1 != last1) && (first2 != last2); ++first1, ++first2) {
+        if (*first1 < *first2) {
+            return true;
+        }
+        if (*first2 < *first1) {
+            return false;
+        }
+    }
+    return (first1 == last1) && (first2 != last2);
+}
+
+// Binary search. The range must be partitioned with respect to value, e.g. sorted with the same comparison.
+// Unlike the std versions, these require random access iterators.
+
+template <typename ForwardIt, typename T, typename Compare>
+constexpr ForwardIt lower_bound(ForwardIt first, ForwardIt last, const T& value, Compare comp) {
+    auto count = last - first;
+    while (count > 0) {
+        const auto step = count / 2;
+        ForwardIt it = first + step;
+        if (comp(*it, value)) {
+            first = ++it;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+template <typename ForwardIt, typename T>
+constexpr ForwardIt lower_bound(ForwardIt first, ForwardIt last, const T& value) {
+    return lower_bound(first, last, value, [](const auto& a, const auto& b) { return a < b; });
+}
+
+template <typename ForwardIt, typename T, typename Compare>
+constexpr ForwardIt upper_bound(ForwardIt first, ForwardIt last, const T& value, Compare comp) {
+    auto count = last - first;
+    while (count > 0) {
+        const auto step = count / 2;
+        ForwardIt it = first + step;
+        if (!comp(value, *it)) {
+            first = ++it;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+template <typename ForwardIt, typename T>
+constexpr ForwardIt upper_bound(ForwardIt first, ForwardIt last, const T& value) {
+    return upper_bound(first, last, value, [](const auto& a, const auto& b) { return a < b; });
+}
+
+template <typename ForwardIt, typename T, typename Compare>
+constexpr bool binary_search(ForwardIt first, ForwardIt last, const T& value, Compare comp) {
+    first = lower_bound(first, last, value, comp);
+    return (first != last) && !comp(value, *first);
+}
+
+template <typename ForwardIt, typename T>
+constexpr bool binary_search(ForwardIt first, ForwardIt last, const T& value) {
+    return binary_search(first, last, value, [](const auto& a, const auto& b) { return a < b; });
+}
+
+namespace _detail {
+
+// Below this many elements, sort() finishes with insertion sort.
+constexpr ptrdiff_t insertion_sort_threshold = 16;
+
+template <typename RandomIt, typename Compare>
+constexpr void insertion_sort(RandomIt first, RandomIt last, Compare& comp) {
+    if (first == last) {
+        return;
+    }
+    for (RandomIt i = first + 1; i != last; ++i) {
+        auto value = ztd::move(*i);
+        RandomIt j = i;
+        for (; (j != first) && comp(value, *(j - 1)); --j) {
+            *j = ztd::move(*(j - 1));
+        }
+        *j = ztd::move(value);
+    }
+}
+
+template <typename RandomIt, typename Compare>
+constexpr void sift_down(RandomIt first, ptrdiff_t root, ptrdiff_t size, Compare& comp) {
+    while (true) {
+        ptrdiff_t child = 2 * root + 1;
+        if (child >= size) {
+            return;
+        }
+        if ((child + 1 < size) && comp(*(first + child), *(first + child + 1))) {
+            ++child;
+        }
+        if (!comp(*(first + root), *(first + child))) {
+            return;
+        }
+        ztd::iter_swap(first + root, first + child);
+        root = child;
+    }
+}
+
+template <typename RandomIt, typename Compare>
+constexpr void heap_sort(RandomIt first, RandomIt last, Compare& comp) {
+    const ptrdiff_t size = last - first;
+    for (ptrdiff_t root = size / 2 - 1; root >= 0; --root) {
+        sift_down(first, root, size, comp);
+    }
+    for (ptrdiff_t end = size - 1; end > 0; --end) {
+        ztd::iter_swap(first, first + end);
+        sift_down(first, 0, end, comp);
+    }
+}
+
+// Moves the median of a, b and c to a, as the pivot.
+template <typename RandomIt, typename Compare>
+constexpr void move_median_to_first(RandomIt a, RandomIt b, RandomIt c, Compare& comp) {
+    if (comp(*b, *a)) {
+        ztd::iter_swap(a, b);
+    }
+    if (comp(*c, *b)) {
+        ztd::iter_swap(b, c);
+        if (comp(*b, *a)) {
+            ztd::iter_swap(a, b);
+        }
+    }
+    ztd::iter_swap(a, b);
+}
+
+// Hoare partition around the pivot at *first. Returns the start of the upper partition.
+template <typename RandomIt, typename Compare>
+constexpr RandomIt partition_pivot(RandomIt first, RandomIt last, Compare& comp) {
+    RandomIt left = first + 1;
+    RandomIt right = last;
+    while (true) {
+        while (comp(*left, *first)) {
+            ++left;
+        }
+        --right;
+        while (comp(*first, *right)) {
+            --right;
+        }
+        if (!(left < right)) {
+            return left;
+        }
+        ztd::iter_swap(left, right);
+        ++left;
+    }
+}
+
+// Quicksort until partitions are small or the recursion is too deep, then heapsort.
+// Recursing into the smaller partition only bounds the stack depth by log2(n).
+template <typename RandomIt, typename Compare>
+constexpr void introsort_loop(RandomIt first, RandomIt last, ptrdiff_t depth_limit, Compare& comp) {
+    while (last - first > insertion_sort_threshold) {
+        if (depth_limit == 0) {
+            heap_sort(first, last, comp);
+            return;
+        }
+        --depth_limit;
+        move_median_to_first(first, first + (last - first) / 2, last - 1, comp);
+        RandomIt cut = partition_pivot(first, last, comp);
+        if (cut - first < last - cut) {
+            introsort_loop(first, cut, depth_limit, comp);
+            first = cut;
+        } else {
+            introsort_loop(cut, last, depth_limit, comp);
+            last = cut;
+        }
+    }
+}
+
+} // namespace
+
+// Introsort: O(n log n) comparisons in the worst case, no allocation and O(log n) stack. Not stable.
+template <typename RandomIt, typename Compare>
+constexpr void sort(RandomIt first, RandomIt last, Compare comp) {
+    const ptrdiff_t n = last - first;
+    if (n < 2) {
+        return;
+    }
+    ptrdiff_t depth_limit = 0;
+    for (ptrdiff_t m = n; m > 1; m >>= 1) {
+        depth_limit += 2;
+    }
+    _detail::introsort_loop(first, last, depth_limit, comp);
+    _detail::insertion_sort(first, last, comp);
+}
+
+template <typename RandomIt>
+constexpr void sort(RandomIt first, RandomIt last) {
+    sort(first, last, [](const auto& a, const auto& b) { return a < b; });
+}
+
+template <typename ForwardIt, typename Compare>
+constexpr bool is_sorted(ForwardIt first, ForwardIt last, Compare comp) {
+    if (first == last) {
+        return true;
+    }
+    for (ForwardIt next = first; ++next != last; first = next) {
+        if (comp(*next, *first)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename ForwardIt>
+constexpr bool is_sorted(ForwardIt first, ForwardIt last) {
+    return is_sorted(first, last, [](const auto& a, const auto& b) { return a < b; });
+}
+
+} // namespace
+
+#endif // FAVONIUS_ALLOW_STD_HEADERS
+#endif // FAVONIUS_ALLOW_STD_HEADERS
+
+#endif // _FAVONIUS_ALGORITHM_HPP_
@@ -1,7 +1,12 @@
-#ifndef _FAVONIUS_UTILITY_HPP_
-#define _FAVONIUS_UTILITY_HPP_
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
 
+#ifndef _FAVONIUS_ARRAY_HPP_
+#define _FAVONIUS_ARRAY_HPP_
+
+#include "algorithm.hpp"
 #include "type_traits.hpp"
+#include "utility.hpp"
 
 #if defined(FAVONIUS_ALLOW_STD_HEADERS)
 #if FAVONIUS_ALLOW_STD_HEADERS
@@ -12,47 +17,119 @@ namespace ztd = std;
 
 #else
 
+#include <stddef.h>
+
 namespace ztd {
 
-template <typename T, unsigned long long N>
-class array final {
+// Fixed-size array, like std::array.
+// It is an aggregate, so it can be brace-initialized and placed in ROM when const.
+// There is no at(), as favonius does not use exceptions; operator[] is not bounds checked.
+// Reverse iterators are not provided.
+template <typename T, size_t N>
+struct array {
 public:
     using value_type = T;
-    using size_type = unsigned long long;
-    using difference_type = unsigned long long;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
     using reference = value_type&;
     using const_reference = const value_type&;
     using pointer = value_type*;
     using const_pointer = const value_type*;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+
+    constexpr reference       operator[](size_type pos)       noexcept { return _data[pos]; }
+    constexpr const_reference operator[](size_type pos) const noexcept { return _data[pos]; }
 
-    // TODO
-    ~array() noexcept {}
+    constexpr reference       front()       noexcept { return _data[0]; }
+    constexpr const_reference front() const noexcept { return _data[0]; }
+    constexpr reference       back()        noexcept { return _data[N - 1]; }
+    constexpr const_reference back()  const noexcept { return _data[N - 1]; }
 
     constexpr       T* data()       noexcept { return _data; }
     constexpr const T* data() const noexcept { return _data; }
 
-    constexpr size_type     size() const noexcept { return N; }
-    constexpr size_type max_size() const noexcept { return N; }
+    constexpr iterator       begin()        noexcept { return _data; }
+    constexpr const_iterator begin()  const noexcept { return _data; }
+    constexpr const_iterator cbegin() const noexcept { return _data; }
+    constexpr iterator       end()          noexcept { return _data + N; }
+    constexpr const_iterator end()    const noexcept { return _data + N; }
+    constexpr const_iterator cend()   const noexcept { return _data + N; }
+
+    constexpr bool          empty() const noexcept { return N == 0; }
+    constexpr size_type      size() const noexcept { return N; }
+    constexpr size_type  max_size() const noexcept { return N; }
 
     constexpr void fill(const T& value) noexcept {
-        for (size_type i = 0; i < N; ++i) {
-            _data[i] = value;
-        }
+        ztd::fill(begin(), end(), value);
     }
 
+    // Swaps the elements, as arrays own their storage.
     constexpr void swap(array& other) noexcept {
-        const T *const ptr = other._data;
-        other._data = _data;
-        _data = ptr;
+        ztd::swap_ranges(begin(), end(), other.begin());
     }
 
-private:
-    T _data[N];
+    // Public only so that array is an aggregate. Do not use directly.
+    // A zero-sized array still holds one element, as C++ has no zero-length arrays.
+    T _data[(N > 0) ? N : 1];
 };
 
+template <typename T, size_t N>
+constexpr bool operator==(const array<T, N>& lhs, const array<T, N>& rhs) {
+    return ztd::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T, size_t N>
+constexpr bool operator!=(const array<T, N>& lhs, const array<T, N>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename T, size_t N>
+constexpr bool operator<(const array<T, N>& lhs, const array<T, N>& rhs) {
+    return ztd::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, size_t N>
+constexpr bool operator>(const array<T, N>& lhs, const array<T, N>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename T, size_t N>
+constexpr bool operator<=(const array<T, N>& lhs, const array<T, N>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename T, size_t N>
+constexpr bool operator>=(const array<T, N>& lhs, const array<T, N>& rhs) {
+    return !(lhs < rhs);
+}
+
+template <typename T, size_t N>
+constexpr void swap(array<T, N>& lhs, array<T, N>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+template <size_t I, typename T, size_t N>
+constexpr T& get(array<T, N>& a) noexcept {
+    static_assert(I < N, "Index out of bounds.");
+    return a._data[I];
+}
+
+template <size_t I, typename T, size_t N>
+constexpr const T& get(const array<T, N>& a) noexcept {
+    static_assert(I < N, "Index out of bounds.");
+    return a._data[I];
+}
+
+template <size_t I, typename T, size_t N>
+constexpr T&& get(array<T, N>&& a) noexcept {
+    static_assert(I < N, "Index out of bounds.");
+    return ztd::move(a._data[I]);
+}
+
 } // namespace
 
 #endif // FAVONIUS_ALLOW_STD_HEADERS
 #endif // FAVONIUS_ALLOW_STD_HEADERS
 
-#endif // _FAVONIUS_UTILITY_HPP_
\ No newline at end of file
+#endif // _FAVONIUS_ARRAY_HPP_
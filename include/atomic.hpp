@@ -6,65 +6,320 @@
 
 #include <kernel.h>
 
+#include "type_traits.hpp"
+
+// This header implements std::atomic on top of the GCC/Clang __atomic builtins, rather than Zephyr's atomic_t,
+// so that any trivially copyable type can be made atomic and every operation takes a memory order.
+// See https://en.cppreference.com/w/cpp/atomic/atomic
+
 namespace ztd {
 
-// Atomic variables in Zephyr are always 32-bit on 32-bit CPUs and 64-bit on 64-bit CPUs.
-// Therefore standard behaviour of atomic variables larger than ptrdiff_t are not to be expected.
+enum class memory_order : int {
+    relaxed = __ATOMIC_RELAXED,
+    consume = __ATOMIC_CONSUME,
+    acquire = __ATOMIC_ACQUIRE,
+    release = __ATOMIC_RELEASE,
+    acq_rel = __ATOMIC_ACQ_REL,
+    seq_cst = __ATOMIC_SEQ_CST
+};
+
+inline constexpr memory_order memory_order_relaxed = memory_order::relaxed;
+inline constexpr memory_order memory_order_consume = memory_order::consume;
+inline constexpr memory_order memory_order_acquire = memory_order::acquire;
+inline constexpr memory_order memory_order_release = memory_order::release;
+inline constexpr memory_order memory_order_acq_rel = memory_order::acq_rel;
+inline constexpr memory_order memory_order_seq_cst = memory_order::seq_cst;
 
-namespace _detail {
+inline void atomic_thread_fence(memory_order order) noexcept {
+    __atomic_thread_fence(static_cast<int>(order));
+}
+
+inline void atomic_signal_fence(memory_order order) noexcept {
+    __atomic_signal_fence(static_cast<int>(order));
+}
 
-template <typename T, bool PtrSized>
-struct atomic_impl {
-    static_assert(false, "Compiler error: Must select one of the partially specialized templates.");
+// The only type that is guaranteed to be lock-free.
+// Default-constructs to the clear state, as in C++20.
+struct atomic_flag final {
+public:
+    constexpr atomic_flag() noexcept : _value(false) {}
+    atomic_flag(const atomic_flag&) = delete;
+    atomic_flag& operator=(const atomic_flag&) = delete;
+
+    bool test_and_set(memory_order order = memory_order_seq_cst) noexcept {
+        return __atomic_test_and_set(&_value, static_cast<int>(order));
+    }
+
+    void clear(memory_order order = memory_order_seq_cst) noexcept {
+        __atomic_clear(&_value, static_cast<int>(order));
+    }
+
+    bool test(memory_order order = memory_order_seq_cst) const noexcept {
+        return __atomic_load_n(&_value, static_cast<int>(order));
+    }
+
+private:
+    bool _value;
 };
 
-// For types T where the size is smaller than or equal to ptrdiff_t.
+namespace _detail {
+
+// The memory order of a failed compare-exchange cannot contain a release.
+constexpr int failure_order(memory_order order) noexcept {
+    return (order == memory_order_acq_rel) ? __ATOMIC_ACQUIRE :
+           (order == memory_order_release) ? __ATOMIC_RELAXED :
+           static_cast<int>(order);
+}
+
+// The __atomic builtins do not scale pointer arithmetic by the size of the pointee.
+template <typename T> struct atomic_stride     { static constexpr ptrdiff_t value = 1; };
+template <typename T> struct atomic_stride<T*> { static constexpr ptrdiff_t value = sizeof(T); };
+
+template <typename T>
+using atomic_difference_t = typename ztd::conditional<ztd::is_pointer<T>::value, ptrdiff_t, T>::type;
+
+// For types T which the target can operate on natively (usually up to the size of a pointer).
+// Every operation compiles down to a single instruction or LL/SC loop.
 template <typename T>
-struct atomic_impl<T, true> {
+struct atomic_lock_free {
+public:
     using value_type = T;
+    using difference_type = atomic_difference_t<T>;
+    static constexpr bool is_always_lock_free = true;
 
-    atomic_impl() noexcept = default;
-    constexpr atomic_impl() noexcept(noexcept(T())) = default;
-    constexpr atomic_impl(T desired) noexcept : _value(ATOMIC_INIT(desired)) {}
+    constexpr atomic_lock_free() noexcept : _value() {}
+    constexpr atomic_lock_free(T desired) noexcept : _value(desired) {}
+    atomic_lock_free(const atomic_lock_free&) = delete;
+    atomic_lock_free& operator=(const atomic_lock_free&) = delete;
 
-    atomic_impl(const atomic_impl&) = delete;
+    bool is_lock_free() const noexcept { return true; }
 
-    void store(T desired) volatile noexcept {
-        atomic_set(&_value, &desired);
+    void store(T desired, memory_order order = memory_order_seq_cst) noexcept {
+        __atomic_store(&_value, &desired, static_cast<int>(order));
     }
 
-    T load() const noexcept {
-        return atomic_get(_value);
+    T load(memory_order order = memory_order_seq_cst) const noexcept {
+        T value;
+        __atomic_load(&_value, &value, static_cast<int>(order));
+        return value;
     }
 
     operator T() const noexcept {
         return load();
     }
 
-    bool compare_exchange_weak(T& expected, T desired) noexcept {
-        return atomic_cas(&_value, desired, expected);
+    T exchange(T desired, memory_order order = memory_order_seq_cst) noexcept {
+        T previous;
+        __atomic_exchange(&_value, &desired, &previous, static_cast<int>(order));
+        return previous;
+    }
+
+    bool compare_exchange_weak(T& expected, T desired, memory_order success, memory_order failure) noexcept {
+        return __atomic_compare_exchange(&_value, &expected, &desired, true, static_cast<int>(success), static_cast<int>(failure));
+    }
+
+    bool compare_exchange_weak(T& expected, T desired, memory_order order = memory_order_seq_cst) noexcept {
+        return __atomic_compare_exchange(&_value, &expected, &desired, true, static_cast<int>(order), failure_order(order));
+    }
+
+    bool compare_exchange_strong(T& expected, T desired, memory_order success, memory_order failure) noexcept {
+        return __atomic_compare_exchange(&_value, &expected, &desired, false, static_cast<int>(success), static_cast<int>(failure));
+    }
+
+    bool compare_exchange_strong(T& expected, T desired, memory_order order = memory_order_seq_cst) noexcept {
+        return __atomic_compare_exchange(&_value, &expected, &desired, false, static_cast<int>(order), failure_order(order));
+    }
+
+    // Integral and pointer types only.
+    T fetch_add(difference_type arg, memory_order order = memory_order_seq_cst) noexcept {
+        static_assert(ztd::is_integral<T>::value || ztd::is_pointer<T>::value, "fetch_add requires an integral or pointer type.");
+        return __atomic_fetch_add(&_value, arg * atomic_stride<T>::value, static_cast<int>(order));
+    }
+
+    // Integral and pointer types only.
+    T fetch_sub(difference_type arg, memory_order order = memory_order_seq_cst) noexcept {
+        static_assert(ztd::is_integral<T>::value || ztd::is_pointer<T>::value, "fetch_sub requires an integral or pointer type.");
+        return __atomic_fetch_sub(&_value, arg * atomic_stride<T>::value, static_cast<int>(order));
+    }
+
+    // Integral types only.
+    T fetch_and(T arg, memory_order order = memory_order_seq_cst) noexcept {
+        static_assert(ztd::is_integral<T>::value, "fetch_and requires an integral type.");
+        return __atomic_fetch_and(&_value, arg, static_cast<int>(order));
     }
 
+    // Integral types only.
+    T fetch_or(T arg, memory_order order = memory_order_seq_cst) noexcept {
+        static_assert(ztd::is_integral<T>::value, "fetch_or requires an integral type.");
+        return __atomic_fetch_or(&_value, arg, static_cast<int>(order));
+    }
+
+    // Integral types only.
+    T fetch_xor(T arg, memory_order order = memory_order_seq_cst) noexcept {
+        static_assert(ztd::is_integral<T>::value, "fetch_xor requires an integral type.");
+        return __atomic_fetch_xor(&_value, arg, static_cast<int>(order));
+    }
+
+    T operator++() noexcept { return fetch_add(1) + 1; }
+    T operator--() noexcept { return fetch_sub(1) - 1; }
+    T operator++(int) noexcept { return fetch_add(1); }
+    T operator--(int) noexcept { return fetch_sub(1); }
+    T operator+=(difference_type arg) noexcept { return fetch_add(arg) + arg; }
+    T operator-=(difference_type arg) noexcept { return fetch_sub(arg) - arg; }
+    T operator&=(T arg) noexcept { return fetch_and(arg) & arg; }
+    T operator|=(T arg) noexcept { return fetch_or(arg) | arg; }
+    T operator^=(T arg) noexcept { return fetch_xor(arg) ^ arg; }
+
 private:
-    atomic_t _value;
+    alignas(sizeof(T)) T _value;
 };
 
-// For types T where the size is larger than ptrdiff_t.
+// For types T which are too large for the target to operate on natively.
+// Every operation holds a k_spinlock while it copies the value. The spinlock masks interrupts, so the critical section
+// cannot be preempted on its CPU: the atomic may be shared between threads of any priority and ISRs, and other CPUs
+// spin for no longer than one copy.
 template <typename T>
-struct atomic_impl<T, false> {
+struct atomic_locked {
 public:
+    static_assert(ztd::is_trivially_copyable<T>::value, "Atomic types must be trivially copyable.");
+
     using value_type = T;
+    using difference_type = atomic_difference_t<T>;
+    static constexpr bool is_always_lock_free = false;
+
+    constexpr atomic_locked() noexcept : _lock(), _value() {}
+    constexpr atomic_locked(T desired) noexcept : _lock(), _value(desired) {}
+    atomic_locked(const atomic_locked&) = delete;
+    atomic_locked& operator=(const atomic_locked&) = delete;
+
+    bool is_lock_free() const noexcept { return false; }
 
+    // The memory order parameters are accepted for compatibility; operations are always sequentially consistent.
+    void store(T desired, memory_order = memory_order_seq_cst) noexcept {
+        const k_spinlock_key_t key = k_spin_lock(&_lock);
+        _value = desired;
+        k_spin_unlock(&_lock, key);
+    }
+
+    T load(memory_order = memory_order_seq_cst) const noexcept {
+        const k_spinlock_key_t key = k_spin_lock(&_lock);
+        const T value = _value;
+        k_spin_unlock(&_lock, key);
+        return value;
+    }
+
+    operator T() const noexcept {
+        return load();
+    }
+
+    T exchange(T desired, memory_order = memory_order_seq_cst) noexcept {
+        return _FetchUpdate([&desired](const T&) noexcept { return desired; });
+    }
+
+    bool compare_exchange_strong(T& expected, T desired, memory_order = memory_order_seq_cst) noexcept {
+        const k_spinlock_key_t key = k_spin_lock(&_lock);
+        const T current = _value;
+        const bool equal = (__builtin_memcmp(&current, &expected, sizeof(T)) == 0);
+        if (equal) {
+            _value = desired;
+        }
+        k_spin_unlock(&_lock, key);
+        if (!equal) {
+            expected = current;
+        }
+        return equal;
+    }
+
+    bool compare_exchange_strong(T& expected, T desired, memory_order success, memory_order) noexcept {
+        return compare_exchange_strong(expected, desired, success);
+    }
+
+    // Never fails spuriously.
+    bool compare_exchange_weak(T& expected, T desired, memory_order order = memory_order_seq_cst) noexcept {
+        return compare_exchange_strong(expected, desired, order);
+    }
+
+    bool compare_exchange_weak(T& expected, T desired, memory_order success, memory_order) noexcept {
+        return compare_exchange_strong(expected, desired, success);
+    }
+
+    // Integral types only.
+    T fetch_add(difference_type arg, memory_order = memory_order_seq_cst) noexcept {
+        static_assert(ztd::is_integral<T>::value, "fetch_add requires an integral type.");
+        return _FetchUpdate([arg](const T& value) noexcept { return static_cast<T>(value + arg); });
+    }
+
+    // Integral types only.
+    T fetch_sub(difference_type arg, memory_order = memory_order_seq_cst) noexcept {
+        static_assert(ztd::is_integral<T>::value, "fetch_sub requires an integral type.");
+        return _FetchUpdate([arg](const T& value) noexcept { return static_cast<T>(value - arg); });
+    }
+
+    // Integral types only.
+    T fetch_and(T arg, memory_order = memory_order_seq_cst) noexcept {
+        static_assert(ztd::is_integral<T>::value, "fetch_and requires an integral type.");
+        return _FetchUpdate([arg](const T& value) noexcept { return static_cast<T>(value & arg); });
+    }
+
+    // Integral types only.
+    T fetch_or(T arg, memory_order = memory_order_seq_cst) noexcept {
+        static_assert(ztd::is_integral<T>::value, "fetch_or requires an integral type.");
+        return _FetchUpdate([arg](const T& value) noexcept { return static_cast<T>(value | arg); });
+    }
+
+    // Integral types only.
+    T fetch_xor(T arg, memory_order = memory_order_seq_cst) noexcept {
+        static_assert(ztd::is_integral<T>::value, "fetch_xor requires an integral type.");
+        return _FetchUpdate([arg](const T& value) noexcept { return static_cast<T>(value ^ arg); });
+    }
+
+    T operator++() noexcept { return fetch_add(1) + 1; }
+    T operator--() noexcept { return fetch_sub(1) - 1; }
+    T operator++(int) noexcept { return fetch_add(1); }
+    T operator--(int) noexcept { return fetch_sub(1); }
+    T operator+=(difference_type arg) noexcept { return fetch_add(arg) + arg; }
+    T operator-=(difference_type arg) noexcept { return fetch_sub(arg) - arg; }
+    T operator&=(T arg) noexcept { return fetch_and(arg) & arg; }
+    T operator|=(T arg) noexcept { return fetch_or(arg) | arg; }
+    T operator^=(T arg) noexcept { return fetch_xor(arg) ^ arg; }
 
 private:
-    ATOMIC_DEFINE(_value, sizeof(T));
+    // k_spin_lock() takes a non-const pointer, also in load().
+    mutable struct k_spinlock _lock;
+    T _value;
+
+    // Replaces the value with op(value) and returns the previous value.
+    template <typename Op>
+    T _FetchUpdate(Op op) noexcept {
+        const k_spinlock_key_t key = k_spin_lock(&_lock);
+        const T previous = _value;
+        _value = op(previous);
+        k_spin_unlock(&_lock, key);
+        return previous;
+    }
 };
 
+template <typename T>
+using atomic_base = typename ztd::conditional<__atomic_always_lock_free(sizeof(T), 0), atomic_lock_free<T>, atomic_locked<T>>::type;
+
 } // namespace _detail
 
-template <typename T, bool PtrSized = (sizeof(T) <= sizeof(ptrdiff_t))>
-using atomic = _detail::atomic_impl<T, PtrSized>;
+// Integral and pointer specializations gain fetch_* and the arithmetic operators.
+// Calling those on other types is a compile-time error.
+template <typename T>
+struct atomic final : public _detail::atomic_base<T> {
+public:
+    using _detail::atomic_base<T>::atomic_base;
+    atomic(const atomic&) = delete;
+    atomic& operator=(const atomic&) = delete;
+
+    T operator=(T desired) noexcept {
+        this->store(desired);
+        return desired;
+    }
+};
 
+using atomic_bool = atomic<bool>;
 using atomic_char = atomic<char>;
 using atomic_schar = atomic<signed char>;
 using atomic_uchar = atomic<unsigned char>;
@@ -81,11 +336,16 @@ using atomic_int8_t = atomic<int8_t>;
 using atomic_uint8_t = atomic<uint8_t>;
 using atomic_int16_t = atomic<int16_t>;
 using atomic_uint16_t = atomic<uint16_t>;
-using atomic_int32_t = atomic<uint32_t>;
+using atomic_int32_t = atomic<int32_t>;
 using atomic_uint32_t = atomic<uint32_t>;
-using atomic_int64_t = atomic<uint64_t>;
+using atomic_int64_t = atomic<int64_t>;
 using atomic_uint64_t = atomic<uint64_t>;
 
+using atomic_intptr_t = atomic<intptr_t>;
+using atomic_uintptr_t = atomic<uintptr_t>;
+using atomic_size_t = atomic<size_t>;
+using atomic_ptrdiff_t = atomic<ptrdiff_t>;
+
 } // namespace
 
-#endif // _FAVONIUS_ATOMIC_HPP_
\ No newline at end of file
+#endif // _FAVONIUS_ATOMIC_HPP_
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_BARRIER_HPP_
+#define _FAVONIUS_BARRIER_HPP_
+
+#include <kernel.h>
+
+#include "atomic.hpp"
+#include "futex.hpp"
+#include "utility.hpp"
+
+// This header implements the C++20 barrier.
+// See https://en.cppreference.com/w/cpp/thread/barrier
+
+namespace ztd {
+
+namespace _detail {
+
+struct empty_completion {
+    void operator()() noexcept {}
+};
+
+} // namespace _detail
+
+// Reusable thread barrier. Each phase completes once the expected number of threads have arrived;
+// the last arriving thread runs the completion function, resets the counter and wakes the other threads.
+// Arrival is one atomic operation, so only the last arriver and threads which actually have to sleep enter the kernel.
+template <typename CompletionFunction = _detail::empty_completion>
+class barrier final {
+public:
+    // Identifies the phase in which a thread arrived. Pass it to wait().
+    class arrival_token {
+    public:
+        arrival_token(arrival_token&&) noexcept = default;
+        arrival_token& operator=(arrival_token&&) noexcept = default;
+    private:
+        friend class barrier;
+        explicit arrival_token(atomic_val_t phase) noexcept : _phase(phase) {}
+        atomic_val_t _phase;
+    };
+
+    constexpr static ptrdiff_t max() noexcept {
+        return static_cast<ptrdiff_t>(~0UL >> 1);
+    }
+
+    explicit barrier(ptrdiff_t expected, CompletionFunction completion = CompletionFunction()) noexcept
+        : _expected(expected), _remaining(expected), _phase(0), _completion(ztd::move(completion)) {}
+    barrier(const barrier&) = delete;
+    barrier& operator=(const barrier&) = delete;
+
+    // Arrives at the barrier n times, without blocking.
+    [[nodiscard]] arrival_token arrive(ptrdiff_t n = 1) noexcept {
+        // The phase cannot advance before this thread's arrival is counted, so it is safe to read it first.
+        const atomic_val_t phase = _phase.Load();
+        if (_remaining.fetch_sub(n, ztd::memory_order_acq_rel) == n) {
+            _CompletePhase();
+        }
+        return arrival_token(phase);
+    }
+
+    // Blocks until the phase identified by arrival has completed.
+    void wait(arrival_token&& arrival) const noexcept {
+        while (_phase.Load() == arrival._phase) {
+            _phase.Wait(arrival._phase);
+        }
+    }
+
+    void arrive_and_wait() noexcept {
+        wait(arrive());
+    }
+
+    // Arrives at the barrier, and removes this thread from the expected count of all subsequent phases.
+    void arrive_and_drop() noexcept {
+        _expected.fetch_sub(1, ztd::memory_order_relaxed);
+        (void)arrive();
+    }
+
+private:
+    ztd::atomic<ptrdiff_t> _expected;
+    ztd::atomic<ptrdiff_t> _remaining;
+    mutable fav::Futex _phase;
+    CompletionFunction _completion;
+
+    void _CompletePhase() noexcept {
+        _completion();
+        // No thread can arrive for the next phase until it observes the new phase value.
+        _remaining.store(_expected.load(ztd::memory_order_relaxed), ztd::memory_order_relaxed);
+        atomic_inc(_phase.Word());
+        _phase.WakeAll();
+    }
+};
+
+} // namespace
+
+#endif // _FAVONIUS_BARRIER_HPP_
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_BITMAPALLOCATOR_HPP_
+#define _FAVONIUS_BITMAPALLOCATOR_HPP_
+
+#include "bitset.hpp"
+
+namespace fav {
+
+// Allocates indices 0 to N - 1, e.g. of channels, DMA descriptors or entries of a caller-owned table.
+// An index is in use if its bit is set, so the state of N indices takes N bits.
+// Allocate() searches a word at a time from a hint, which follows the last allocation and moves back to an index
+// when it is freed, so that allocation usually finds a free index in the first word it looks at. It is O(N / word size)
+// in the worst case. Free() is O(1).
+// Member functions are NOT thread safe.
+template <size_t N>
+class BitmapAllocator final {
+public:
+    constexpr BitmapAllocator() noexcept : _used(), _hint(0) {}
+
+    static constexpr size_t Capacity() noexcept { return N; }
+    size_t Size() const noexcept { return _used.count(); }
+    size_t Available() const noexcept { return N - Size(); }
+    bool Full() const noexcept { return _used.all(); }
+    bool Empty() const noexcept { return _used.none(); }
+
+    bool IsAllocated(size_t index) const noexcept { return (index < N) && _used.test(index); }
+
+    // The indices in use, one bit each.
+    const ztd::bitset<N>& Bitmap() const noexcept { return _used; }
+
+    // Allocates any free index. Returns false if there is none.
+    bool Allocate(size_t& index) noexcept {
+        size_t found = _used.FindNextClear(_hint);
+        if (found == N) {
+            found = _used.FindFirstClear();
+            if (found == N) {
+                return false;
+            }
+        }
+        _used.set(found);
+        _hint = (found + 1 < N) ? found + 1 : 0;
+        index = found;
+        return true;
+    }
+
+    // Allocates a particular index, e.g. one reserved by hardware. Returns false if it is out of range or in use.
+    bool AllocateAt(size_t index) noexcept {
+        if (index >= N || _used.test(index)) {
+            return false;
+        }
+        _used.set(index);
+        return true;
+    }
+
+    // Allocates count consecutive indices, the first of which is stored in index. First fit, O(N / word size).
+    // Returns false if there is no such range.
+    bool AllocateRange(size_t count, size_t& index) noexcept {
+        if (count == 0 || count > N) {
+            return false;
+        }
+        size_t first = _used.FindFirstClear();
+        while (first <= N - count) {
+            const size_t next_used = _used.FindNextSet(first);
+            if (next_used - first >= count) {
+                for (size_t i = first; i < first + count; ++i) {
+                    _used.set(i);
+                }
+                index = first;
+                return true;
+            }
+            first = _used.FindNextClear(next_used);
+        }
+        return false;
+    }
+
+    // Returns false if the index is out of range or not in use.
+    bool Free(size_t index) noexcept {
+        if (!IsAllocated(index)) {
+            return false;
+        }
+        _used.reset(index);
+        _hint = index;
+        return true;
+    }
+
+    // Frees count consecutive indices from index, which need not all be in use.
+    void FreeRange(size_t index, size_t count) noexcept {
+        for (size_t i = index; i < index + count && i < N; ++i) {
+            _used.reset(i);
+        }
+        _hint = index;
+    }
+
+    void Clear() noexcept {
+        _used.reset();
+        _hint = 0;
+    }
+
+private:
+    ztd::bitset<N> _used;
+    size_t _hint;
+};
+
+} // namespace
+
+#endif // _FAVONIUS_BITMAPALLOCATOR_HPP_
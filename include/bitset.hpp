@@ -0,0 +1,296 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_BITSET_HPP_
+#define _FAVONIUS_BITSET_HPP_
+
+#include <limits.h>
+#include <stddef.h>
+
+// This header implements the std::bitset of <bitset>, without the string conversions.
+// See https://en.cppreference.com/w/cpp/utility/bitset
+// Bits are stored in machine words, and every operation works a word at a time: count() is a popcount per word
+// and the Find functions skip a word of unwanted bits with a single test and a count of trailing zeroes.
+// Nothing throws: positions are not checked, like operator[] in std.
+// Non-std additions find the first or next bit that is set or clear, returning size() if there is none.
+
+namespace ztd {
+
+template <size_t N>
+class bitset final {
+    using word_type = unsigned long;
+
+    static constexpr size_t word_bits = sizeof(word_type) * CHAR_BIT;
+    static constexpr size_t word_count = (N > 0) ? (N + word_bits - 1) / word_bits : 1;
+    static constexpr word_type all_ones = ~static_cast<word_type>(0);
+    // The bits of the last word which are part of the set.
+    static constexpr word_type last_word_mask =
+        (N == 0) ? 0 : ((N % word_bits == 0) ? all_ones : (all_ones >> (word_bits - N % word_bits)));
+
+public:
+    // Refers to a single bit, as returned by the non-const operator[].
+    class reference final {
+    public:
+        constexpr reference& operator=(bool value) noexcept {
+            _owner->set(_pos, value);
+            return *this;
+        }
+        constexpr reference& operator=(const reference& other) noexcept { return *this = static_cast<bool>(other); }
+        constexpr operator bool() const noexcept { return _owner->test(_pos); }
+        constexpr bool operator~() const noexcept { return !_owner->test(_pos); }
+        constexpr reference& flip() noexcept {
+            _owner->flip(_pos);
+            return *this;
+        }
+
+    private:
+        friend class bitset;
+        constexpr reference(bitset* owner, size_t pos) noexcept : _owner(owner), _pos(pos) {}
+
+        bitset* _owner;
+        size_t _pos;
+    };
+
+    constexpr bitset() noexcept : _words{} {}
+
+    // The low bits of value, as far as N goes.
+    constexpr bitset(unsigned long long value) noexcept : _words{} {
+        for (size_t i = 0; i < word_count && i * word_bits < sizeof(value) * CHAR_BIT; ++i) {
+            _words[i] = static_cast<word_type>(value >> (i * word_bits));
+        }
+        _trim();
+    }
+
+    constexpr bool operator==(const bitset& other) const noexcept {
+        for (size_t i = 0; i < word_count; ++i) {
+            if (_words[i] != other._words[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr bool operator!=(const bitset& other) const noexcept { return !(*this == other); }
+
+    constexpr bool operator[](size_t pos) const noexcept { return test(pos); }
+    constexpr reference operator[](size_t pos) noexcept { return reference(this, pos); }
+
+    constexpr bool test(size_t pos) const noexcept {
+        return (_words[pos / word_bits] & _bit(pos)) != 0;
+    }
+
+    constexpr bool all() const noexcept {
+        for (size_t i = 0; i + 1 < word_count; ++i) {
+            if (_words[i] != all_ones) {
+                return false;
+            }
+        }
+        return _words[word_count - 1] == last_word_mask;
+    }
+
+    constexpr bool any() const noexcept {
+        for (size_t i = 0; i < word_count; ++i) {
+            if (_words[i] != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    constexpr bool none() const noexcept { return !any(); }
+
+    constexpr size_t count() const noexcept {
+        size_t total = 0;
+        for (size_t i = 0; i < word_count; ++i) {
+            total += static_cast<size_t>(__builtin_popcountl(_words[i]));
+        }
+        return total;
+    }
+
+    constexpr size_t size() const noexcept { return N; }
+
+    constexpr bitset& operator&=(const bitset& other) noexcept {
+        for (size_t i = 0; i < word_count; ++i) {
+            _words[i] &= other._words[i];
+        }
+        return *this;
+    }
+
+    constexpr bitset& operator|=(const bitset& other) noexcept {
+        for (size_t i = 0; i < word_count; ++i) {
+            _words[i] |= other._words[i];
+        }
+        return *this;
+    }
+
+    constexpr bitset& operator^=(const bitset& other) noexcept {
+        for (size_t i = 0; i < word_count; ++i) {
+            _words[i] ^= other._words[i];
+        }
+        return *this;
+    }
+
+    constexpr bitset operator~() const noexcept {
+        bitset result = *this;
+        return result.flip();
+    }
+
+    constexpr bitset& operator<<=(size_t shift) noexcept {
+        const size_t words = shift / word_bits;
+        const size_t bits = shift % word_bits;
+        for (size_t i = word_count; i > 0; --i) {
+            const size_t to = i - 1;
+            word_type word = 0;
+            if (to >= words) {
+                word = _words[to - words] << bits;
+                if (bits != 0 && to > words) {
+                    word |= _words[to - words - 1] >> (word_bits - bits);
+                }
+            }
+            _words[to] = word;
+        }
+        _trim();
+        return *this;
+    }
+
+    constexpr bitset& operator>>=(size_t shift) noexcept {
+        const size_t words = shift / word_bits;
+        const size_t bits = shift % word_bits;
+        for (size_t to = 0; to < word_count; ++to) {
+            word_type word = 0;
+            if (to + words < word_count) {
+                word = _words[to + words] >> bits;
+                if (bits != 0 && to + words + 1 < word_count) {
+                    word |= _words[to + words + 1] << (word_bits - bits);
+                }
+            }
+            _words[to] = word;
+        }
+        return *this;
+    }
+
+    constexpr bitset operator<<(size_t shift) const noexcept {
+        bitset result = *this;
+        return result <<= shift;
+    }
+
+    constexpr bitset operator>>(size_t shift) const noexcept {
+        bitset result = *this;
+        return result >>= shift;
+    }
+
+    constexpr bitset& set() noexcept {
+        for (size_t i = 0; i < word_count; ++i) {
+            _words[i] = all_ones;
+        }
+        _trim();
+        return *this;
+    }
+
+    constexpr bitset& set(size_t pos, bool value = true) noexcept {
+        if (value) {
+            _words[pos / word_bits] |= _bit(pos);
+        } else {
+            _words[pos / word_bits] &= ~_bit(pos);
+        }
+        return *this;
+    }
+
+    constexpr bitset& reset() noexcept {
+        for (size_t i = 0; i < word_count; ++i) {
+            _words[i] = 0;
+        }
+        return *this;
+    }
+
+    constexpr bitset& reset(size_t pos) noexcept { return set(pos, false); }
+
+    constexpr bitset& flip() noexcept {
+        for (size_t i = 0; i < word_count; ++i) {
+            _words[i] = ~_words[i];
+        }
+        _trim();
+        return *this;
+    }
+
+    constexpr bitset& flip(size_t pos) noexcept {
+        _words[pos / word_bits] ^= _bit(pos);
+        return *this;
+    }
+
+    // The low bits, which must all fit; where std would throw overflow_error, the higher bits are dropped.
+    constexpr unsigned long to_ulong() const noexcept { return static_cast<unsigned long>(to_ullong()); }
+
+    constexpr unsigned long long to_ullong() const noexcept {
+        unsigned long long value = 0;
+        for (size_t i = 0; i < word_count && i * word_bits < sizeof(value) * CHAR_BIT; ++i) {
+            value |= static_cast<unsigned long long>(_words[i]) << (i * word_bits);
+        }
+        return value;
+    }
+
+    // Non-std additions.
+
+    // Position of the first set bit, or size() if there is none.
+    constexpr size_t FindFirstSet() const noexcept { return FindNextSet(0); }
+
+    // Position of the first set bit at or after pos, or size() if there is none.
+    constexpr size_t FindNextSet(size_t pos) const noexcept { return _find(pos, 0); }
+
+    // Position of the first clear bit, or size() if there is none.
+    constexpr size_t FindFirstClear() const noexcept { return FindNextClear(0); }
+
+    // Position of the first clear bit at or after pos, or size() if there is none.
+    constexpr size_t FindNextClear(size_t pos) const noexcept { return _find(pos, all_ones); }
+
+private:
+    word_type _words[word_count];
+
+    static constexpr word_type _bit(size_t pos) noexcept {
+        return static_cast<word_type>(1) << (pos % word_bits);
+    }
+
+    // Clears the bits past N, which every operation relies on being 0.
+    constexpr void _trim() noexcept { _words[word_count - 1] &= last_word_mask; }
+
+    // Finds the first bit at or after pos which differs from the bits of invert,
+    // i.e. the first set bit if invert is 0, or the first clear bit if it is all ones.
+    constexpr size_t _find(size_t pos, word_type invert) const noexcept {
+        if (pos >= N) {
+            return N;
+        }
+        size_t i = pos / word_bits;
+        word_type word = (_words[i] ^ invert) & (all_ones << (pos % word_bits));
+        while (word == 0) {
+            if (++i == word_count) {
+                return N;
+            }
+            word = _words[i] ^ invert;
+        }
+        const size_t found = i * word_bits + static_cast<size_t>(__builtin_ctzl(word));
+        // The bits past N are clear, so they are found when looking for a clear bit.
+        return (found < N) ? found : N;
+    }
+};
+
+template <size_t N>
+constexpr bitset<N> operator&(const bitset<N>& lhs, const bitset<N>& rhs) noexcept {
+    bitset<N> result = lhs;
+    return result &= rhs;
+}
+
+template <size_t N>
+constexpr bitset<N> operator|(const bitset<N>& lhs, const bitset<N>& rhs) noexcept {
+    bitset<N> result = lhs;
+    return result |= rhs;
+}
+
+template <size_t N>
+constexpr bitset<N> operator^(const bitset<N>& lhs, const bitset<N>& rhs) noexcept {
+    bitset<N> result = lhs;
+    return result ^= rhs;
+}
+
+} // namespace
+
+#endif // _FAVONIUS_BITSET_HPP_
@@ -3,6 +3,8 @@
 
 #include <kernel.h>
 
+#include "type_traits.hpp"
+
 #if defined(CONFIG_SYS_CLOCK_EXISTS)
 #if CONFIG_SYS_CLOCK_EXISTS
 #if defined(CONFIG_SYS_CLOCK_TICKS_PER_SEC)
@@ -15,68 +17,284 @@ constexpr int SysClockTicksPerSecond = 10000;
 
 // Chrono is pretty complex, this header is meant to only implement the very frequently accessed stuff.
 // I might complete it more over time though.
+// Unlike std, the period of a duration is given directly as Num / Denom seconds rather than as a std::ratio.
+// All conversions between periods are reduced at compile time to a single integer multiply and/or divide,
+// so no floating point arithmetic is ever involved unless Rep itself is a floating point type.
 
 namespace ztd {
 
+namespace _detail {
+
+constexpr uint64_t gcd(uint64_t a, uint64_t b) noexcept {
+    return (b == 0) ? a : gcd(b, a % b);
+}
+
+constexpr uint64_t lcm(uint64_t a, uint64_t b) noexcept {
+    return (a / gcd(a, b)) * b;
+}
+
+// The factor converting a count of period Num1/Denom1 into a count of period Num2/Denom2,
+// i.e. (Num1 * Denom2) / (Denom1 * Num2), reduced so that intermediate products are as small as possible.
+template <uint64_t Num1, uint64_t Denom1, uint64_t Num2, uint64_t Denom2>
+struct ratio_divide {
+private:
+    static constexpr uint64_t gn = gcd(Num1, Num2);
+    static constexpr uint64_t gd = gcd(Denom1, Denom2);
+    static constexpr uint64_t n = (Num1 / gn) * (Denom2 / gd);
+    static constexpr uint64_t d = (Denom1 / gd) * (Num2 / gn);
+public:
+    static constexpr uint64_t num = n / gcd(n, d);
+    static constexpr uint64_t den = d / gcd(n, d);
+};
+
+} // namespace _detail
+
+template <typename Rep, uint64_t Num, uint64_t Denom>
+class duration;
+
+template <typename T>
+struct is_duration : ztd::false_type {};
+
+template <typename Rep, uint64_t Num, uint64_t Denom>
+struct is_duration<duration<Rep, Num, Denom>> : ztd::true_type {};
+
+// Converts a duration to another period, truncating towards zero.
+// Compiles to a single multiplication and/or division by compile-time constants.
+template <typename ToDuration, typename Rep, uint64_t Num, uint64_t Denom>
+constexpr ToDuration duration_cast(const duration<Rep, Num, Denom>& d) noexcept {
+    static_assert(is_duration<ToDuration>::value, "duration_cast can only convert to a duration.");
+    using ToRep = typename ToDuration::rep;
+    using Factor = _detail::ratio_divide<Num, Denom, ToDuration::numerator, ToDuration::denominator>;
+    using CommonRep = decltype(ToRep() + Rep() + 0LL);
+
+    if constexpr (Factor::num == 1 && Factor::den == 1) {
+        return ToDuration(static_cast<ToRep>(d.count()));
+    } else if constexpr (Factor::num == 1) {
+        return ToDuration(static_cast<ToRep>(static_cast<CommonRep>(d.count()) / static_cast<CommonRep>(Factor::den)));
+    } else if constexpr (Factor::den == 1) {
+        return ToDuration(static_cast<ToRep>(static_cast<CommonRep>(d.count()) * static_cast<CommonRep>(Factor::num)));
+    } else {
+        return ToDuration(static_cast<ToRep>(static_cast<CommonRep>(d.count()) * static_cast<CommonRep>(Factor::num) / static_cast<CommonRep>(Factor::den)));
+    }
+}
+
+// Converts a duration to another period, rounding towards negative infinity.
+template <typename ToDuration, typename Rep, uint64_t Num, uint64_t Denom>
+constexpr ToDuration floor(const duration<Rep, Num, Denom>& d) noexcept {
+    ToDuration t = duration_cast<ToDuration>(d);
+    if (t > d) {
+        --t;
+    }
+    return t;
+}
+
+// Converts a duration to another period, rounding towards positive infinity.
+template <typename ToDuration, typename Rep, uint64_t Num, uint64_t Denom>
+constexpr ToDuration ceil(const duration<Rep, Num, Denom>& d) noexcept {
+    ToDuration t = duration_cast<ToDuration>(d);
+    if (t < d) {
+        ++t;
+    }
+    return t;
+}
+
 template <typename Rep, uint64_t Num, uint64_t Denom>
 class duration {
 public:
     static_assert(Num > 0, "Numerator must be greater than zero.");
     static_assert(Denom > 0, "Denominator must be greater than zero.");
+    using rep = Rep;
     static constexpr uint64_t numerator = Num;
     static constexpr uint64_t denominator = Denom;
 
     constexpr duration() noexcept : _ticks(0) {}
     constexpr duration(Rep ticks) noexcept : _ticks(ticks) {}
 
-    template <typename Rep2, uint64_t Num2, uint64_t Denom2>
-    constexpr explicit duration(const duration<Rep2, Num2, Denom2>& d) noexcept {
-        double numRatio = static_cast<double>(d.numerator) / numerator;
-        double denomRatio = static_cast<double>(denominator) / d.denominator;
-        _ticks = static_cast<Rep>(d._ticks * numRatio * denomRatio);
-    }
+    // Implicit conversion, only when no precision is lost (e.g. seconds to milliseconds).
+    template <typename Rep2, uint64_t Num2, uint64_t Denom2,
+              typename ztd::enable_if<ztd::is_floating_point<Rep>::value || _detail::ratio_divide<Num2, Denom2, Num, Denom>::den == 1, int>::type = 0>
+    constexpr duration(const duration<Rep2, Num2, Denom2>& d) noexcept
+        : _ticks(duration_cast<duration>(d).count()) {}
+
+    // Explicit conversion, truncating towards zero (e.g. milliseconds to seconds).
+    template <typename Rep2, uint64_t Num2, uint64_t Denom2,
+              typename ztd::enable_if<!ztd::is_floating_point<Rep>::value && _detail::ratio_divide<Num2, Denom2, Num, Denom>::den != 1, int>::type = 0>
+    constexpr explicit duration(const duration<Rep2, Num2, Denom2>& d) noexcept
+        : _ticks(duration_cast<duration>(d).count()) {}
 
     constexpr Rep count() const noexcept {
         return _ticks;
     }
 
-    constexpr duration& operator+(const duration& other) noexcept {
-        _ticks += other._ticks;
+    constexpr duration operator+() const noexcept { return *this; }
+    constexpr duration operator-() const noexcept { return duration(-_ticks); }
+
+    constexpr duration& operator++() noexcept {
+        ++_ticks;
         return *this;
     }
 
-    constexpr duration& operator-(const duration& other) noexcept {
-        _ticks -= other._ticks;
+    constexpr duration operator++(int) noexcept {
+        return duration(_ticks++);
+    }
+
+    constexpr duration& operator--() noexcept {
+        --_ticks;
         return *this;
     }
 
-    constexpr duration& operator++() noexcept {
-        _ticks += 1;
+    constexpr duration operator--(int) noexcept {
+        return duration(_ticks--);
+    }
+
+    constexpr duration& operator+=(const duration& other) noexcept {
+        _ticks += other._ticks;
         return *this;
     }
 
-    constexpr duration& operator++(int i) noexcept {
-        _ticks += i;
+    constexpr duration& operator-=(const duration& other) noexcept {
+        _ticks -= other._ticks;
         return *this;
     }
 
-    constexpr duration& operator--() noexcept {
-        _ticks -= 1;
+    constexpr duration& operator*=(const Rep& rhs) noexcept {
+        _ticks *= rhs;
         return *this;
     }
 
-    constexpr duration& operator--(int i) noexcept {
-        _ticks -= i;
+    constexpr duration& operator/=(const Rep& rhs) noexcept {
+        _ticks /= rhs;
         return *this;
     }
 
     static constexpr duration zero() noexcept {
         return duration();
     }
+
+    // Rep is assumed to be a two's complement integer, or a floating point type.
+    static constexpr duration max() noexcept {
+        if constexpr (ztd::is_floating_point<Rep>::value) {
+            return duration(static_cast<Rep>(__builtin_huge_val()));
+        } else if constexpr (static_cast<Rep>(-1) < 0) {
+            return duration(static_cast<Rep>(~0ULL >> (65 - sizeof(Rep) * 8)));
+        } else {
+            return duration(static_cast<Rep>(~0ULL));
+        }
+    }
+
+    static constexpr duration min() noexcept {
+        if constexpr (ztd::is_floating_point<Rep>::value) {
+            return duration(-static_cast<Rep>(__builtin_huge_val()));
+        } else if constexpr (static_cast<Rep>(-1) < 0) {
+            return duration(-max().count() - 1);
+        } else {
+            return duration(0);
+        }
+    }
+
 private:
     Rep _ticks;
 };
 
+namespace _detail {
+
+// The duration both operands can be converted to without loss: the coarsest period which divides both periods.
+template <typename Duration1, typename Duration2>
+struct common_duration;
+
+template <typename Rep1, uint64_t Num1, uint64_t Denom1, typename Rep2, uint64_t Num2, uint64_t Denom2>
+struct common_duration<duration<Rep1, Num1, Denom1>, duration<Rep2, Num2, Denom2>> {
+    using type = duration<decltype(Rep1() + Rep2()), gcd(Num1, Num2), lcm(Denom1, Denom2)>;
+};
+
+template <typename Duration1, typename Duration2>
+using common_duration_t = typename common_duration<Duration1, Duration2>::type;
+
+} // namespace _detail
+
+template <typename Rep1, uint64_t Num1, uint64_t Denom1, typename Rep2, uint64_t Num2, uint64_t Denom2>
+constexpr auto operator+(const duration<Rep1, Num1, Denom1>& lhs, const duration<Rep2, Num2, Denom2>& rhs) noexcept {
+    using Common = _detail::common_duration_t<duration<Rep1, Num1, Denom1>, duration<Rep2, Num2, Denom2>>;
+    return Common(Common(lhs).count() + Common(rhs).count());
+}
+
+template <typename Rep1, uint64_t Num1, uint64_t Denom1, typename Rep2, uint64_t Num2, uint64_t Denom2>
+constexpr auto operator-(const duration<Rep1, Num1, Denom1>& lhs, const duration<Rep2, Num2, Denom2>& rhs) noexcept {
+    using Common = _detail::common_duration_t<duration<Rep1, Num1, Denom1>, duration<Rep2, Num2, Denom2>>;
+    return Common(Common(lhs).count() - Common(rhs).count());
+}
+
+// Scaling by a number. As in std, the scalar has its own type, so that e.g. milliseconds(5) * 2 compiles although
+// the literal is an int, and the result has the common type of both.
+template <typename Rep1, uint64_t Num, uint64_t Denom, typename Rep2,
+          typename ztd::enable_if<ztd::is_arithmetic<Rep2>::value, int>::type = 0>
+constexpr auto operator*(const duration<Rep1, Num, Denom>& d, const Rep2& s) noexcept {
+    return duration<decltype(Rep1() * Rep2()), Num, Denom>(d.count() * s);
+}
+
+template <typename Rep1, typename Rep2, uint64_t Num, uint64_t Denom,
+          typename ztd::enable_if<ztd::is_arithmetic<Rep1>::value, int>::type = 0>
+constexpr auto operator*(const Rep1& s, const duration<Rep2, Num, Denom>& d) noexcept {
+    return d * s;
+}
+
+template <typename Rep1, uint64_t Num, uint64_t Denom, typename Rep2,
+          typename ztd::enable_if<ztd::is_arithmetic<Rep2>::value, int>::type = 0>
+constexpr auto operator/(const duration<Rep1, Num, Denom>& d, const Rep2& s) noexcept {
+    return duration<decltype(Rep1() / Rep2()), Num, Denom>(d.count() / s);
+}
+
+template <typename Rep1, uint64_t Num, uint64_t Denom, typename Rep2,
+          typename ztd::enable_if<ztd::is_integral<Rep2>::value, int>::type = 0>
+constexpr auto operator%(const duration<Rep1, Num, Denom>& d, const Rep2& s) noexcept {
+    return duration<decltype(Rep1() % Rep2()), Num, Denom>(d.count() % s);
+}
+
+// The number of times rhs fits into lhs.
+template <typename Rep1, uint64_t Num1, uint64_t Denom1, typename Rep2, uint64_t Num2, uint64_t Denom2>
+constexpr auto operator/(const duration<Rep1, Num1, Denom1>& lhs, const duration<Rep2, Num2, Denom2>& rhs) noexcept {
+    using Common = _detail::common_duration_t<duration<Rep1, Num1, Denom1>, duration<Rep2, Num2, Denom2>>;
+    return Common(lhs).count() / Common(rhs).count();
+}
+
+template <typename Rep1, uint64_t Num1, uint64_t Denom1, typename Rep2, uint64_t Num2, uint64_t Denom2>
+constexpr auto operator%(const duration<Rep1, Num1, Denom1>& lhs, const duration<Rep2, Num2, Denom2>& rhs) noexcept {
+    using Common = _detail::common_duration_t<duration<Rep1, Num1, Denom1>, duration<Rep2, Num2, Denom2>>;
+    return Common(Common(lhs).count() % Common(rhs).count());
+}
+
+template <typename Rep1, uint64_t Num1, uint64_t Denom1, typename Rep2, uint64_t Num2, uint64_t Denom2>
+constexpr bool operator==(const duration<Rep1, Num1, Denom1>& lhs, const duration<Rep2, Num2, Denom2>& rhs) noexcept {
+    using Common = _detail::common_duration_t<duration<Rep1, Num1, Denom1>, duration<Rep2, Num2, Denom2>>;
+    return Common(lhs).count() == Common(rhs).count();
+}
+
+template <typename Rep1, uint64_t Num1, uint64_t Denom1, typename Rep2, uint64_t Num2, uint64_t Denom2>
+constexpr bool operator!=(const duration<Rep1, Num1, Denom1>& lhs, const duration<Rep2, Num2, Denom2>& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+template <typename Rep1, uint64_t Num1, uint64_t Denom1, typename Rep2, uint64_t Num2, uint64_t Denom2>
+constexpr bool operator<(const duration<Rep1, Num1, Denom1>& lhs, const duration<Rep2, Num2, Denom2>& rhs) noexcept {
+    using Common = _detail::common_duration_t<duration<Rep1, Num1, Denom1>, duration<Rep2, Num2, Denom2>>;
+    return Common(lhs).count() < Common(rhs).count();
+}
+
+template <typename Rep1, uint64_t Num1, uint64_t Denom1, typename Rep2, uint64_t Num2, uint64_t Denom2>
+constexpr bool operator>(const duration<Rep1, Num1, Denom1>& lhs, const duration<Rep2, Num2, Denom2>& rhs) noexcept {
+    return rhs < lhs;
+}
+
+template <typename Rep1, uint64_t Num1, uint64_t Denom1, typename Rep2, uint64_t Num2, uint64_t Denom2>
+constexpr bool operator<=(const duration<Rep1, Num1, Denom1>& lhs, const duration<Rep2, Num2, Denom2>& rhs) noexcept {
+    return !(rhs < lhs);
+}
+
+template <typename Rep1, uint64_t Num1, uint64_t Denom1, typename Rep2, uint64_t Num2, uint64_t Denom2>
+constexpr bool operator>=(const duration<Rep1, Num1, Denom1>& lhs, const duration<Rep2, Num2, Denom2>& rhs) noexcept {
+    return !(lhs < rhs);
+}
+
 using nanoseconds  = duration<int64_t, 1, 1'000'000'000>;
 using microseconds = duration<int64_t, 1, 1'000'000>;
 using milliseconds = duration<int64_t, 1, 1'000>;
@@ -85,51 +303,246 @@ using minutes      = duration<int64_t, 60, 1>;
 using hours        = duration<int64_t, 60*60, 1>;
 using days         = duration<int64_t, 60*60*24, 1>;
 using weeks        = duration<int64_t, 60*60*24*7, 1>;
-using years        = duration<int64_t, uint64_t(60*60*24*365.2425), 1>;
+using years        = duration<int64_t, 31'556'952, 1>; // 365.2425 days
 
-} // namespace
+// A point in time, measured as a duration since the epoch of Clock.
+template <typename Clock, typename Duration = typename Clock::duration>
+class time_point {
+public:
+    using clock = Clock;
+    using duration = Duration;
+    using rep = typename Duration::rep;
 
-namespace fav {
+    constexpr time_point() noexcept : _d(Duration::zero()) {}
+    constexpr explicit time_point(const Duration& d) noexcept : _d(d) {}
+
+    // Implicit conversion, only when no precision is lost.
+    template <typename Duration2,
+              typename ztd::enable_if<_detail::ratio_divide<Duration2::numerator, Duration2::denominator, Duration::numerator, Duration::denominator>::den == 1, int>::type = 0>
+    constexpr time_point(const time_point<Clock, Duration2>& t) noexcept : _d(t.time_since_epoch()) {}
+
+    constexpr Duration time_since_epoch() const noexcept {
+        return _d;
+    }
+
+    constexpr time_point& operator+=(const Duration& d) noexcept {
+        _d += d;
+        return *this;
+    }
 
-ztd::seconds FromKTime(const k_timeout_t& ktime) noexcept {
-    return ztd::seconds(ktime.ticks / SysClockTicksPerSecond);
+    constexpr time_point& operator-=(const Duration& d) noexcept {
+        _d -= d;
+        return *this;
+    }
+
+    static constexpr time_point min() noexcept { return time_point(Duration::min()); }
+    static constexpr time_point max() noexcept { return time_point(Duration::max()); }
+
+private:
+    Duration _d;
+};
+
+template <typename ToDuration, typename Clock, typename Duration>
+constexpr time_point<Clock, ToDuration> time_point_cast(const time_point<Clock, Duration>& t) noexcept {
+    return time_point<Clock, ToDuration>(duration_cast<ToDuration>(t.time_since_epoch()));
+}
+
+template <typename Clock, typename Duration1, typename Rep2, uint64_t Num2, uint64_t Denom2>
+constexpr auto operator+(const time_point<Clock, Duration1>& t, const duration<Rep2, Num2, Denom2>& d) noexcept {
+    using Common = _detail::common_duration_t<Duration1, duration<Rep2, Num2, Denom2>>;
+    return time_point<Clock, Common>(t.time_since_epoch() + d);
 }
 
-template <typename DurationType>
-k_timeout_t ToKTime(const DurationType&) noexcept {
-    static_assert(false, "Unsupported kernel time conversion.");
+template <typename Rep1, uint64_t Num1, uint64_t Denom1, typename Clock, typename Duration2>
+constexpr auto operator+(const duration<Rep1, Num1, Denom1>& d, const time_point<Clock, Duration2>& t) noexcept {
+    return t + d;
 }
 
-template <>
-k_timeout_t ToKTime<ztd::nanoseconds>(const ztd::nanoseconds& val) noexcept {
-    return K_NSEC(val.count());
+template <typename Clock, typename Duration1, typename Rep2, uint64_t Num2, uint64_t Denom2>
+constexpr auto operator-(const time_point<Clock, Duration1>& t, const duration<Rep2, Num2, Denom2>& d) noexcept {
+    using Common = _detail::common_duration_t<Duration1, duration<Rep2, Num2, Denom2>>;
+    return time_point<Clock, Common>(t.time_since_epoch() - d);
 }
 
-template <>
-k_timeout_t ToKTime<ztd::microseconds>(const ztd::microseconds& val) noexcept {
-    return K_USEC(val.count());
+template <typename Clock, typename Duration1, typename Duration2>
+constexpr auto operator-(const time_point<Clock, Duration1>& lhs, const time_point<Clock, Duration2>& rhs) noexcept {
+    return lhs.time_since_epoch() - rhs.time_since_epoch();
 }
 
-template <>
-k_timeout_t ToKTime<ztd::milliseconds>(const ztd::milliseconds& val) noexcept {
-    return K_MSEC(val.count());
+template <typename Clock, typename Duration1, typename Duration2>
+constexpr bool operator==(const time_point<Clock, Duration1>& lhs, const time_point<Clock, Duration2>& rhs) noexcept {
+    return lhs.time_since_epoch() == rhs.time_since_epoch();
 }
 
-template <>
-k_timeout_t ToKTime<ztd::seconds>(const ztd::seconds& val) noexcept {
-    return K_SECONDS(val.count());
+template <typename Clock, typename Duration1, typename Duration2>
+constexpr bool operator!=(const time_point<Clock, Duration1>& lhs, const time_point<Clock, Duration2>& rhs) noexcept {
+    return !(lhs == rhs);
 }
 
-template <>
-k_timeout_t ToKTime<ztd::minutes>(const ztd::minutes& val) noexcept {
-    return K_MINUTES(val.count());
+template <typename Clock, typename Duration1, typename Duration2>
+constexpr bool operator<(const time_point<Clock, Duration1>& lhs, const time_point<Clock, Duration2>& rhs) noexcept {
+    return lhs.time_since_epoch() < rhs.time_since_epoch();
 }
 
-template <>
-k_timeout_t ToKTime<ztd::hours>(const ztd::hours& val) noexcept {
-    return K_HOURS(val.count());
+template <typename Clock, typename Duration1, typename Duration2>
+constexpr bool operator>(const time_point<Clock, Duration1>& lhs, const time_point<Clock, Duration2>& rhs) noexcept {
+    return rhs < lhs;
+}
+
+template <typename Clock, typename Duration1, typename Duration2>
+constexpr bool operator<=(const time_point<Clock, Duration1>& lhs, const time_point<Clock, Duration2>& rhs) noexcept {
+    return !(rhs < lhs);
+}
+
+template <typename Clock, typename Duration1, typename Duration2>
+constexpr bool operator>=(const time_point<Clock, Duration1>& lhs, const time_point<Clock, Duration2>& rhs) noexcept {
+    return !(lhs < rhs);
+}
+
+// Monotonic clock counting kernel ticks since boot. Its time points can be handed to the kernel without loss.
+struct steady_clock {
+    using duration = ztd::duration<int64_t, 1, SysClockTicksPerSecond>;
+    using rep = duration::rep;
+    using time_point = ztd::time_point<steady_clock>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept {
+        return time_point(duration(k_uptime_ticks()));
+    }
+};
+
+#if defined(CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC)
+// Clock counting hardware cycles.
+// Without a 64-bit cycle counter (CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER) it is the 32-bit k_cycle_get_32(),
+// which wraps around every few seconds at typical clock rates; only differences between close time points are then meaningful.
+struct high_resolution_clock {
+#if defined(CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER)
+    using duration = ztd::duration<int64_t, 1, CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC>;
+#else
+    using duration = ztd::duration<uint32_t, 1, CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC>;
+#endif
+    using rep = duration::rep;
+    using time_point = ztd::time_point<high_resolution_clock>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept {
+#if defined(CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER)
+        return time_point(duration(static_cast<int64_t>(k_cycle_get_64())));
+#else
+        return time_point(duration(k_cycle_get_32()));
+#endif
+    }
+};
+#else
+using high_resolution_clock = steady_clock;
+#endif // defined(CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC)
+
+} // namespace
+
+namespace fav {
+
+// Kernel ticks, the unit of k_timeout_t.
+using Ticks = ztd::steady_clock::duration;
+
+// Converts a kernel timeout into any duration, truncating. K_FOREVER becomes DurationType::max().
+template <typename DurationType = ztd::seconds>
+DurationType FromKTime(const k_timeout_t& ktime) noexcept {
+    if (K_TIMEOUT_EQ(ktime, K_FOREVER)) {
+        return DurationType::max();
+    }
+    return ztd::duration_cast<DurationType>(Ticks(ktime.ticks));
+}
+
+namespace _detail {
+
+// Converts d to ToDuration, which must have an integral rep, rounding up. Negative durations become zero, and
+// durations longer than ToDuration::max() saturate to it rather than overflow.
+template <typename ToDuration, typename Rep, uint64_t Num, uint64_t Denom>
+ToDuration CeilSaturated(const ztd::duration<Rep, Num, Denom>& d) noexcept {
+    using ToRep = typename ToDuration::rep;
+    using Factor = ztd::_detail::ratio_divide<Num, Denom, ToDuration::numerator, ToDuration::denominator>;
+    constexpr uint64_t max_to = static_cast<uint64_t>(ToDuration::max().count());
+    // The longest count which converts to at most max_to, without overflowing count * Factor::num.
+    constexpr uint64_t max_count_by_to = (max_to <= UINT64_MAX / Factor::den) ? max_to * Factor::den / Factor::num
+                                                                              : UINT64_MAX / Factor::num;
+    constexpr uint64_t max_count = (max_count_by_to < UINT64_MAX / Factor::num) ? max_count_by_to
+                                                                                : UINT64_MAX / Factor::num;
+
+    if (d.count() <= Rep(0)) {
+        return ToDuration(0);
+    }
+    if constexpr (ztd::is_floating_point<Rep>::value) {
+        if (d.count() > static_cast<Rep>(max_count)) {
+            return ToDuration::max();
+        }
+        return ztd::ceil<ToDuration>(d);
+    } else {
+        if (static_cast<uint64_t>(d.count()) > max_count) {
+            return ToDuration::max();
+        }
+        const uint64_t scaled = static_cast<uint64_t>(d.count()) * Factor::num;
+        return ToDuration(static_cast<ToRep>(scaled / Factor::den + ((scaled % Factor::den != 0) ? 1 : 0)));
+    }
+}
+
+} // namespace
+
+// Converts any duration into a relative kernel timeout.
+// Rounds up to whole ticks, so that a wait never ends early. Zero or negative durations become K_NO_WAIT.
+// duration::max(), the inverse of FromKTime(K_FOREVER), and durations too long for k_ticks_t saturate to K_FOREVER
+// rather than overflow.
+template <typename Rep, uint64_t Num, uint64_t Denom>
+k_timeout_t ToKTime(const ztd::duration<Rep, Num, Denom>& d) noexcept {
+    using Factor = ztd::_detail::ratio_divide<Num, Denom, Ticks::numerator, Ticks::denominator>;
+    // The longest finite timeout. K_TICKS_FOREVER is -1, i.e. the maximum when k_ticks_t is unsigned.
+    constexpr uint64_t max_ticks = (k_ticks_t(-1) < k_ticks_t(0)) ? (uint64_t(1) << (sizeof(k_ticks_t) * 8 - 1)) - 1
+                                                                  : uint64_t(k_ticks_t(-1)) - 1;
+    // The longest count which converts to at most max_ticks, without overflowing count * Factor::num.
+    constexpr uint64_t max_count_by_ticks = (max_ticks <= UINT64_MAX / Factor::den)
+                                                ? max_ticks * Factor::den / Factor::num : UINT64_MAX / Factor::num;
+    constexpr uint64_t max_count = (max_count_by_ticks < UINT64_MAX / Factor::num) ? max_count_by_ticks
+                                                                                   : UINT64_MAX / Factor::num;
+
+    if (d.count() <= Rep(0)) {
+        return K_NO_WAIT;
+    }
+    if (d == ztd::duration<Rep, Num, Denom>::max()) {
+        return K_FOREVER;
+    }
+    if constexpr (ztd::is_floating_point<Rep>::value) {
+        if (d.count() > static_cast<Rep>(max_count)) {
+            return K_FOREVER;
+        }
+        return K_TICKS(ztd::ceil<Ticks>(d).count());
+    } else {
+        if (static_cast<uint64_t>(d.count()) > max_count) {
+            return K_FOREVER;
+        }
+        // Rounded up here, as ztd::ceil() compares in the common period, which may overflow for fine periods.
+        const uint64_t scaled = static_cast<uint64_t>(d.count()) * Factor::num;
+        return K_TICKS(static_cast<k_ticks_t>(scaled / Factor::den + ((scaled % Factor::den != 0) ? 1 : 0)));
+    }
+}
+
+// Converts a relative kernel timeout into an absolute deadline, in ticks since boot.
+// Waits which may wake up early (e.g. on a condition variable) can then be resumed with the remaining time.
+// K_FOREVER is represented by a negative deadline.
+inline int64_t ToDeadline(k_timeout_t timeout) noexcept {
+    if (K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+        return -1;
+    }
+    return k_uptime_ticks() + timeout.ticks;
+}
+
+// Returns the kernel timeout remaining until deadline. See ToDeadline().
+inline k_timeout_t FromDeadline(int64_t deadline) noexcept {
+    if (deadline < 0) {
+        return K_FOREVER;
+    }
+    const int64_t remaining = deadline - k_uptime_ticks();
+    return (remaining > 0) ? K_TICKS(remaining) : K_NO_WAIT;
 }
 
 } // namespace
 
-#endif // _FAVONIUS_CHRONO_HPP_
\ No newline at end of file
+#endif // _FAVONIUS_CHRONO_HPP_
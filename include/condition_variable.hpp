@@ -6,45 +6,139 @@
 
 #include <kernel.h>
 
+#include "chrono.hpp"
 #include "mutex.hpp"
 
 namespace ztd {
 
+enum class cv_status {
+    no_timeout,
+    timeout
+};
+
+// When CONFIG_FAVONIUS_FUTEX_MUTEX is enabled, ztd::mutex has no k_mutex to hand to k_condvar_wait.
+// The condition variable is then a futex holding a sequence number: waiters sleep on the value they observed
+// before releasing the lock, and notifiers bump the sequence before waking, so no notification can be lost.
 class condition_variable {
 public:
     condition_variable() noexcept {
+#if defined(CONFIG_FAVONIUS_FUTEX_MUTEX)
+        atomic_clear(&_futex.val);
+#else
         [[maybe_unused]]int ec = k_condvar_init(&_condvar);
+#endif
     }
     condition_variable(const condition_variable&) = delete;
 
     void notify_one() noexcept {
+#if defined(CONFIG_FAVONIUS_FUTEX_MUTEX)
+        atomic_inc(&_futex.val);
+        [[maybe_unused]]int woken_threads = k_futex_wake(&_futex, false);
+#else
         [[maybe_unused]]int ec = k_condvar_signal(&_condvar);
+#endif
     }
 
     void notify_all() noexcept {
+#if defined(CONFIG_FAVONIUS_FUTEX_MUTEX)
+        atomic_inc(&_futex.val);
+        [[maybe_unused]]int woken_threads = k_futex_wake(&_futex, true);
+#else
         [[maybe_unused]]int woken_threads = k_condvar_broadcast(&_condvar);
+#endif
+    }
+
+    // Non-std extension: wakes up to count waiting threads, e.g. one per item a producer has just queued.
+    void NotifyN(uint32_t count) noexcept {
+#if defined(CONFIG_FAVONIUS_FUTEX_MUTEX)
+        atomic_inc(&_futex.val);
+        while (count > 0 && k_futex_wake(&_futex, false) > 0) {
+            count--;
+        }
+#else
+        while (count > 0) {
+            [[maybe_unused]]int ec = k_condvar_signal(&_condvar);
+            count--;
+        }
+#endif
     }
 
+    // Blocks until notified. May wake up spuriously.
     void wait(ztd::unique_lock<ztd::mutex>& lock) noexcept {
-        k_condvar_wait(&_condvar, lock.mutex()->native_handle(), K_FOREVER);
+        _Wait(lock, K_FOREVER);
+    }
+
+    // Blocks until stop_waiting() returns true. Spurious wakeups are handled here.
+    template <typename Predicate>
+    void wait(ztd::unique_lock<ztd::mutex>& lock, Predicate stop_waiting) noexcept {
+        while (!stop_waiting()) {
+            _Wait(lock, K_FOREVER);
+        }
+    }
+
+    // Blocks until notified or until rel_time has elapsed. May wake up spuriously.
+    template <typename Rep, uint64_t Num, uint64_t Denom>
+    cv_status wait_for(ztd::unique_lock<ztd::mutex>& lock, const ztd::duration<Rep, Num, Denom>& rel_time) noexcept {
+        return _Wait(lock, fav::ToKTime(rel_time)) ? cv_status::no_timeout : cv_status::timeout;
     }
 
-    // Not available for now until I figure out how to avoid busy waiting since API does not support waiting on predicate.
-    //template <typename Predicate>
-    //void wait(ztd::unique_lock<ztd::mutex>& lock, Predicate stop_waiting) noexcept {
-    //    k_condvar_wait(&_condvar, lock.mutex()->native_handle(), K_FOREVER);
-    //}
+    // Blocks until stop_waiting() returns true or until rel_time has elapsed.
+    // Returns the final result of stop_waiting(), i.e. false only on timeout.
+    template <typename Rep, uint64_t Num, uint64_t Denom, typename Predicate>
+    bool wait_for(ztd::unique_lock<ztd::mutex>& lock, const ztd::duration<Rep, Num, Denom>& rel_time, Predicate stop_waiting) noexcept {
+        const int64_t deadline = fav::ToDeadline(fav::ToKTime(rel_time));
+        while (!stop_waiting()) {
+            if (!_Wait(lock, fav::FromDeadline(deadline))) {
+                return stop_waiting();
+            }
+        }
+        return true;
+    }
+
+    // Blocks until notified or until timeout_time has been reached. May wake up spuriously.
+    // TimePoint is any type whose clock provides now(), such that timeout_time - now() is a ztd::duration.
+    template <typename TimePoint>
+    cv_status wait_until(ztd::unique_lock<ztd::mutex>& lock, const TimePoint& timeout_time) noexcept {
+        return wait_for(lock, timeout_time - TimePoint::clock::now());
+    }
 
-    bool wait_for(ztd::unique_lock<ztd::mutex>& lock, uint64_t timeout_ms) noexcept {
-        k_condvar_wait(&_condvar, lock.mutex()->native_handle(), K_MSEC(timeout_ms));
+    // Blocks until stop_waiting() returns true or until timeout_time has been reached.
+    // Returns the final result of stop_waiting(), i.e. false only on timeout.
+    template <typename TimePoint, typename Predicate>
+    bool wait_until(ztd::unique_lock<ztd::mutex>& lock, const TimePoint& timeout_time, Predicate stop_waiting) noexcept {
+        return wait_for(lock, timeout_time - TimePoint::clock::now(), ztd::move(stop_waiting));
     }
 
+#if defined(CONFIG_FAVONIUS_FUTEX_MUTEX)
+    k_futex* native_handle() noexcept {
+        return &_futex;
+    }
+#else
     k_condvar* native_handle() noexcept {
         return &_condvar;
     }
+#endif
 
 private:
+#if defined(CONFIG_FAVONIUS_FUTEX_MUTEX)
+    struct k_futex _futex;
+
+    // Returns false on timeout.
+    bool _Wait(ztd::unique_lock<ztd::mutex>& lock, k_timeout_t timeout) noexcept {
+        const atomic_val_t sequence = atomic_get(&_futex.val);
+        lock.unlock();
+        int ec = k_futex_wait(&_futex, sequence, timeout);
+        lock.lock();
+        return ec != -ETIMEDOUT;
+    }
+#else
     struct k_condvar _condvar;
+
+    // Returns false on timeout.
+    bool _Wait(ztd::unique_lock<ztd::mutex>& lock, k_timeout_t timeout) noexcept {
+        return k_condvar_wait(&_condvar, lock.mutex()->native_handle(), timeout) == 0;
+    }
+#endif
 };
 
 } // namespace
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_FUNCTIONAL_HPP_
+#define _FAVONIUS_FUNCTIONAL_HPP_
+
+#include "utility.hpp"
+
+#if defined(FAVONIUS_ALLOW_STD_HEADERS)
+#if FAVONIUS_ALLOW_STD_HEADERS
+
+#include <functional>
+
+namespace ztd = std;
+
+#else
+
+// The comparison function objects of <functional>.
+// See https://en.cppreference.com/w/cpp/utility/functional
+
+namespace ztd {
+
+template <typename T = void>
+struct less {
+    constexpr bool operator()(const T& lhs, const T& rhs) const { return lhs < rhs; }
+};
+
+template <typename T = void>
+struct greater {
+    constexpr bool operator()(const T& lhs, const T& rhs) const { return lhs > rhs; }
+};
+
+template <typename T = void>
+struct equal_to {
+    constexpr bool operator()(const T& lhs, const T& rhs) const { return lhs == rhs; }
+};
+
+// Transparent versions, which deduce the argument types.
+
+template <>
+struct less<void> {
+    template <typename T, typename U>
+    constexpr auto operator()(T&& lhs, U&& rhs) const -> decltype(ztd::forward<T>(lhs) < ztd::forward<U>(rhs)) {
+        return ztd::forward<T>(lhs) < ztd::forward<U>(rhs);
+    }
+};
+
+template <>
+struct greater<void> {
+    template <typename T, typename U>
+    constexpr auto operator()(T&& lhs, U&& rhs) const -> decltype(ztd::forward<T>(lhs) > ztd::forward<U>(rhs)) {
+        return ztd::forward<T>(lhs) > ztd::forward<U>(rhs);
+    }
+};
+
+template <>
+struct equal_to<void> {
+    template <typename T, typename U>
+    constexpr auto operator()(T&& lhs, U&& rhs) const -> decltype(ztd::forward<T>(lhs) == ztd::forward<U>(rhs)) {
+        return ztd::forward<T>(lhs) == ztd::forward<U>(rhs);
+    }
+};
+
+} // namespace
+
+#endif // FAVONIUS_ALLOW_STD_HEADERS
+#endif // FAVONIUS_ALLOW_STD_HEADERS
+
+#endif // _FAVONIUS_FUNCTIONAL_HPP_
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_FUTEX_HPP_
+#define _FAVONIUS_FUTEX_HPP_
+
+#include <kernel.h>
+
+namespace fav {
+
+// A word which threads can sleep on until it changes.
+// Callers manipulate the word directly with the Zephyr atomic_* functions, and only call Wait() / Wake*() on the slow path.
+// With CONFIG_USERSPACE this is a k_futex, so the word lives in user memory and must be statically allocated like any
+// other kernel object. Without it (k_futex is unavailable), sleeping is emulated with a k_spinlock and a k_sem.
+// Either way, WakeOne() and WakeAll() may be called from an ISR.
+class Futex final {
+public:
+    explicit Futex(atomic_val_t value = 0) noexcept;
+    Futex(const Futex&) = delete;
+    Futex(Futex&&) = delete;
+
+    atomic_t* Word() noexcept {
+#if defined(CONFIG_USERSPACE)
+        return &_futex.val;
+#else
+        return &_word;
+#endif
+    }
+
+    atomic_val_t Load() const noexcept {
+#if defined(CONFIG_USERSPACE)
+        return atomic_get(&_futex.val);
+#else
+        return atomic_get(&_word);
+#endif
+    }
+
+    // Blocks while the word holds expected, or until timeout has elapsed.
+    // May return spuriously; callers must re-check their own condition.
+    // Returns false on timeout.
+    bool Wait(atomic_val_t expected, k_timeout_t timeout = K_FOREVER) noexcept;
+
+    // Wakes one thread blocked in Wait(). The word must be modified beforehand.
+    void WakeOne() noexcept;
+
+    // Wakes all threads blocked in Wait(). The word must be modified beforehand.
+    void WakeAll() noexcept;
+
+private:
+#if defined(CONFIG_USERSPACE)
+    struct k_futex _futex;
+#else
+    atomic_t _word;
+    struct k_spinlock _lock;
+    uint32_t _sleepers; // Threads in Wait() which no waker has counted as woken yet. Guarded by _lock.
+    struct k_sem _wakeups;
+#endif
+};
+
+} // namespace
+
+#endif // _FAVONIUS_FUTEX_HPP_
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_INPLACEFUNCTION_HPP_
+#define _FAVONIUS_INPLACEFUNCTION_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "new.hpp"
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+namespace fav {
+
+template <typename Signature, size_t Capacity = 4 * sizeof(void*)>
+class InplaceFunction;
+
+namespace _detail {
+
+template <typename T>
+struct IsInplaceFunction : ztd::false_type {};
+
+template <typename Signature, size_t Capacity>
+struct IsInplaceFunction<InplaceFunction<Signature, Capacity>> : ztd::true_type {};
+
+} // namespace
+
+// Type-erased callable, like std::function, which stores the callable inside itself instead of on the heap.
+// A callable larger than Capacity bytes, or aligned to more than a long long, is a compile-time error.
+// Calling is a single indirect call. Moving and destroying the callable go through a second function pointer,
+// which is null for trivially copyable callables (function pointers and lambdas capturing only such values),
+// whose bytes are simply copied.
+// It is move-only, so callables which cannot be copied (e.g. which capture a ztd::unique_ptr) can be stored.
+// Calling an empty InplaceFunction is undefined; check it with operator bool first.
+template <typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> final {
+public:
+    static constexpr size_t Alignment = alignof(long long);
+
+    constexpr InplaceFunction() noexcept : _invoke(nullptr), _manage(nullptr) {}
+    constexpr InplaceFunction(decltype(nullptr)) noexcept : InplaceFunction() {}
+
+    template <typename F, typename Callable = ztd::decay_t<F>,
+              typename = ztd::enable_if_t<!_detail::IsInplaceFunction<Callable>::value>>
+    InplaceFunction(F&& fn) noexcept : _invoke(&_Invoke<Callable>), _manage(_Manager<Callable>()) {
+        static_assert(sizeof(Callable) <= Capacity, "The callable does not fit; increase the Capacity of InplaceFunction.");
+        static_assert(Alignment % alignof(Callable) == 0, "The callable is over-aligned for InplaceFunction.");
+        new (_storage) Callable(ztd::forward<F>(fn));
+    }
+
+    InplaceFunction(InplaceFunction&& other) noexcept : _invoke(other._invoke), _manage(other._manage) {
+        _MoveFrom(other);
+    }
+
+    InplaceFunction(const InplaceFunction&) = delete;
+    InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+    ~InplaceFunction() noexcept { _Destroy(); }
+
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+        if (this != &other) {
+            _Destroy();
+            _invoke = other._invoke;
+            _manage = other._manage;
+            _MoveFrom(other);
+        }
+        return *this;
+    }
+
+    InplaceFunction& operator=(decltype(nullptr)) noexcept {
+        _Destroy();
+        return *this;
+    }
+
+    template <typename F, typename Callable = ztd::decay_t<F>,
+              typename = ztd::enable_if_t<!_detail::IsInplaceFunction<Callable>::value>>
+    InplaceFunction& operator=(F&& fn) noexcept {
+        return *this = InplaceFunction(ztd::forward<F>(fn));
+    }
+
+    explicit operator bool() const noexcept { return _invoke != nullptr; }
+
+    R operator()(Args... args) noexcept {
+        return _invoke(_storage, ztd::forward<Args>(args)...);
+    }
+
+private:
+    enum class Operation {
+        Move,
+        Destroy,
+    };
+
+    using InvokeFunction = R (*)(void* callable, Args&&... args);
+    // Moves src into dst and destroys src, or destroys dst.
+    using ManageFunction = void (*)(Operation op, void* dst, void* src);
+
+    alignas(Alignment) uint8_t _storage[Capacity];
+    InvokeFunction _invoke;
+    ManageFunction _manage;
+
+    template <typename Callable>
+    static R _Invoke(void* callable, Args&&... args) noexcept {
+        return (*static_cast<Callable*>(callable))(ztd::forward<Args>(args)...);
+    }
+
+    template <typename Callable>
+    static void _Manage(Operation op, void* dst, void* src) noexcept {
+        if (op == Operation::Move) {
+            new (dst) Callable(ztd::move(*static_cast<Callable*>(src)));
+            static_cast<Callable*>(src)->~Callable();
+        } else {
+            static_cast<Callable*>(dst)->~Callable();
+        }
+    }
+
+    template <typename Callable>
+    static constexpr ManageFunction _Manager() noexcept {
+        return ztd::is_trivially_copyable<Callable>::value ? nullptr : &_Manage<Callable>;
+    }
+
+    // _invoke and _manage have already been taken from other.
+    void _MoveFrom(InplaceFunction& other) noexcept {
+        if (_manage != nullptr) {
+            _manage(Operation::Move, _storage, other._storage);
+        } else if (_invoke != nullptr) {
+            __builtin_memcpy(_storage, other._storage, Capacity);
+        }
+        other._invoke = nullptr;
+        other._manage = nullptr;
+    }
+
+    void _Destroy() noexcept {
+        if (_manage != nullptr) {
+            _manage(Operation::Destroy, _storage, nullptr);
+        }
+        _invoke = nullptr;
+        _manage = nullptr;
+    }
+};
+
+} // namespace
+
+#endif // _FAVONIUS_INPLACEFUNCTION_HPP_
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_INTRUSIVEPTR_HPP_
+#define _FAVONIUS_INTRUSIVEPTR_HPP_
+
+#include "atomic.hpp"
+#include "memory.hpp"
+#include "utility.hpp"
+
+namespace fav {
+
+// Base of objects which count their own references, for IntrusivePtr.
+// The count lives in the object, so however the object was allocated (the global heap, a ztd::allocator, a static
+// pool...) there is no second allocation, and an IntrusivePtr is the size of a pointer.
+// When the last reference goes, the object is destroyed with Deleter, which must be default-constructible:
+// e.g. ztd::default_delete for the global heap, or a deleter which returns the object to a pool.
+// References may be taken and dropped concurrently from different threads, with the same memory ordering as
+// ztd::shared_ptr. A new object has no references.
+template <typename Derived, typename Deleter = ztd::default_delete<Derived>>
+class RefCounted {
+public:
+    // The number of references, which is approximate when other threads hold some.
+    uint32_t UseCount() const noexcept { return _uses.load(ztd::memory_order_relaxed); }
+
+    friend void IntrusiveAddRef(const RefCounted* object) noexcept {
+        object->_uses.fetch_add(1, ztd::memory_order_relaxed);
+    }
+
+    friend void IntrusiveRelease(const RefCounted* object) noexcept {
+        if (object->_uses.fetch_sub(1, ztd::memory_order_acq_rel) == 1) {
+            Deleter()(static_cast<Derived*>(const_cast<RefCounted*>(object)));
+        }
+    }
+
+protected:
+    constexpr RefCounted() noexcept : _uses(0) {}
+    // A copy of the object is a different object, without references.
+    constexpr RefCounted(const RefCounted&) noexcept : _uses(0) {}
+    RefCounted& operator=(const RefCounted&) noexcept { return *this; }
+    ~RefCounted() = default;
+
+private:
+    mutable ztd::atomic<uint32_t> _uses;
+};
+
+// Shares ownership of an object of type T which counts its own references: IntrusiveAddRef(T*) and
+// IntrusiveRelease(T*) must be found by argument-dependent lookup, e.g. by deriving T from RefCounted.
+// Because the count is in the object, an IntrusivePtr can also be made again from a raw pointer, e.g. `this`.
+template <typename T>
+class IntrusivePtr final {
+public:
+    using ElementType = T;
+
+    constexpr IntrusivePtr() noexcept : _ptr(nullptr) {}
+    constexpr IntrusivePtr(decltype(nullptr)) noexcept : _ptr(nullptr) {}
+
+    // Takes a reference to object, unless addRef is false, in which case one that is already held is adopted.
+    IntrusivePtr(T* object, bool addRef = true) noexcept : _ptr(object) {
+        if (_ptr != nullptr && addRef) {
+            IntrusiveAddRef(_ptr);
+        }
+    }
+
+    IntrusivePtr(const IntrusivePtr& other) noexcept : IntrusivePtr(other._ptr) {}
+    IntrusivePtr(IntrusivePtr&& other) noexcept : _ptr(other.Detach()) {}
+
+    template <typename U, typename = ztd::enable_if_t<ztd::is_convertible<U*, T*>::value>>
+    IntrusivePtr(const IntrusivePtr<U>& other) noexcept : IntrusivePtr(other.Get()) {}
+
+    template <typename U, typename = ztd::enable_if_t<ztd::is_convertible<U*, T*>::value>>
+    IntrusivePtr(IntrusivePtr<U>&& other) noexcept : _ptr(other.Detach()) {}
+
+    ~IntrusivePtr() noexcept { Reset(); }
+
+    // Takes other by value, which covers both copy and move assignment.
+    IntrusivePtr& operator=(IntrusivePtr other) noexcept {
+        Swap(other);
+        return *this;
+    }
+
+    void Reset() noexcept {
+        if (_ptr != nullptr) {
+            IntrusiveRelease(_ptr);
+            _ptr = nullptr;
+        }
+    }
+
+    // Gives up the reference without dropping it, e.g. to pass the object through a C API.
+    // Adopt it again with IntrusivePtr(object, false).
+    T* Detach() noexcept {
+        T* object = _ptr;
+        _ptr = nullptr;
+        return object;
+    }
+
+    void Swap(IntrusivePtr& other) noexcept { ztd::swap(_ptr, other._ptr); }
+
+    T* Get() const noexcept { return _ptr; }
+    T& operator*() const noexcept { return *_ptr; }
+    T* operator->() const noexcept { return _ptr; }
+    explicit operator bool() const noexcept { return _ptr != nullptr; }
+
+private:
+    T* _ptr;
+};
+
+template <typename T, typename U>
+bool operator==(const IntrusivePtr<T>& lhs, const IntrusivePtr<U>& rhs) noexcept { return lhs.Get() == rhs.Get(); }
+
+template <typename T, typename U>
+bool operator!=(const IntrusivePtr<T>& lhs, const IntrusivePtr<U>& rhs) noexcept { return lhs.Get() != rhs.Get(); }
+
+template <typename T>
+bool operator==(const IntrusivePtr<T>& lhs, decltype(nullptr)) noexcept { return !lhs; }
+
+template <typename T>
+bool operator!=(const IntrusivePtr<T>& lhs, decltype(nullptr)) noexcept { return static_cast<bool>(lhs); }
+
+// Constructs T on the global heap. The result is empty if the allocation failed.
+template <typename T, typename... Args>
+IntrusivePtr<T> MakeIntrusive(Args&&... args) noexcept {
+    return IntrusivePtr<T>(new T(ztd::forward<Args>(args)...));
+}
+
+} // namespace
+
+#endif // _FAVONIUS_INTRUSIVEPTR_HPP_
@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_LATCH_HPP_
+#define _FAVONIUS_LATCH_HPP_
+
+#include <kernel.h>
+
+#include "futex.hpp"
+
+// This header implements the C++20 latch.
+// See https://en.cppreference.com/w/cpp/thread/latch
+
+namespace ztd {
+
+// Single-use downward counter. Threads block in wait() until the counter reaches zero.
+// Counting down is one atomic operation; only the thread which brings the counter to zero enters the kernel,
+// to wake up the waiters.
+class latch final {
+public:
+    constexpr static ptrdiff_t max() noexcept {
+        return static_cast<ptrdiff_t>(~0UL >> 1);
+    }
+
+    explicit latch(ptrdiff_t expected) noexcept : _counter(expected) {}
+    latch(const latch&) = delete;
+    latch& operator=(const latch&) = delete;
+
+    // Decrements the counter by n, without blocking.
+    void count_down(ptrdiff_t n = 1) noexcept {
+        if (atomic_sub(_counter.Word(), n) == n) {
+            _counter.WakeAll();
+        }
+    }
+
+    // Returns true if the counter has reached zero. Never blocks.
+    bool try_wait() const noexcept {
+        return _counter.Load() == 0;
+    }
+
+    // Blocks until the counter reaches zero.
+    void wait() const noexcept {
+        atomic_val_t count;
+        while ((count = _counter.Load()) != 0) {
+            _counter.Wait(count);
+        }
+    }
+
+    // Decrements the counter by n, then blocks until it reaches zero.
+    void arrive_and_wait(ptrdiff_t n = 1) noexcept {
+        count_down(n);
+        wait();
+    }
+
+private:
+    mutable fav::Futex _counter;
+};
+
+} // namespace
+
+#endif // _FAVONIUS_LATCH_HPP_
@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_LATENCY_HPP_
+#define _FAVONIUS_LATENCY_HPP_
+
+#include <sys/slist.h>
+#include <kernel.h>
+
+#include "atomic.hpp"
+#include "chrono.hpp"
+#include "registry.hpp"
+
+// Latency instrumentation for hot paths.
+// Stopwatch is always available. LatencyHistogram and ScopedLatency are compiled in with CONFIG_FAVONIUS_LATENCY_PROBES;
+// when disabled they keep their interface but are empty and do nothing, so probes may be left in production code.
+// All times are in hardware cycles (k_cycle_get_32), so measured intervals must be shorter than one
+// wrap-around of the cycle counter.
+
+namespace fav {
+
+// Measures elapsed time with the hardware cycle counter.
+class Stopwatch final {
+public:
+    // Starts running on construction.
+    Stopwatch() noexcept : _start(k_cycle_get_32()) {}
+
+    void Restart() noexcept { _start = k_cycle_get_32(); }
+
+    uint32_t ElapsedCycles() const noexcept { return k_cycle_get_32() - _start; }
+
+    // Returns the elapsed cycles and restarts the stopwatch, so that consecutive laps do not lose any time.
+    uint32_t Lap() noexcept {
+        const uint32_t now = k_cycle_get_32();
+        const uint32_t elapsed = now - _start;
+        _start = now;
+        return elapsed;
+    }
+
+    // Elapsed time converted to any duration, truncated.
+    template <typename DurationType = ztd::microseconds>
+    DurationType Elapsed() const noexcept {
+        return ztd::duration_cast<DurationType>(ztd::nanoseconds(static_cast<int64_t>(k_cyc_to_ns_floor64(ElapsedCycles()))));
+    }
+
+private:
+    uint32_t _start;
+};
+
+#if defined(CONFIG_FAVONIUS_LATENCY_PROBES)
+
+// Histogram of latencies in cycles, with one bucket per power of two.
+// Bucket 0 counts zero-cycle samples, and bucket i > 0 counts samples in [2^(i-1), 2^i).
+// Record() is lock-free and may be called from any thread or ISR. Readers see a snapshot that is only approximately
+// consistent while samples are being recorded, which is fine for statistics.
+class LatencyHistogram final {
+public:
+    static constexpr size_t BucketCount = 33;
+
+    // Registers this histogram with the global registry, see ForEach(). Histograms must therefore be created and
+    // destroyed in supervisor mode.
+    explicit LatencyHistogram(const char* name = nullptr) noexcept;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram(LatencyHistogram&&) = delete;
+    ~LatencyHistogram() noexcept;
+
+    const char* Name() const noexcept { return (_name != nullptr) ? _name : "(unnamed)"; }
+    // The string is not copied and must outlive the histogram.
+    void SetName(const char* name) noexcept { _name = name; }
+
+    void Record(uint32_t cycles) noexcept {
+        _buckets[_BucketOf(cycles)].fetch_add(1, ztd::memory_order_relaxed);
+        _count.fetch_add(1, ztd::memory_order_relaxed);
+        uint32_t current = _min.load(ztd::memory_order_relaxed);
+        while (cycles < current && !_min.compare_exchange_weak(current, cycles, ztd::memory_order_relaxed)) {}
+        current = _max.load(ztd::memory_order_relaxed);
+        while (cycles > current && !_max.compare_exchange_weak(current, cycles, ztd::memory_order_relaxed)) {}
+    }
+
+    uint32_t Count() const noexcept { return _count.load(ztd::memory_order_relaxed); }
+    // Zero if nothing was recorded.
+    uint32_t Min() const noexcept { return (Count() != 0) ? _min.load(ztd::memory_order_relaxed) : 0; }
+    uint32_t Max() const noexcept { return _max.load(ztd::memory_order_relaxed); }
+    uint32_t Bucket(size_t index) const noexcept { return _buckets[index].load(ztd::memory_order_relaxed); }
+
+    // Upper bound of the bucket holding the requested percentile, e.g. Percentile(99) or Percentile(999, 1000).
+    // The result is never larger than Max(). Zero if nothing was recorded.
+    uint32_t Percentile(uint32_t numerator, uint32_t denominator = 100) const noexcept;
+
+    void Reset() noexcept;
+
+    // Prints the statistics and the non-empty buckets with printk.
+    void Dump() const noexcept;
+
+    // Calls fn for every registered histogram. Histograms must not be created or destroyed from within fn.
+    static void ForEach(void (*fn)(const LatencyHistogram& histogram, void* user_data), void* user_data) noexcept;
+
+    // Resets all registered histograms.
+    static void ResetAll() noexcept;
+
+private:
+    sys_snode_t _node;
+    const char* _name;
+    ztd::atomic<uint32_t> _count;
+    ztd::atomic<uint32_t> _min;
+    ztd::atomic<uint32_t> _max;
+    ztd::atomic<uint32_t> _buckets[BucketCount];
+
+    static size_t _BucketOf(uint32_t cycles) noexcept {
+        return (cycles == 0) ? 0 : 32 - __builtin_clz(cycles);
+    }
+};
+
+// Records the lifetime of the probe into a histogram.
+//  static fav::LatencyHistogram isr_latency("isr");
+//  void isr() { fav::ScopedLatency probe(isr_latency); ... }
+template <typename Histogram>
+class ScopedLatency final {
+public:
+    explicit ScopedLatency(Histogram& histogram) noexcept : _histogram(histogram), _start(k_cycle_get_32()) {}
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency(ScopedLatency&&) = delete;
+    ~ScopedLatency() noexcept { _histogram.Record(k_cycle_get_32() - _start); }
+
+private:
+    Histogram& _histogram;
+    uint32_t _start;
+};
+
+#else
+
+class LatencyHistogram final {
+public:
+    static constexpr size_t BucketCount = 33;
+
+    explicit constexpr LatencyHistogram([[maybe_unused]] const char* name = nullptr) noexcept {}
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram(LatencyHistogram&&) = delete;
+
+    const char* Name() const noexcept { return "(disabled)"; }
+    void SetName([[maybe_unused]] const char* name) noexcept {}
+    void Record([[maybe_unused]] uint32_t cycles) noexcept {}
+    uint32_t Count() const noexcept { return 0; }
+    uint32_t Min() const noexcept { return 0; }
+    uint32_t Max() const noexcept { return 0; }
+    uint32_t Bucket([[maybe_unused]] size_t index) const noexcept { return 0; }
+    uint32_t Percentile([[maybe_unused]] uint32_t numerator,
+                        [[maybe_unused]] uint32_t denominator = 100) const noexcept { return 0; }
+    void Reset() noexcept {}
+    void Dump() const noexcept {}
+    static void ForEach([[maybe_unused]] void (*fn)(const LatencyHistogram& histogram, void* user_data),
+                        [[maybe_unused]] void* user_data) noexcept {}
+    static void ResetAll() noexcept {}
+};
+
+template <typename Histogram>
+class ScopedLatency final {
+public:
+    explicit ScopedLatency([[maybe_unused]] Histogram& histogram) noexcept {}
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency(ScopedLatency&&) = delete;
+};
+
+#endif // defined(CONFIG_FAVONIUS_LATENCY_PROBES)
+
+} // namespace
+
+#endif // _FAVONIUS_LATENCY_HPP_
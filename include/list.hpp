@@ -8,6 +8,7 @@
 #include <kernel.h>
 
 #include "memory.hpp"
+#include "trace.hpp"
 
 namespace fav {
 
@@ -16,17 +17,24 @@ namespace fav {
 // If HeapSize is 0, then memory will be allocated from the global system heap (CONFIG_HEAP_MEM_POOL_SIZE)
 // Upon allocation failure, member functions that allocate will return false.
 // Member functions are NOT thread safe.
+// With CONFIG_FAVONIUS_TRACING, pushes and pops are traced with the length of the list.
 template <typename T, size_t HeapSize = 0, template<typename, size_t> typename Allocator = ztd::allocator>
-class List final {
+class List final : public Traceable {
 private:
     struct Node;
-    using NodeType = typename List<T>::Node;
+    using NodeType = Node;
 public:
     using ValueType = T;
     using AllocatorType = Allocator<NodeType, HeapSize>;
 
     List() noexcept : _alloc() { sys_dlist_init(&_list); }
 
+    // Names this list, and its allocator if it can be named, in trace events. The string is not copied.
+    void SetName(const char* name) noexcept {
+        Traceable::SetName(name);
+        _detail::SetTraceName(_alloc, name, 0);
+    }
+
     bool Empty() noexcept {
         return sys_dlist_is_empty(&_list);
     }
@@ -84,6 +92,7 @@ public:
         NodeType* node = _AllocateNode();
         node->value = ztd::move(value);
         sys_dlist_append(&_list, &node->dnode);
+        _TracePush();
         return node->value;
     }
 
@@ -100,6 +109,7 @@ public:
         NodeType* node = _AllocateNode();
         node->value = val;
         sys_dlist_append(&_list, &node->dnode);
+        _TracePush();
     }
 
     // Move-constructs T at the front of the list.
@@ -107,6 +117,7 @@ public:
         NodeType* node = _AllocateNode();
         node->value = ztd::move(value);
         sys_dlist_prepend(&_list, &node->dnode);
+        _TracePush();
         return node->value;
     }
 
@@ -123,6 +134,7 @@ public:
         NodeType* node = _AllocateNode();
         node->value = val;
         sys_dlist_prepend(&_list, &node->dnode);
+        _TracePush();
     }
 
     // Removes and returns the first entry of the list.
@@ -131,6 +143,7 @@ public:
         T value = ztd::move(node->value);
         sys_dlist_remove(_list.head);
         _DeallocateNode(node);
+        _TracePop();
         return value;
     }
 
@@ -140,6 +153,7 @@ public:
         T value = ztd::move(node->value);
         sys_dlist_remove(_list.tail);
         _DeallocateNode(node);
+        _TracePop();
         return value;
     }
 
@@ -260,6 +274,18 @@ private:
     constexpr void _DeallocateNode(NodeType* ptr) noexcept {
         _alloc.deallocate(ptr, 1);
     }
+
+    void _TracePush() const noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::QueuePush(this, Name(), Size(), 0);
+#endif
+    }
+
+    void _TracePop() const noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::QueuePop(this, Name(), Size(), 0);
+#endif
+    }
 };
 
 } // namespace
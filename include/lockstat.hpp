@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_LOCKSTAT_HPP_
+#define _FAVONIUS_LOCKSTAT_HPP_
+
+#include <sys/slist.h>
+#include <kernel.h>
+
+#include "atomic.hpp"
+#include "registry.hpp"
+
+// Lock contention statistics, compiled in with CONFIG_FAVONIUS_LOCK_PROFILING.
+// ztd::mutex, ztd::timed_mutex, fav::FutexMutex and ztd::counting_semaphore each embed a LockStats when enabled.
+// All times are in hardware cycles (k_cycle_get_32), so individual waits and holds must be shorter than one
+// wrap-around of the cycle counter to be measured correctly.
+// Profiled locks register themselves in a list for ForEach(), so they must be created and destroyed in supervisor mode.
+
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+
+namespace fav {
+
+class LockStats final {
+public:
+    // Registers these statistics with the global registry, see ForEach().
+    explicit LockStats(const char* name = nullptr) noexcept;
+    LockStats(const LockStats&) = delete;
+    LockStats(LockStats&&) = delete;
+    ~LockStats() noexcept;
+
+    const char* Name() const noexcept { return (_name != nullptr) ? _name : "(unnamed)"; }
+    // The string is not copied and must outlive the lock.
+    void SetName(const char* name) noexcept { _name = name; }
+
+    // Records a successful acquisition which began at start_cycles.
+    // Returns the current cycle count, which the caller may keep to later pass to RecordRelease().
+    uint32_t RecordAcquisition(uint32_t start_cycles, bool contended) noexcept {
+        const uint32_t now = k_cycle_get_32();
+        const uint32_t waited = now - start_cycles;
+        _acquisitions.fetch_add(1, ztd::memory_order_relaxed);
+        if (contended) {
+            _contentions.fetch_add(1, ztd::memory_order_relaxed);
+        }
+        // A 64-bit atomic is not lock-free on 32-bit targets, so the total is kept in two words, carrying by hand.
+        if (_total_wait_low.fetch_add(waited, ztd::memory_order_relaxed) > UINT32_MAX - waited) {
+            _total_wait_high.fetch_add(1, ztd::memory_order_relaxed);
+        }
+        _UpdateMax(_max_wait, waited);
+        return now;
+    }
+
+    // Records an attempt which failed because the lock was not available (try_lock or timeout).
+    void RecordFailedAttempt() noexcept {
+        _contentions.fetch_add(1, ztd::memory_order_relaxed);
+    }
+
+    // Records the release of a lock acquired at acquired_cycles.
+    void RecordRelease(uint32_t acquired_cycles) noexcept {
+        _UpdateMax(_max_hold, k_cycle_get_32() - acquired_cycles);
+    }
+
+    uint32_t Acquisitions() const noexcept { return _acquisitions.load(ztd::memory_order_relaxed); }
+    // Includes failed attempts.
+    uint32_t Contentions() const noexcept { return _contentions.load(ztd::memory_order_relaxed); }
+    // Approximate while waits are being recorded, as a carry may not have been added yet.
+    uint64_t TotalWaitCycles() const noexcept {
+        return (static_cast<uint64_t>(_total_wait_high.load(ztd::memory_order_relaxed)) << 32) |
+               _total_wait_low.load(ztd::memory_order_relaxed);
+    }
+    uint32_t MaxWaitCycles() const noexcept { return _max_wait.load(ztd::memory_order_relaxed); }
+    // Always zero for semaphores, which have no owner.
+    uint32_t MaxHoldCycles() const noexcept { return _max_hold.load(ztd::memory_order_relaxed); }
+
+    void Reset() noexcept;
+
+    // Calls fn for every registered LockStats. Locks must not be created or destroyed from within fn.
+    static void ForEach(void (*fn)(const LockStats& stats, void* user_data), void* user_data) noexcept;
+
+    // Prints a table of all registered locks with printk.
+    static void DumpAll() noexcept;
+
+    // Resets the statistics of all registered locks.
+    static void ResetAll() noexcept;
+
+private:
+    sys_snode_t _node;
+    const char* _name;
+    ztd::atomic<uint32_t> _acquisitions;
+    ztd::atomic<uint32_t> _contentions;
+    ztd::atomic<uint32_t> _total_wait_low;
+    ztd::atomic<uint32_t> _total_wait_high;
+    ztd::atomic<uint32_t> _max_wait;
+    ztd::atomic<uint32_t> _max_hold;
+
+    static void _UpdateMax(ztd::atomic<uint32_t>& max, uint32_t value) noexcept {
+        uint32_t current = max.load(ztd::memory_order_relaxed);
+        while (value > current && !max.compare_exchange_weak(current, value, ztd::memory_order_relaxed)) {}
+    }
+};
+
+} // namespace
+
+#endif // defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+
+#endif // _FAVONIUS_LOCKSTAT_HPP_
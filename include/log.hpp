@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_LOG_HPP_
+#define _FAVONIUS_LOG_HPP_
+
+#include <kernel.h>
+
+#include "span.hpp"
+#include "type_traits.hpp"
+
+// Deferred binary logging for hot paths.
+// A call to Log::Write() formats nothing: it copies the pointer to the format string and the raw bytes of the
+// arguments, with a cycle count timestamp, into a lock-free ring buffer of the CPU it runs on. The messages are
+// formatted later by Log::Process(), e.g. from a low priority thread, or drained raw by Log::Drain() for a decoder
+// on the host. Log is compiled in with CONFIG_FAVONIUS_LOG; when disabled it keeps its interface but does nothing,
+// so calls may be left in production code. Messages above CONFIG_FAVONIUS_LOG_LEVEL are compiled out.
+//
+// Because formatting is deferred, the format string and any argument formatted with %s must have static storage
+// duration, e.g. be string literals. Arguments may be integers, floating point numbers and pointers; at most
+// MaxArguments of them. Length modifiers in the format (h, l, ll, z...) are ignored, as the type of every argument is
+// recorded, so e.g. %d formats any integer. Width given by '*' is not supported.
+
+namespace fav {
+
+enum class LogLevel : uint8_t {
+    Error = 1,
+    Warning = 2,
+    Info = 3,
+    Debug = 4,
+};
+
+// A message as it was written, passed with its formatted text to the output of Log::Process().
+struct LogEntry {
+    uint32_t cycles;
+    uint32_t cpu;
+    LogLevel level;
+    const char* format;
+};
+
+namespace _detail {
+
+// The type of each argument is recorded in 3 bits of the record header.
+enum class LogArgType : uint32_t {
+    End = 0,
+    Int32,
+    Uint32,
+    Int64,
+    Uint64,
+    Double,
+    Pointer,
+};
+
+constexpr size_t LogArgTypeBits = 3;
+constexpr size_t LogPointerWords = sizeof(const void*) / sizeof(uint32_t);
+
+template <typename Stored, LogArgType StoredType>
+struct LogArgStorage {
+    static constexpr LogArgType Type = StoredType;
+    static constexpr size_t Words = sizeof(Stored) / sizeof(uint32_t);
+
+    template <typename T>
+    static void Store(uint32_t*& out, const T& value) noexcept {
+        const Stored stored = static_cast<Stored>(value);
+        __builtin_memcpy(out, &stored, sizeof(stored));
+        out += Words;
+    }
+};
+
+template <typename T, bool = ztd::is_integral<T>::value, bool = ztd::is_floating_point<T>::value,
+          bool = ztd::is_pointer<T>::value>
+struct LogArg {
+    static_assert(sizeof(T) == 0, "fav::Log arguments must be integers, floating point numbers or pointers.");
+};
+
+template <typename T>
+struct LogArg<T, true, false, false>
+    : ztd::conditional<(sizeof(T) <= sizeof(uint32_t)),
+                       typename ztd::conditional<(T(-1) < T(0)), LogArgStorage<int32_t, LogArgType::Int32>,
+                                                 LogArgStorage<uint32_t, LogArgType::Uint32>>::type,
+                       typename ztd::conditional<(T(-1) < T(0)), LogArgStorage<int64_t, LogArgType::Int64>,
+                                                 LogArgStorage<uint64_t, LogArgType::Uint64>>::type>::type {};
+
+template <typename T>
+struct LogArg<T, false, true, false> : LogArgStorage<double, LogArgType::Double> {};
+
+template <typename T>
+struct LogArg<T, false, false, true> : LogArgStorage<const void*, LogArgType::Pointer> {};
+
+template <typename... Args>
+constexpr uint32_t LogArgTypes() noexcept {
+    uint32_t types = 0;
+    uint32_t shift = 0;
+    ((types |= static_cast<uint32_t>(LogArg<Args>::Type) << shift, shift += LogArgTypeBits), ...);
+    return types;
+}
+
+} // namespace
+
+#if defined(CONFIG_FAVONIUS_LOG)
+
+// Records are written by any thread or ISR without locks, and read by a single consumer at a time.
+// The buffer of each CPU holds CONFIG_FAVONIUS_LOG_BUFFER_SIZE bytes; a message which does not fit is dropped
+// and counted, see Dropped(). A writer preempted in the middle of a message holds back the messages after it on
+// that CPU until it finishes.
+class Log final {
+public:
+    static constexpr size_t MaxArguments = 7;
+
+    using OutputFunction = void (*)(const LogEntry& entry, const char* text, void* user_data);
+    using DrainFunction = void (*)(ztd::span<const uint32_t> record, uint32_t cpu, void* user_data);
+
+    template <typename... Args>
+    static void Write(LogLevel level, const char* format, const Args&... args) noexcept {
+        static_assert(sizeof...(Args) <= MaxArguments, "Too many arguments for fav::Log.");
+        if (static_cast<int>(level) > CONFIG_FAVONIUS_LOG_LEVEL) {
+            return;
+        }
+        uint32_t payload[_detail::LogPointerWords + (size_t(0) + ... + _detail::LogArg<ztd::decay_t<Args>>::Words)];
+        uint32_t* out = payload;
+        _detail::LogArg<const char*>::Store(out, format);
+        (_detail::LogArg<ztd::decay_t<Args>>::Store(out, args), ...);
+        _Commit(level, _detail::LogArgTypes<ztd::decay_t<Args>...>(), payload, sizeof(payload) / sizeof(uint32_t));
+    }
+
+    template <typename... Args>
+    static void Error(const char* format, const Args&... args) noexcept { Write(LogLevel::Error, format, args...); }
+    template <typename... Args>
+    static void Warning(const char* format, const Args&... args) noexcept { Write(LogLevel::Warning, format, args...); }
+    template <typename... Args>
+    static void Info(const char* format, const Args&... args) noexcept { Write(LogLevel::Info, format, args...); }
+    template <typename... Args>
+    static void Debug(const char* format, const Args&... args) noexcept { Write(LogLevel::Debug, format, args...); }
+
+    // Formats up to max_messages pending messages, oldest first across CPUs, and prints them with printk.
+    // Returns the number of messages processed, which is 0 if another thread is already processing.
+    static size_t Process(size_t max_messages = SIZE_MAX) noexcept;
+
+    // Like Process(), but passes each message with its formatted text to output.
+    static size_t Process(OutputFunction output, void* user_data, size_t max_messages = SIZE_MAX) noexcept;
+
+    // Removes up to max_records pending records without formatting them, and passes them to fn, e.g. to send them
+    // to the host. A record is a sequence of 32-bit words in the byte order of the target:
+    //  [0] header: bit 31 set; bits 24-28 the length of the record in words; bits 21-23 the LogLevel;
+    //      bits 0-20 the LogArgType of each argument, 3 bits each from the lowest, ending with End (0).
+    //  [1] timestamp, from k_cycle_get_32().
+    //  [2] the address of the format string, in as many words as a pointer takes.
+    //  followed by the arguments in order, each in as many words as its LogArgType takes.
+    // The format strings are resolved from the address with the ELF file of the application.
+    static size_t Drain(DrainFunction fn, void* user_data, size_t max_records = SIZE_MAX) noexcept;
+
+    // The number of messages dropped because the buffer was full.
+    static uint32_t Dropped() noexcept;
+
+private:
+    static void _Commit(LogLevel level, uint32_t types, const uint32_t* payload, size_t words) noexcept;
+};
+
+#else
+
+class Log final {
+public:
+    static constexpr size_t MaxArguments = 7;
+
+    using OutputFunction = void (*)(const LogEntry& entry, const char* text, void* user_data);
+    using DrainFunction = void (*)(ztd::span<const uint32_t> record, uint32_t cpu, void* user_data);
+
+    template <typename... Args>
+    static void Write([[maybe_unused]] LogLevel level, [[maybe_unused]] const char* format,
+                      [[maybe_unused]] const Args&... args) noexcept {}
+    template <typename... Args>
+    static void Error([[maybe_unused]] const char* format, [[maybe_unused]] const Args&... args) noexcept {}
+    template <typename... Args>
+    static void Warning([[maybe_unused]] const char* format, [[maybe_unused]] const Args&... args) noexcept {}
+    template <typename... Args>
+    static void Info([[maybe_unused]] const char* format, [[maybe_unused]] const Args&... args) noexcept {}
+    template <typename... Args>
+    static void Debug([[maybe_unused]] const char* format, [[maybe_unused]] const Args&... args) noexcept {}
+
+    static size_t Process([[maybe_unused]] size_t max_messages = SIZE_MAX) noexcept { return 0; }
+    static size_t Process([[maybe_unused]] OutputFunction output, [[maybe_unused]] void* user_data,
+                          [[maybe_unused]] size_t max_messages = SIZE_MAX) noexcept { return 0; }
+    static size_t Drain([[maybe_unused]] DrainFunction fn, [[maybe_unused]] void* user_data,
+                        [[maybe_unused]] size_t max_records = SIZE_MAX) noexcept { return 0; }
+    static uint32_t Dropped() noexcept { return 0; }
+};
+
+#endif // defined(CONFIG_FAVONIUS_LOG)
+
+} // namespace
+
+#endif // _FAVONIUS_LOG_HPP_
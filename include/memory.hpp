@@ -3,7 +3,9 @@
 
 #include <kernel.h>
 
+#include "atomic.hpp"
 #include "new.hpp"
+#include "trace.hpp"
 #include "type_traits.hpp"
 #include "utility.hpp"
 
@@ -15,13 +17,16 @@ namespace ztd {
 // (i.e. use k_heap_malloc and k_heap_free)
 // Note that the actual amount of memory buffered is HeapSize + Z_HEAP_MIN_SIZE,
 // as there is extra space required for bookkeeping.
+// Memory is aligned for T, or for a pointer if T needs less.
+// With CONFIG_FAVONIUS_TRACING, allocations are traced under the name given to SetName().
 template <typename T, size_t HeapSize>
-struct allocator {
+struct allocator : public fav::Traceable {
 public:
     using value_type = T;
     using size_type = size_t;
     using difference_type = size_t;
     constexpr static size_t heap_size = HeapSize + Z_HEAP_MIN_SIZE;
+    constexpr static size_t alignment = (alignof(T) > sizeof(void*)) ? alignof(T) : sizeof(void*);
 
     constexpr allocator() noexcept {
         _heap.heap.init_mem = _heapdata;
@@ -31,13 +36,19 @@ public:
 
     // Returns NULL if insufficient memory is available
     [[nodiscard]] constexpr T* allocate(size_t n) noexcept {
-        return static_cast<T*>(k_heap_alloc(&_heap, sizeof(T) * n, K_NO_WAIT));
+        T* p = static_cast<T*>(k_heap_aligned_alloc(&_heap, alignment, sizeof(T) * n, K_NO_WAIT));
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::Alloc(this, Name(), sizeof(T) * n, p);
+#endif
+        return p;
     }
 
-    constexpr void deallocate(T* p, size_t n) noexcept {
-        for (size_t m = 0; m < n; ++m) {
-            k_heap_free(&_heap, p + (sizeof(T) * m));
-        }
+    constexpr void deallocate(T* p, [[maybe_unused]] size_t n) noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::Free(this, Name(), sizeof(T) * n, p);
+#endif
+        // allocate(n) returns a single block.
+        k_heap_free(&_heap, p);
     }
 
 private:
@@ -47,28 +58,406 @@ private:
 
 // Partial specialization where HeapSize is 0.
 // In this case, we dynamically allocate memory from the global heap (CONFIG_HEAP_MEM_POOL_SIZE)
-// (i.e. use k_malloc and k_free instead)
+// (i.e. use k_aligned_alloc and k_free instead)
 template <typename T>
-struct allocator<T, 0> {
+struct allocator<T, 0> : public fav::Traceable {
 public:
     using value_type = T;
     using size_type = size_t;
     using difference_type = size_t;
     constexpr static size_t heap_size = 0;
+    constexpr static size_t alignment = (alignof(T) > sizeof(void*)) ? alignof(T) : sizeof(void*);
 
     constexpr allocator() noexcept {}
 
     [[nodiscard]] constexpr T* allocate(size_t n) noexcept {
-        return static_cast<T*>(k_malloc(sizeof(T) * n));
+        T* p = static_cast<T*>(k_aligned_alloc(alignment, sizeof(T) * n));
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::Alloc(this, Name(), sizeof(T) * n, p);
+#endif
+        return p;
+    }
+
+    constexpr void deallocate(T* p, [[maybe_unused]] size_t n) noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::Free(this, Name(), sizeof(T) * n, p);
+#endif
+        // allocate(n) returns a single block.
+        k_free(p);
+    }
+};
+
+// Smart pointers.
+// unique_ptr is the size of a pointer unless its deleter has state. shared_ptr is made only by make_shared()
+// or allocate_shared(), which put the reference count and the object in a single allocation; there is no weak_ptr.
+// Allocation failures leave the pointer empty, as nothing throws.
+
+// Destroys an object made by the global operator new, which allocates with k_malloc (see new.hpp).
+template <typename T>
+struct default_delete {
+    constexpr default_delete() noexcept = default;
+
+    template <typename U, typename = enable_if_t<is_convertible<U*, T*>::value>>
+    constexpr default_delete(const default_delete<U>&) noexcept {}
+
+    void operator()(T* ptr) const noexcept {
+        ptr->~T();
+        k_free(ptr);
+    }
+};
+
+namespace _detail {
+
+// The deleter is an empty base when it has no state, so that it takes no space.
+template <typename T, typename Deleter, bool = is_empty<Deleter>::value && !is_final<Deleter>::value>
+class unique_ptr_storage : private Deleter {
+public:
+    constexpr unique_ptr_storage(T* ptr, const Deleter& deleter) noexcept : Deleter(deleter), _ptr(ptr) {}
+    constexpr Deleter& deleter() noexcept { return *this; }
+    constexpr const Deleter& deleter() const noexcept { return *this; }
+
+    T* _ptr;
+};
+
+template <typename T, typename Deleter>
+class unique_ptr_storage<T, Deleter, false> {
+public:
+    constexpr unique_ptr_storage(T* ptr, const Deleter& deleter) noexcept : _ptr(ptr), _deleter(deleter) {}
+    constexpr Deleter& deleter() noexcept { return _deleter; }
+    constexpr const Deleter& deleter() const noexcept { return _deleter; }
+
+    T* _ptr;
+
+private:
+    Deleter _deleter;
+};
+
+} // namespace
+
+// Sole owner of an object, which is destroyed with Deleter. Arrays (unique_ptr<T[]>) are not supported.
+template <typename T, typename Deleter = default_delete<T>>
+class unique_ptr final {
+public:
+    using pointer = T*;
+    using element_type = T;
+    using deleter_type = Deleter;
+
+    constexpr unique_ptr() noexcept : _storage(nullptr, Deleter()) {}
+    constexpr unique_ptr(decltype(nullptr)) noexcept : unique_ptr() {}
+    constexpr explicit unique_ptr(pointer ptr) noexcept : _storage(ptr, Deleter()) {}
+    constexpr unique_ptr(pointer ptr, const Deleter& deleter) noexcept : _storage(ptr, deleter) {}
+
+    unique_ptr(unique_ptr&& other) noexcept : _storage(other.release(), other.get_deleter()) {}
+
+    template <typename U, typename E,
+              typename = enable_if_t<is_convertible<U*, T*>::value && is_convertible<E, Deleter>::value>>
+    unique_ptr(unique_ptr<U, E>&& other) noexcept : _storage(other.release(), other.get_deleter()) {}
+
+    unique_ptr(const unique_ptr&) = delete;
+    unique_ptr& operator=(const unique_ptr&) = delete;
+
+    ~unique_ptr() noexcept { reset(); }
+
+    unique_ptr& operator=(unique_ptr&& other) noexcept {
+        reset(other.release());
+        get_deleter() = other.get_deleter();
+        return *this;
+    }
+
+    template <typename U, typename E,
+              typename = enable_if_t<is_convertible<U*, T*>::value && is_convertible<E, Deleter>::value>>
+    unique_ptr& operator=(unique_ptr<U, E>&& other) noexcept {
+        reset(other.release());
+        get_deleter() = other.get_deleter();
+        return *this;
+    }
+
+    unique_ptr& operator=(decltype(nullptr)) noexcept {
+        reset();
+        return *this;
+    }
+
+    // Gives up ownership without destroying the object.
+    pointer release() noexcept {
+        pointer ptr = _storage._ptr;
+        _storage._ptr = nullptr;
+        return ptr;
+    }
+
+    void reset(pointer ptr = nullptr) noexcept {
+        pointer old = _storage._ptr;
+        _storage._ptr = ptr;
+        if (old != nullptr) {
+            get_deleter()(old);
+        }
+    }
+
+    void swap(unique_ptr& other) noexcept {
+        ztd::swap(_storage._ptr, other._storage._ptr);
+        ztd::swap(get_deleter(), other.get_deleter());
+    }
+
+    pointer get() const noexcept { return _storage._ptr; }
+    Deleter& get_deleter() noexcept { return _storage.deleter(); }
+    const Deleter& get_deleter() const noexcept { return _storage.deleter(); }
+    explicit operator bool() const noexcept { return _storage._ptr != nullptr; }
+
+    T& operator*() const noexcept { return *_storage._ptr; }
+    pointer operator->() const noexcept { return _storage._ptr; }
+
+private:
+    _detail::unique_ptr_storage<T, Deleter> _storage;
+};
+
+template <typename T, typename D, typename U, typename E>
+bool operator==(const unique_ptr<T, D>& lhs, const unique_ptr<U, E>& rhs) noexcept { return lhs.get() == rhs.get(); }
+
+template <typename T, typename D, typename U, typename E>
+bool operator!=(const unique_ptr<T, D>& lhs, const unique_ptr<U, E>& rhs) noexcept { return lhs.get() != rhs.get(); }
+
+template <typename T, typename D>
+bool operator==(const unique_ptr<T, D>& lhs, decltype(nullptr)) noexcept { return !lhs; }
+
+template <typename T, typename D>
+bool operator!=(const unique_ptr<T, D>& lhs, decltype(nullptr)) noexcept { return static_cast<bool>(lhs); }
+
+// Constructs T on the global heap. The result is empty if the allocation failed.
+template <typename T, typename... Args>
+unique_ptr<T> make_unique(Args&&... args) noexcept {
+    return unique_ptr<T>(new T(ztd::forward<Args>(args)...));
+}
+
+template <typename T>
+class shared_ptr;
+
+namespace _detail {
+
+// Whether allocator, which returns memory aligned for its value_type and at least for a pointer (as k_malloc and
+// k_heap_alloc do), may hold a T.
+template <typename Allocator, typename T>
+constexpr bool allocator_aligns_for() noexcept {
+    return alignof(T) <= alignof(typename Allocator::value_type) || alignof(T) <= sizeof(void*);
+}
+
+// Precedes the object in the allocation made by make_shared() or allocate_shared().
+struct shared_control {
+    atomic<uint32_t> uses;
+    // Destroys the object and frees the allocation.
+    void (*destroy)(shared_control* control) noexcept;
+};
+
+// How a shared block is allocated and freed: through a favonius allocator, or with k_aligned_alloc and k_free for the
+// global heap.
+template <typename Allocator>
+struct shared_allocator_ref {
+    using value_type = typename Allocator::value_type;
+
+    Allocator* allocator;
+
+    template <typename Block>
+    static constexpr size_t units() noexcept { return (sizeof(Block) + sizeof(value_type) - 1) / sizeof(value_type); }
+
+    template <typename Block>
+    void* allocate() noexcept {
+        static_assert(allocator_aligns_for<Allocator, Block>(),
+                      "The allocator's value_type must be at least as aligned as the object.");
+        return allocator->allocate(units<Block>());
     }
 
-    constexpr void deallocate(T* p, size_t n) noexcept {
-        for (size_t m = 0; m < n; ++m) {
-            k_free(p + (sizeof(T) * m));
+    template <typename Block>
+    void deallocate(void* ptr) noexcept { allocator->deallocate(static_cast<value_type*>(ptr), units<Block>()); }
+};
+
+template <>
+struct shared_allocator_ref<void> {
+    template <typename Block>
+    void* allocate() noexcept {
+        return k_aligned_alloc((alignof(Block) > sizeof(void*)) ? alignof(Block) : sizeof(void*), sizeof(Block));
+    }
+
+    template <typename Block>
+    void deallocate(void* ptr) noexcept { k_free(ptr); }
+};
+
+template <typename T, typename Allocator>
+struct shared_block {
+    // First, so that a pointer to the control is a pointer to the block.
+    shared_control control;
+    shared_allocator_ref<Allocator> allocator;
+    alignas(T) uint8_t storage[sizeof(T)];
+
+    T* object() noexcept { return reinterpret_cast<T*>(storage); }
+
+    static void destroy(shared_control* control) noexcept {
+        shared_block* block = reinterpret_cast<shared_block*>(control);
+        shared_allocator_ref<Allocator> allocator = block->allocator;
+        block->object()->~T();
+        block->~shared_block();
+        allocator.template deallocate<shared_block>(block);
+    }
+
+    template <typename... Args>
+    static shared_ptr<T> make(shared_allocator_ref<Allocator> allocator, Args&&... args) noexcept {
+        void* memory = allocator.template allocate<shared_block>();
+        if (memory == nullptr) {
+            return shared_ptr<T>();
         }
+        shared_block* block = new (memory) shared_block {{1, &destroy}, allocator, {}};
+        T* object = new (block->storage) T(ztd::forward<Args>(args)...);
+        return shared_ptr<T>(object, &block->control);
     }
 };
 
 } // namespace
 
-#endif // _FAVONIUS_MEMORY_HPP_
\ No newline at end of file
+// Shares ownership of an object, which is destroyed when the last shared_ptr to it goes.
+// Copies may be used and destroyed concurrently from different threads: taking a reference is a relaxed atomic
+// increment, and only dropping one orders memory (acquire-release), so that the last owner sees every write made
+// through the others. Accessing the object itself is not synchronized.
+template <typename T>
+class shared_ptr final {
+public:
+    using element_type = T;
+
+    constexpr shared_ptr() noexcept : _ptr(nullptr), _control(nullptr) {}
+    constexpr shared_ptr(decltype(nullptr)) noexcept : shared_ptr() {}
+
+    shared_ptr(const shared_ptr& other) noexcept : _ptr(other._ptr), _control(other._control) { _Acquire(); }
+
+    shared_ptr(shared_ptr&& other) noexcept : _ptr(other._ptr), _control(other._control) {
+        other._ptr = nullptr;
+        other._control = nullptr;
+    }
+
+    template <typename U, typename = enable_if_t<is_convertible<U*, T*>::value>>
+    shared_ptr(const shared_ptr<U>& other) noexcept : _ptr(other._ptr), _control(other._control) { _Acquire(); }
+
+    template <typename U, typename = enable_if_t<is_convertible<U*, T*>::value>>
+    shared_ptr(shared_ptr<U>&& other) noexcept : _ptr(other._ptr), _control(other._control) {
+        other._ptr = nullptr;
+        other._control = nullptr;
+    }
+
+    ~shared_ptr() noexcept { _Release(); }
+
+    // Takes other by value, which covers both copy and move assignment.
+    shared_ptr& operator=(shared_ptr other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    void reset() noexcept { shared_ptr().swap(*this); }
+
+    void swap(shared_ptr& other) noexcept {
+        ztd::swap(_ptr, other._ptr);
+        ztd::swap(_control, other._control);
+    }
+
+    T* get() const noexcept { return _ptr; }
+    T& operator*() const noexcept { return *_ptr; }
+    T* operator->() const noexcept { return _ptr; }
+    explicit operator bool() const noexcept { return _ptr != nullptr; }
+
+    // Approximate when other threads hold copies, as in std.
+    long use_count() const noexcept {
+        return (_control != nullptr) ? static_cast<long>(_control->uses.load(memory_order_relaxed)) : 0;
+    }
+
+private:
+    template <typename U>
+    friend class shared_ptr;
+    template <typename U, typename Allocator>
+    friend struct _detail::shared_block;
+
+    shared_ptr(T* ptr, _detail::shared_control* control) noexcept : _ptr(ptr), _control(control) {}
+
+    T* _ptr;
+    _detail::shared_control* _control;
+
+    void _Acquire() noexcept {
+        if (_control != nullptr) {
+            _control->uses.fetch_add(1, memory_order_relaxed);
+        }
+    }
+
+    void _Release() noexcept {
+        if (_control != nullptr && _control->uses.fetch_sub(1, memory_order_acq_rel) == 1) {
+            _control->destroy(_control);
+        }
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const shared_ptr<T>& lhs, const shared_ptr<U>& rhs) noexcept { return lhs.get() == rhs.get(); }
+
+template <typename T, typename U>
+bool operator!=(const shared_ptr<T>& lhs, const shared_ptr<U>& rhs) noexcept { return lhs.get() != rhs.get(); }
+
+template <typename T>
+bool operator==(const shared_ptr<T>& lhs, decltype(nullptr)) noexcept { return !lhs; }
+
+template <typename T>
+bool operator!=(const shared_ptr<T>& lhs, decltype(nullptr)) noexcept { return static_cast<bool>(lhs); }
+
+// Constructs T on the global heap, in one allocation with its reference count.
+// The result is empty if the allocation failed.
+template <typename T, typename... Args>
+shared_ptr<T> make_shared(Args&&... args) noexcept {
+    return _detail::shared_block<T, void>::make(_detail::shared_allocator_ref<void>(), ztd::forward<Args>(args)...);
+}
+
+// As make_shared(), but allocates from allocator, e.g. a ztd::allocator with its own heap.
+// The allocation is counted in units of the allocator's value_type, which must be at least as aligned as T unless T
+// needs no more than pointer alignment. The allocator must outlive the object.
+template <typename T, typename Allocator, typename... Args>
+shared_ptr<T> allocate_shared(Allocator& allocator, Args&&... args) noexcept {
+    return _detail::shared_block<T, Allocator>::make(_detail::shared_allocator_ref<Allocator> {&allocator},
+                                                     ztd::forward<Args>(args)...);
+}
+
+} // namespace
+
+namespace fav {
+
+// Deleter for a ztd::unique_ptr to an object made by AllocateUnique(), which returns it to its allocator.
+template <typename T, typename Allocator>
+class AllocatorDelete {
+public:
+    constexpr AllocatorDelete() noexcept : _allocator(nullptr) {}
+    constexpr explicit AllocatorDelete(Allocator& allocator) noexcept : _allocator(&allocator) {}
+
+    void operator()(T* ptr) const noexcept {
+        ptr->~T();
+        _allocator->deallocate(reinterpret_cast<typename Allocator::value_type*>(ptr), Units());
+    }
+
+    // Size of T in units of the allocator's value_type.
+    static constexpr size_t Units() noexcept {
+        return (sizeof(T) + sizeof(typename Allocator::value_type) - 1) / sizeof(typename Allocator::value_type);
+    }
+
+private:
+    Allocator* _allocator;
+};
+
+template <typename T, typename Allocator>
+using AllocatorUniquePtr = ztd::unique_ptr<T, AllocatorDelete<T, Allocator>>;
+
+// Constructs T with memory from allocator, e.g. a ztd::allocator with its own heap. As for ztd::allocate_shared(),
+// the allocator's value_type must be at least as aligned as T unless T needs no more than pointer alignment.
+// The pointer carries the allocator, so it is the size of two pointers. The result is empty if the allocation failed.
+template <typename T, typename Allocator, typename... Args>
+AllocatorUniquePtr<T, Allocator> AllocateUnique(Allocator& allocator, Args&&... args) noexcept {
+    static_assert(ztd::_detail::allocator_aligns_for<Allocator, T>(),
+                  "The allocator's value_type must be at least as aligned as T.");
+    void* memory = allocator.allocate(AllocatorDelete<T, Allocator>::Units());
+    if (memory == nullptr) {
+        return AllocatorUniquePtr<T, Allocator>();
+    }
+    return AllocatorUniquePtr<T, Allocator>(new (memory) T(ztd::forward<Args>(args)...),
+                                            AllocatorDelete<T, Allocator>(allocator));
+}
+
+} // namespace
+
+#endif // _FAVONIUS_MEMORY_HPP_
@@ -4,13 +4,133 @@
 #include <sys/mutex.h>
 #include <sys/timeutil.h>
 
+#include "lockstat.hpp"
+#include "trace.hpp"
 #include "utility.hpp"
 
+#if defined(CONFIG_USERSPACE)
+namespace fav {
+
+// Mutex backed by a k_futex.
+// The lock word lives in user memory, so the uncontended lock() and unlock() are a single atomic
+// operation each and never leave user mode. The kernel is only entered to sleep or wake waiters.
+// Unlike ztd::mutex (k_mutex), this mutex is NOT recursive and has no priority inheritance.
+// Like every kernel object, instances used from user threads must be statically allocated.
+// Fulfills C++ Mutex( Lockable ( BasicLockable ), DefaultConstructible, Destructible, NonCopyable, NonMovable ) concept.
+class FutexMutex final : private Traceable {
+public:
+    FutexMutex() noexcept;
+    FutexMutex(const FutexMutex&) = delete;
+    FutexMutex(FutexMutex&&) = delete;
+    ~FutexMutex() noexcept = default;
+
+    // Locks the mutex.
+    // If another thread has already locked the mutex, a call to lock will block execution until the lock is acquired.
+    void lock() noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::MutexLock(this, Name());
+#endif
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+        const uint32_t start = k_cycle_get_32();
+        const bool contended = !atomic_cas(&_futex.val, Unlocked, Locked);
+        if (contended) {
+            _LockContended();
+        }
+        _acquired_at = _stats.RecordAcquisition(start, contended);
+#else
+        if (!atomic_cas(&_futex.val, Unlocked, Locked)) {
+            _LockContended();
+        }
+#endif
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::MutexLocked(this, Name(), 0);
+#endif
+    }
+
+    // Tries to lock the mutex.
+    // Returns immediately.
+    // On successful lock acquisition returns true, otherwise returns false.
+    bool try_lock() noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::MutexLock(this, Name());
+#endif
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+        const uint32_t start = k_cycle_get_32();
+        const bool locked = atomic_cas(&_futex.val, Unlocked, Locked);
+        if (locked) {
+            _acquired_at = _stats.RecordAcquisition(start, false);
+        } else {
+            _stats.RecordFailedAttempt();
+        }
+#else
+        const bool locked = atomic_cas(&_futex.val, Unlocked, Locked);
+#endif
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::MutexLocked(this, Name(), locked ? 0 : -EBUSY);
+#endif
+        return locked;
+    }
+
+    // Unlocks the mutex.
+    void unlock() noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::MutexUnlock(this, Name());
+#endif
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+        _stats.RecordRelease(_acquired_at);
+#endif
+        if (atomic_dec(&_futex.val) != Locked) {
+            _UnlockContended();
+        }
+    }
+
+    k_futex* native_handle() noexcept {
+        return &_futex;
+    }
+
+    // Names this mutex in the contention statistics and trace events. The string is not copied.
+    void SetName(const char* name) noexcept {
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+        _stats.SetName(name);
+#endif
+        Traceable::SetName(name);
+    }
+
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    const fav::LockStats& Stats() const noexcept { return _stats; }
+#endif
+
+private:
+    // States of the lock word.
+    // Contended means that there may be threads sleeping on the futex, so unlock() has to wake one.
+    static constexpr atomic_val_t Unlocked = 0;
+    static constexpr atomic_val_t Locked = 1;
+    static constexpr atomic_val_t Contended = 2;
+
+    struct k_futex _futex;
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    fav::LockStats _stats;
+    uint32_t _acquired_at;
+#endif
+
+    void _LockContended() noexcept;
+    void _UnlockContended() noexcept;
+};
+
+} // namespace
+#endif // defined(CONFIG_USERSPACE)
+
 namespace ztd {
 
+#if defined(CONFIG_FAVONIUS_FUTEX_MUTEX)
+
+using mutex = fav::FutexMutex;
+
+#else
+
 // Mutex class. In zephyr, all mutexes are recursive (reentrant).
 // Fulfills C++ Mutex( Lockable ( BasicLockable ), DefaultConstructible, Destructible, NonCopyable, NonMovable ) concept.
-class mutex final {
+class mutex final : private fav::Traceable {
 public:
     mutex() noexcept;
     mutex(const mutex&) = delete;
@@ -33,11 +153,31 @@ public:
         return &_mutex;
     }
 
+    // Names this mutex in the contention statistics and trace events. The string is not copied.
+    void SetName(const char* name) noexcept {
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+        _stats.SetName(name);
+#endif
+        Traceable::SetName(name);
+    }
+
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    const fav::LockStats& Stats() const noexcept { return _stats; }
+#endif
+
 private:
     struct k_mutex _mutex;
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    fav::LockStats _stats;
+    uint32_t _acquired_at;
+    // Recursion depth of the owner. Kept here because user threads cannot read the k_mutex itself.
+    uint32_t _lock_depth;
+#endif
 };
 
-class timed_mutex final {
+#endif // defined(CONFIG_FAVONIUS_FUTEX_MUTEX)
+
+class timed_mutex final : private fav::Traceable {
 public:
     timed_mutex() noexcept;
     timed_mutex(const timed_mutex&) = delete;
@@ -71,8 +211,26 @@ public:
         return &_mutex;
     }
 
+    // Names this mutex in the contention statistics and trace events. The string is not copied.
+    void SetName(const char* name) noexcept {
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+        _stats.SetName(name);
+#endif
+        Traceable::SetName(name);
+    }
+
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    const fav::LockStats& Stats() const noexcept { return _stats; }
+#endif
+
 private:
     struct k_mutex _mutex;
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    fav::LockStats _stats;
+    uint32_t _acquired_at;
+    // Recursion depth of the owner. Kept here because user threads cannot read the k_mutex itself.
+    uint32_t _lock_depth;
+#endif
 };
 
 // Empty structs that acts as tags for unique_lock.
@@ -114,36 +272,41 @@ struct unique_lock final {
 public:
     using mutex_type = Mutex;
 
-    unique_lock(mutex_type& mutex) noexcept : _mutex(mutex), _deferred(false) { _mutex.lock(); }
-    unique_lock(mutex_type& mutex, ztd::defer_lock_t t)  noexcept : _mutex(mutex), _deferred(true)  {}
-    unique_lock(mutex_type& mutex, ztd::try_to_lock_t t) noexcept : _mutex(mutex), _deferred(false) { _mutex.try_lock(); }
-    unique_lock(mutex_type& mutex, ztd::adopt_lock_t t)  noexcept : _mutex(mutex), _deferred(false) {}
+    unique_lock(mutex_type& mutex) noexcept : _mutex(mutex), _owns(true) { _mutex.lock(); }
+    unique_lock(mutex_type& mutex, ztd::defer_lock_t t)  noexcept : _mutex(mutex), _owns(false) {}
+    unique_lock(mutex_type& mutex, ztd::try_to_lock_t t) noexcept : _mutex(mutex), _owns(_mutex.try_lock()) {}
+    unique_lock(mutex_type& mutex, ztd::adopt_lock_t t)  noexcept : _mutex(mutex), _owns(true) {}
     unique_lock(const unique_lock&) = delete;
-    unique_lock(unique_lock&& other) noexcept { _mutex = ztd::move(other._mutex); _deferred = other._deferred; }
+    unique_lock(unique_lock&& other) noexcept : _mutex(other._mutex), _owns(other._owns) { other._owns = false; }
     ~unique_lock() noexcept {
-        if (!_deferred) {
+        if (_owns) {
             _mutex.unlock();
         }
     }
 
     void lock() noexcept {
         _mutex.lock();
+        _owns = true;
     }
 
     bool try_lock() noexcept {
-        return _mutex.try_lock();
+        _owns = _mutex.try_lock();
+        return _owns;
     }
 
     void unlock() noexcept {
         _mutex.unlock();
+        _owns = false;
     }
 
     mutex_type* mutex() const noexcept {
         return &_mutex;
     }
 
+    // Ownership is tracked here rather than queried from the native handle,
+    // so that this works for mutexes which do not record their owner (e.g. fav::FutexMutex).
     bool owns_lock() const noexcept {
-        return _mutex.native_handle()->lock_count > 0;
+        return _owns;
     }
 
     operator bool() const noexcept {
@@ -152,7 +315,7 @@ public:
 
 private:
     mutex_type& _mutex;
-    bool _deferred;
+    bool _owns;
 };
 
 } // namespace
@@ -0,0 +1,334 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_NETBUF_HPP_
+#define _FAVONIUS_NETBUF_HPP_
+
+#include <kernel.h>
+#include <net/buf.h>
+
+#include "algorithm.hpp"
+#include "span.hpp"
+#include "utility.hpp"
+
+// Wrappers of Zephyr's network buffers (net/buf.h, which requires CONFIG_NET_BUF).
+// A net_buf is a fixed-size block from a pool, with reference-counted ownership, headroom in front of the data for
+// headers prepended by lower layers, and a chain of fragments after it. Passing a NetBuf between layers or threads
+// passes the reference; the data itself is never copied, except by the explicit CopyOut() and Read() functions.
+// The accessors which take a size check it and fail (return an empty span, or false) rather than assert as Zephyr does.
+
+namespace fav {
+
+// Owns one reference to a net_buf, and through it the fragments chained after it.
+// Copies share the buffer, by taking another reference. Member functions are NOT thread safe, but separate NetBufs
+// referring to the same buffer may be used and destroyed in different threads.
+class NetBuf final {
+public:
+    constexpr NetBuf() noexcept : _buf(nullptr) {}
+    constexpr NetBuf(decltype(nullptr)) noexcept : _buf(nullptr) {}
+
+    // Takes over a reference, e.g. one returned by net_buf_alloc() or handed over by a driver.
+    explicit constexpr NetBuf(struct net_buf* buf) noexcept : _buf(buf) {}
+
+    NetBuf(const NetBuf& other) noexcept : _buf((other._buf != nullptr) ? net_buf_ref(other._buf) : nullptr) {}
+    NetBuf(NetBuf&& other) noexcept : _buf(other.Release()) {}
+
+    ~NetBuf() noexcept { Reset(); }
+
+    // Takes other by value, which covers both copy and move assignment.
+    NetBuf& operator=(NetBuf other) noexcept {
+        ztd::swap(_buf, other._buf);
+        return *this;
+    }
+
+    // Drops the reference. If it was the last, the buffer returns to its pool, and so does the rest of the chain
+    // unless other references to it are held.
+    void Reset() noexcept {
+        if (_buf != nullptr) {
+            net_buf_unref(_buf);
+            _buf = nullptr;
+        }
+    }
+
+    // Gives up the reference without dropping it, e.g. to hand the buffer to a driver.
+    struct net_buf* Release() noexcept {
+        struct net_buf* buf = _buf;
+        _buf = nullptr;
+        return buf;
+    }
+
+    struct net_buf* Get() const noexcept { return _buf; }
+    explicit operator bool() const noexcept { return _buf != nullptr; }
+
+    // The functions below apply to the first fragment, and the NetBuf must not be empty.
+
+    ztd::span<uint8_t> Data() const noexcept { return ztd::span<uint8_t>(_buf->data, _buf->len); }
+    size_t Size() const noexcept { return _buf->len; }
+    // The size of the whole data block, including headroom and tailroom.
+    size_t Capacity() const noexcept { return _buf->size; }
+    size_t Headroom() const noexcept { return net_buf_headroom(_buf); }
+    size_t Tailroom() const noexcept { return net_buf_tailroom(_buf); }
+
+    // Keeps headroom bytes in front of the data for headers pushed later. Only valid while the buffer is empty.
+    bool Reserve(size_t headroom) noexcept {
+        if (_buf->len != 0 || headroom > _buf->size) {
+            return false;
+        }
+        net_buf_reserve(_buf, headroom);
+        return true;
+    }
+
+    // Extends the data at the end by len bytes, and returns them to be filled in.
+    // Returns an empty span if there is not enough tailroom.
+    ztd::span<uint8_t> Add(size_t len) noexcept {
+        if (len > Tailroom()) {
+            return ztd::span<uint8_t>();
+        }
+        return ztd::span<uint8_t>(static_cast<uint8_t*>(net_buf_add(_buf, len)), len);
+    }
+
+    // Copies bytes to the end of the data. Returns false, adding nothing, if there is not enough tailroom.
+    bool Add(ztd::span<const uint8_t> bytes) noexcept {
+        if (bytes.size() > Tailroom()) {
+            return false;
+        }
+        net_buf_add_mem(_buf, bytes.data(), bytes.size());
+        return true;
+    }
+
+    bool AddU8(uint8_t val) noexcept { return _Fits(Tailroom(), 1) && (net_buf_add_u8(_buf, val), true); }
+    bool AddLe16(uint16_t val) noexcept { return _Fits(Tailroom(), 2) && (net_buf_add_le16(_buf, val), true); }
+    bool AddBe16(uint16_t val) noexcept { return _Fits(Tailroom(), 2) && (net_buf_add_be16(_buf, val), true); }
+    bool AddLe32(uint32_t val) noexcept { return _Fits(Tailroom(), 4) && (net_buf_add_le32(_buf, val), true); }
+    bool AddBe32(uint32_t val) noexcept { return _Fits(Tailroom(), 4) && (net_buf_add_be32(_buf, val), true); }
+
+    // Removes len bytes from the end of the data, and returns them. Returns an empty span if there are fewer.
+    ztd::span<uint8_t> Remove(size_t len) noexcept {
+        if (len > Size()) {
+            return ztd::span<uint8_t>();
+        }
+        return ztd::span<uint8_t>(static_cast<uint8_t*>(net_buf_remove_mem(_buf, len)), len);
+    }
+
+    // Extends the data at the front by len bytes from the headroom, e.g. for a header, and returns them to be filled in.
+    // Returns an empty span if there is not enough headroom.
+    ztd::span<uint8_t> Push(size_t len) noexcept {
+        if (len > Headroom()) {
+            return ztd::span<uint8_t>();
+        }
+        return ztd::span<uint8_t>(static_cast<uint8_t*>(net_buf_push(_buf, len)), len);
+    }
+
+    bool PushU8(uint8_t val) noexcept { return _Fits(Headroom(), 1) && (net_buf_push_u8(_buf, val), true); }
+    bool PushLe16(uint16_t val) noexcept { return _Fits(Headroom(), 2) && (net_buf_push_le16(_buf, val), true); }
+    bool PushBe16(uint16_t val) noexcept { return _Fits(Headroom(), 2) && (net_buf_push_be16(_buf, val), true); }
+
+    // Consumes len bytes from the front of the data, e.g. a header, and returns them. They stay valid until the space
+    // is pushed again. Returns an empty span if there are fewer.
+    ztd::span<const uint8_t> Pull(size_t len) noexcept {
+        if (len > Size()) {
+            return ztd::span<const uint8_t>();
+        }
+        return ztd::span<const uint8_t>(static_cast<const uint8_t*>(net_buf_pull_mem(_buf, len)), len);
+    }
+
+    // Each returns false, consuming nothing, if there are too few bytes.
+    bool PullU8(uint8_t& val) noexcept { return _Fits(Size(), 1) && ((val = net_buf_pull_u8(_buf)), true); }
+    bool PullLe16(uint16_t& val) noexcept { return _Fits(Size(), 2) && ((val = net_buf_pull_le16(_buf)), true); }
+    bool PullBe16(uint16_t& val) noexcept { return _Fits(Size(), 2) && ((val = net_buf_pull_be16(_buf)), true); }
+    bool PullLe32(uint32_t& val) noexcept { return _Fits(Size(), 4) && ((val = net_buf_pull_le32(_buf)), true); }
+    bool PullBe32(uint32_t& val) noexcept { return _Fits(Size(), 4) && ((val = net_buf_pull_be32(_buf)), true); }
+
+    // Fragments. A frame can be built from several buffers, e.g. a header buffer and payload buffers,
+    // and is then passed and parsed as one chain, without copying the fragments into one block.
+
+    // Adds fragment, and the fragments chained after it, at the end of the chain. Takes over the reference.
+    // If this NetBuf is empty, fragment becomes the head.
+    void Append(NetBuf&& fragment) noexcept {
+        if (_buf == nullptr) {
+            _buf = fragment.Release();
+        } else if (fragment._buf != nullptr) {
+            net_buf_frag_add(_buf, fragment.Release());
+        }
+    }
+
+    // Drops the first fragment, so that the next one becomes the head. Returns false if the chain is now empty.
+    // The first fragment is unlinked from the rest of the chain, including for other references to it.
+    bool PopFront() noexcept {
+        if (_buf != nullptr) {
+            _buf = net_buf_frag_del(nullptr, _buf);
+        }
+        return _buf != nullptr;
+    }
+
+    // The bytes of data in the whole chain.
+    size_t TotalSize() const noexcept { return (_buf != nullptr) ? net_buf_frags_len(_buf) : 0; }
+
+    // Copies bytes of the chain from offset into dst, across fragments. Returns the number copied.
+    // For a header which must be contiguous; payloads are better walked through Fragments() or a NetBufReader.
+    size_t CopyOut(ztd::span<uint8_t> dst, size_t offset = 0) const noexcept {
+        return (_buf != nullptr) ? net_buf_linearize(dst.data(), dst.size(), _buf, offset, dst.size()) : 0;
+    }
+
+    // Iterates over the data of each fragment of the chain.
+    class FragmentIterator final {
+    public:
+        constexpr explicit FragmentIterator(struct net_buf* buf) noexcept : _buf(buf) {}
+
+        ztd::span<uint8_t> operator*() const noexcept { return ztd::span<uint8_t>(_buf->data, _buf->len); }
+        // The fragment itself, e.g. to take a reference to it with NetBuf(net_buf_ref(it.Get())).
+        struct net_buf* Get() const noexcept { return _buf; }
+
+        FragmentIterator& operator++() noexcept {
+            _buf = _buf->frags;
+            return *this;
+        }
+
+        bool operator==(const FragmentIterator& other) const noexcept { return _buf == other._buf; }
+        bool operator!=(const FragmentIterator& other) const noexcept { return _buf != other._buf; }
+
+    private:
+        struct net_buf* _buf;
+    };
+
+    struct FragmentRange {
+        FragmentIterator first;
+        FragmentIterator last;
+        FragmentIterator begin() const noexcept { return first; }
+        FragmentIterator end() const noexcept { return last; }
+    };
+
+    FragmentRange Fragments() const noexcept { return FragmentRange {FragmentIterator(_buf), FragmentIterator(nullptr)}; }
+
+private:
+    struct net_buf* _buf;
+
+    static bool _Fits(size_t room, size_t len) noexcept { return len <= room; }
+};
+
+// Reads a chain of fragments in order, across fragment boundaries, without modifying or copying the chain.
+// The chain must outlive the reader and not change while it is read.
+class NetBufReader final {
+public:
+    explicit NetBufReader(const NetBuf& buf) noexcept : _frag(buf.Get()), _offset(0) { _SkipEmpty(); }
+
+    // The bytes left to read.
+    size_t Remaining() const noexcept {
+        return (_frag != nullptr) ? net_buf_frags_len(_frag) - _offset : 0;
+    }
+
+    // The unread bytes of the current fragment, which can be used in place. Skip() past them to move on.
+    ztd::span<const uint8_t> Contiguous() const noexcept {
+        return (_frag != nullptr) ? ztd::span<const uint8_t>(_frag->data + _offset, _frag->len - _offset)
+                                  : ztd::span<const uint8_t>();
+    }
+
+    // Copies the next dst.size() bytes into dst. Returns false, reading nothing, if there are fewer.
+    bool Read(ztd::span<uint8_t> dst) noexcept {
+        if (dst.size() > Remaining()) {
+            return false;
+        }
+        size_t copied = 0;
+        while (copied < dst.size()) {
+            const ztd::span<const uint8_t> available = Contiguous();
+            const ztd::span<const uint8_t> chunk = available.first(ztd::min(dst.size() - copied, available.size()));
+            ztd::copy(chunk.begin(), chunk.end(), dst.begin() + copied);
+            copied += chunk.size();
+            _Advance(chunk.size());
+        }
+        return true;
+    }
+
+    // Returns false, skipping nothing, if there are fewer than len bytes.
+    bool Skip(size_t len) noexcept {
+        if (len > Remaining()) {
+            return false;
+        }
+        while (len > 0) {
+            const size_t chunk = ztd::min(len, Contiguous().size());
+            _Advance(chunk);
+            len -= chunk;
+        }
+        return true;
+    }
+
+    bool ReadU8(uint8_t& val) noexcept { return Read(ztd::span<uint8_t>(&val, 1)); }
+
+    bool ReadLe16(uint16_t& val) noexcept { return _ReadInteger(val, false); }
+    bool ReadBe16(uint16_t& val) noexcept { return _ReadInteger(val, true); }
+    bool ReadLe32(uint32_t& val) noexcept { return _ReadInteger(val, false); }
+    bool ReadBe32(uint32_t& val) noexcept { return _ReadInteger(val, true); }
+
+private:
+    struct net_buf* _frag;
+    size_t _offset;
+
+    void _SkipEmpty() noexcept {
+        while (_frag != nullptr && _offset == _frag->len) {
+            _frag = _frag->frags;
+            _offset = 0;
+        }
+    }
+
+    void _Advance(size_t len) noexcept {
+        _offset += len;
+        _SkipEmpty();
+    }
+
+    template <typename Integer>
+    bool _ReadInteger(Integer& val, bool bigEndian) noexcept {
+        uint8_t bytes[sizeof(Integer)];
+        if (!Read(ztd::span<uint8_t>(bytes, sizeof(bytes)))) {
+            return false;
+        }
+        val = 0;
+        for (size_t i = 0; i < sizeof(Integer); ++i) {
+            const size_t shift = 8 * (bigEndian ? sizeof(Integer) - 1 - i : i);
+            val = static_cast<Integer>(val | (static_cast<Integer>(bytes[i]) << shift));
+        }
+        return true;
+    }
+};
+
+// Allocates from a pool of Count buffers of Size bytes, which the application defines with Zephyr's macro:
+//     NET_BUF_POOL_FIXED_DEFINE(rx_pool, 16, 128, NULL);
+//     fav::NetBufPool<16, 128> rxPool(rx_pool);
+// The pool must be defined at file scope, because Zephyr finds the pool of a buffer by its place in a linker section.
+template <uint16_t Count, uint16_t Size>
+class NetBufPool final {
+public:
+    explicit NetBufPool(struct net_buf_pool& pool) noexcept : _pool(pool) {
+        __ASSERT(pool.buf_count == Count, "NetBufPool: Count does not match the pool");
+    }
+
+    static constexpr size_t Capacity() noexcept { return Count; }
+    static constexpr size_t BufferSize() noexcept { return Size; }
+
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+    size_t Available() const noexcept { return static_cast<size_t>(_pool.avail_count); }
+#endif
+
+    // Returns an empty NetBuf if no buffer became free within the timeout.
+    NetBuf Allocate(k_timeout_t timeout = K_NO_WAIT) noexcept {
+        return NetBuf(net_buf_alloc(&_pool, timeout));
+    }
+
+    // Allocates a buffer with headroom reserved, for the headers which lower layers will push in front of the data.
+    NetBuf Allocate(size_t headroom, k_timeout_t timeout = K_NO_WAIT) noexcept {
+        __ASSERT(headroom <= Size, "NetBufPool: headroom exceeds the buffer size");
+        NetBuf buf = Allocate(timeout);
+        if (buf) {
+            buf.Reserve(headroom);
+        }
+        return buf;
+    }
+
+    struct net_buf_pool& Native() noexcept { return _pool; }
+
+private:
+    struct net_buf_pool& _pool;
+};
+
+} // namespace
+
+#endif // _FAVONIUS_NETBUF_HPP_
@@ -4,11 +4,12 @@
 #include <kernel.h>
 
 // Operator new cannot throw exceptions. If insufficient memory, return NULL instead.
-[[nodiscard]] void* operator new  (size_t count) noexcept { return k_malloc(count); }
-[[nodiscard]] void* operator new[](size_t count) noexcept { return k_malloc(count); }
+// These replace the global allocation functions, so they are defined once, in source/new.cpp.
+[[nodiscard]] void* operator new  (size_t count) noexcept;
+[[nodiscard]] void* operator new[](size_t count) noexcept;
 
 // Placement new
-[[nodiscard]] void* operator new  (size_t, void* ptr) noexcept { return ptr; }
-[[nodiscard]] void* operator new[](size_t, void* ptr) noexcept { return ptr; }
+[[nodiscard]] inline void* operator new  (size_t, void* ptr) noexcept { return ptr; }
+[[nodiscard]] inline void* operator new[](size_t, void* ptr) noexcept { return ptr; }
 
-#endif // _FAVONIUS_NEW_HPP_
\ No newline at end of file
+#endif // _FAVONIUS_NEW_HPP_
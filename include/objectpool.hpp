@@ -0,0 +1,248 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_OBJECTPOOL_HPP_
+#define _FAVONIUS_OBJECTPOOL_HPP_
+
+#include <stdint.h>
+
+#include "new.hpp"
+#include "trace.hpp"
+#include "utility.hpp"
+
+namespace fav {
+
+namespace _detail {
+
+// Number of bits needed to store the values 0 to n - 1, at least 1.
+constexpr uint32_t PoolIndexBits(size_t n) noexcept {
+    uint32_t bits = 1;
+    while (bits < 32 && (static_cast<size_t>(1) << bits) < n) {
+        ++bits;
+    }
+    return bits;
+}
+
+} // namespace
+
+// Pool of up to N objects of type T, stored inline in slots which never move.
+// Objects are referred to by 32-bit handles instead of pointers: a handle holds the slot index and the generation
+// of the slot, which changes whenever an object in it is destroyed. A handle to a destroyed object is therefore
+// detected (Get() returns null) instead of reaching whatever was created in the slot afterwards.
+// The generation has 32 - PoolIndexBits(N) bits, so a stale handle is only mistaken for a live one after the slot
+// has been reused that many times over.
+// Create() and Destroy() are O(1) and never allocate. Live objects are also kept in a dense list of slots,
+// so iteration visits only live objects; Destroy() reorders that list and invalidates iterators.
+// With CONFIG_FAVONIUS_TRACING, creations and destructions are traced as allocations under the name given to SetName().
+// Member functions are NOT thread safe.
+template <typename T, size_t N>
+class ObjectPool final : public Traceable {
+    static_assert(N > 0, "The pool must have at least one slot.");
+    static_assert(N < (static_cast<size_t>(1) << 24), "At least 8 bits of the handle are needed for the generation.");
+
+    static constexpr uint32_t IndexBits = _detail::PoolIndexBits(N);
+    static constexpr uint32_t IndexMask = (static_cast<uint32_t>(1) << IndexBits) - 1;
+    static constexpr uint32_t GenerationMask = ~static_cast<uint32_t>(0) >> IndexBits;
+
+public:
+    using ValueType = T;
+
+    // Refers to an object in a pool of this type. A default-constructed handle refers to nothing.
+    class Handle final {
+    public:
+        constexpr Handle() noexcept : _value(0) {}
+
+        // The handle as a plain integer, e.g. to pass it through a C API, and back.
+        constexpr uint32_t Value() const noexcept { return _value; }
+        static constexpr Handle FromValue(uint32_t value) noexcept { return Handle(value); }
+
+        constexpr bool IsNull() const noexcept { return _value == 0; }
+        constexpr explicit operator bool() const noexcept { return _value != 0; }
+
+        constexpr bool operator==(Handle other) const noexcept { return _value == other._value; }
+        constexpr bool operator!=(Handle other) const noexcept { return _value != other._value; }
+
+    private:
+        friend class ObjectPool;
+        constexpr explicit Handle(uint32_t value) noexcept : _value(value) {}
+
+        uint32_t _value;
+    };
+
+    // Iterates over the live objects in no particular order.
+    template <typename Pool, typename Value>
+    class Iterator final {
+    public:
+        constexpr Iterator(Pool* pool, size_t position) noexcept : _pool(pool), _position(position) {}
+
+        Value& operator*() const noexcept { return _pool->_Object(_pool->_dense[_position]); }
+        Value* operator->() const noexcept { return &**this; }
+
+        // The handle of the object the iterator is at.
+        Handle GetHandle() const noexcept { return _pool->_MakeHandle(_pool->_dense[_position]); }
+
+        Iterator& operator++() noexcept {
+            ++_position;
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const noexcept { return _position == other._position; }
+        bool operator!=(const Iterator& other) const noexcept { return _position != other._position; }
+
+    private:
+        Pool* _pool;
+        size_t _position;
+    };
+
+    using iterator = Iterator<ObjectPool, T>;
+    using const_iterator = Iterator<const ObjectPool, const T>;
+
+    ObjectPool() noexcept : _size(0), _free_head(0) {
+        for (size_t i = 0; i < N; ++i) {
+            _generation[i] = 1;
+            _link[i] = static_cast<uint32_t>(i + 1);
+        }
+    }
+
+    // Objects live at fixed addresses in the pool, so it can be neither copied nor moved.
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool(ObjectPool&&) = delete;
+
+    ~ObjectPool() noexcept { Clear(); }
+
+    static constexpr size_t Capacity() noexcept { return N; }
+    size_t Size() const noexcept { return _size; }
+    bool Empty() const noexcept { return _size == 0; }
+    bool Full() const noexcept { return _size == N; }
+
+    // Constructs T in a free slot. Returns a null handle if the pool is full.
+    template <typename... Args>
+    Handle Create(Args&&... args) noexcept {
+        if (Full()) {
+            _TraceCreate(nullptr);
+            return Handle();
+        }
+        const uint32_t slot = _free_head;
+        _free_head = _link[slot];
+        T* object = new (&_storage[slot]) T(ztd::forward<Args>(args)...);
+        _link[slot] = static_cast<uint32_t>(_size);
+        _dense[_size++] = slot;
+        _TraceCreate(object);
+        return _MakeHandle(slot);
+    }
+
+    // Destroys the object. Returns false if the handle is null or stale.
+    bool Destroy(Handle handle) noexcept {
+        const uint32_t slot = _Slot(handle);
+        if (slot == N) {
+            return false;
+        }
+        T& object = _Object(slot);
+        _TraceDestroy(&object);
+        object.~T();
+
+        // Move the last entry of the dense list into the hole.
+        const uint32_t position = _link[slot];
+        const uint32_t last = _dense[--_size];
+        _dense[position] = last;
+        _link[last] = position;
+
+        // Generation 0 is never used, so that no handle has the value 0.
+        _generation[slot] = (_generation[slot] + 1) & GenerationMask;
+        if (_generation[slot] == 0) {
+            _generation[slot] = 1;
+        }
+        _link[slot] = _free_head;
+        _free_head = slot;
+        return true;
+    }
+
+    // Destroys every object. Outstanding handles all become stale.
+    void Clear() noexcept {
+        while (!Empty()) {
+            Destroy(_MakeHandle(_dense[_size - 1]));
+        }
+    }
+
+    // Whether the handle refers to a live object.
+    bool Contains(Handle handle) const noexcept { return _Slot(handle) != N; }
+
+    // Returns null if the handle is null or stale.
+    T* Get(Handle handle) noexcept {
+        const uint32_t slot = _Slot(handle);
+        return (slot != N) ? &_Object(slot) : nullptr;
+    }
+
+    const T* Get(Handle handle) const noexcept {
+        const uint32_t slot = _Slot(handle);
+        return (slot != N) ? &_Object(slot) : nullptr;
+    }
+
+    // The handle of an object in this pool, e.g. from within a member function of T.
+    // Returns a null handle if object does not live in this pool.
+    Handle GetHandle(const T& object) const noexcept {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(&object);
+        const uintptr_t first = reinterpret_cast<uintptr_t>(&_storage[0]);
+        if (address < first || address >= first + sizeof(_storage)) {
+            return Handle();
+        }
+        const uint32_t slot = static_cast<uint32_t>((address - first) / sizeof(Slot));
+        const uint32_t position = _link[slot];
+        return (position < _size && _dense[position] == slot) ? _MakeHandle(slot) : Handle();
+    }
+
+    iterator begin() noexcept { return iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, _size); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, _size); }
+
+private:
+    struct Slot {
+        alignas(T) uint8_t bytes[sizeof(T)];
+    };
+
+    Slot _storage[N];
+    // Generation of each slot, which is part of the handles to it.
+    uint32_t _generation[N];
+    // For a free slot, the next free slot (N at the end of the free list).
+    // For a live slot, its position in _dense.
+    uint32_t _link[N];
+    // Slots of the live objects, in the first _size entries.
+    uint32_t _dense[N];
+    size_t _size;
+    uint32_t _free_head;
+
+    T& _Object(uint32_t slot) noexcept { return *reinterpret_cast<T*>(&_storage[slot]); }
+    const T& _Object(uint32_t slot) const noexcept { return *reinterpret_cast<const T*>(&_storage[slot]); }
+
+    Handle _MakeHandle(uint32_t slot) const noexcept {
+        return Handle((_generation[slot] << IndexBits) | slot);
+    }
+
+    // The slot the handle refers to, or N if the handle is null or stale.
+    uint32_t _Slot(Handle handle) const noexcept {
+        const uint32_t slot = handle._value & IndexMask;
+        if (handle.IsNull() || slot >= N || _generation[slot] != (handle._value >> IndexBits)) {
+            return N;
+        }
+        // A slot keeps its generation while it is free, so make sure that it is in use.
+        const uint32_t position = _link[slot];
+        return (position < _size && _dense[position] == slot) ? slot : N;
+    }
+
+    void _TraceCreate([[maybe_unused]] const T* object) const noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::Alloc(this, Name(), sizeof(T), object);
+#endif
+    }
+
+    void _TraceDestroy([[maybe_unused]] const T* object) const noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::Free(this, Name(), sizeof(T), object);
+#endif
+    }
+};
+
+} // namespace
+
+#endif // _FAVONIUS_OBJECTPOOL_HPP_
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_PERIODIC_HPP_
+#define _FAVONIUS_PERIODIC_HPP_
+
+#include <kernel.h>
+
+#include "atomic.hpp"
+#include "chrono.hpp"
+#include "utility.hpp"
+
+namespace fav {
+
+// Releases the calling thread at a fixed period, for control loops and other periodic jobs.
+// Release times are computed from the first release rather than from the end of the previous job,
+// so the loop does not drift no matter how long each job takes.
+// With CONFIG_SCHED_DEADLINE, the thread's EDF deadline is re-armed at every release, so that among threads of equal
+// priority the one with the earliest deadline runs first.
+// Without CONFIG_TIMEOUT_64BIT the kernel has no absolute timeouts, and the sleep is computed from the current uptime;
+// a preemption between reading the uptime and going to sleep then delays that single release, but not the following ones.
+// A PeriodicTask must only be driven by one thread. The statistics may be read from any thread.
+//  fav::PeriodicTask task(ztd::milliseconds(10), ztd::milliseconds(2));
+//  task.Start();
+//  while (true) { control_step(); task.WaitForNextPeriod(); }
+class PeriodicTask final {
+public:
+    // The relative deadline is measured from each release. It defaults to the period.
+    template <typename Rep, uint64_t Num, uint64_t Denom>
+    explicit PeriodicTask(const ztd::duration<Rep, Num, Denom>& period) noexcept
+        : PeriodicTask(ztd::ceil<Ticks>(period), ztd::ceil<Ticks>(period)) {}
+
+    template <typename Rep1, uint64_t Num1, uint64_t Denom1, typename Rep2, uint64_t Num2, uint64_t Denom2>
+    PeriodicTask(const ztd::duration<Rep1, Num1, Denom1>& period, const ztd::duration<Rep2, Num2, Denom2>& deadline) noexcept
+        : PeriodicTask(ztd::ceil<Ticks>(period), ztd::ceil<Ticks>(deadline)) {}
+
+    PeriodicTask(Ticks period, Ticks deadline) noexcept;
+    PeriodicTask(const PeriodicTask&) = delete;
+    PeriodicTask(PeriodicTask&&) = delete;
+
+    // Makes now the first release and arms the deadline of the first job. Call from the periodic thread.
+    void Start() noexcept;
+
+    // Ends the current job and sleeps until the next release.
+    // Returns false if the job that just ended missed its deadline.
+    // A job which runs past the next release is an overrun; releases that have already passed are skipped,
+    // so that the task stays in phase instead of running several jobs back to back to catch up.
+    bool WaitForNextPeriod() noexcept;
+
+    // Runs job once per period until it returns false.
+    template <typename Job>
+    void Run(Job&& job) noexcept {
+        Start();
+        while (job()) {
+            WaitForNextPeriod();
+        }
+    }
+
+    Ticks Period() const noexcept { return _period; }
+    Ticks Deadline() const noexcept { return _deadline; }
+
+    // Number of jobs released since Start(), including the current one.
+    uint32_t Activations() const noexcept { return _activations.load(ztd::memory_order_relaxed); }
+    // Number of jobs which ended after their deadline.
+    uint32_t DeadlineMisses() const noexcept { return _misses.load(ztd::memory_order_relaxed); }
+    // Number of jobs which ended after the following release.
+    uint32_t Overruns() const noexcept { return _overruns.load(ztd::memory_order_relaxed); }
+    // Number of releases skipped because of overruns.
+    uint32_t SkippedReleases() const noexcept { return _skipped.load(ztd::memory_order_relaxed); }
+    // The longest delay between a release time and the thread actually waking up, in ticks.
+    Ticks MaxReleaseJitter() const noexcept { return Ticks(_max_jitter.load(ztd::memory_order_relaxed)); }
+
+    void ResetStatistics() noexcept;
+
+private:
+    const Ticks _period;
+    const Ticks _deadline;
+    int64_t _release; // Current release, in ticks since boot.
+
+    ztd::atomic<uint32_t> _activations;
+    ztd::atomic<uint32_t> _misses;
+    ztd::atomic<uint32_t> _overruns;
+    ztd::atomic<uint32_t> _skipped;
+    ztd::atomic<uint32_t> _max_jitter;
+
+    void _ArmDeadline(int64_t now) noexcept;
+};
+
+} // namespace
+
+#endif // _FAVONIUS_PERIODIC_HPP_
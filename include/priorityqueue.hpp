@@ -0,0 +1,272 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_PRIORITYQUEUE_HPP_
+#define _FAVONIUS_PRIORITYQUEUE_HPP_
+
+#include <stdint.h>
+
+#include "functional.hpp"
+#include "span.hpp"
+#include "trace.hpp"
+#include "utility.hpp"
+
+namespace fav {
+
+// Priority queue of up to N entries of type T, stored inline as a 4-ary heap.
+// As with std::priority_queue, Top() is the greatest entry according to Compare; use ztd::greater<T> to get the
+// smallest first, e.g. the earliest deadline. Entries which compare equal leave in no particular order.
+// Push(), Pop(), Update() and Remove() are O(log N) and Top() is O(1). Assign() builds the heap in O(N).
+// A 4-ary heap is half as deep as a binary heap, and the children of an entry are next to each other in memory.
+// Each pushed entry has a handle which stays valid until the entry leaves the queue, through which its priority can be
+// changed (e.g. decrease-key) or the entry removed. Handles of entries which have left are detected as stale.
+// Template parameter T should be default-nothrow-constructible and movable.
+// With CONFIG_FAVONIUS_TRACING, pushes and pops are traced with the size of the queue, under the name given to SetName().
+// Member functions are NOT thread safe.
+template <typename T, size_t N, typename Compare = ztd::less<T>>
+class PriorityQueue final : public Traceable {
+    static_assert(N > 0, "The queue must have at least one entry.");
+
+    static constexpr size_t Arity = 4;
+
+public:
+    using ValueType = T;
+
+    // Refers to an entry in a queue of this type. A default-constructed handle refers to nothing.
+    class Handle final {
+    public:
+        constexpr Handle() noexcept : _slot(N), _generation(0) {}
+
+        constexpr bool IsNull() const noexcept { return _slot == N; }
+        constexpr explicit operator bool() const noexcept { return _slot != N; }
+
+        constexpr bool operator==(Handle other) const noexcept {
+            return (_slot == other._slot) && (_generation == other._generation);
+        }
+        constexpr bool operator!=(Handle other) const noexcept { return !(*this == other); }
+
+    private:
+        friend class PriorityQueue;
+        constexpr Handle(uint32_t slot, uint32_t generation) noexcept : _slot(slot), _generation(generation) {}
+
+        uint32_t _slot;
+        uint32_t _generation;
+    };
+
+    explicit PriorityQueue(const Compare& compare = Compare()) noexcept : _compare(compare) { Clear(); }
+
+    static constexpr size_t Capacity() noexcept { return N; }
+    size_t Size() const noexcept { return _size; }
+    bool Empty() const noexcept { return _size == 0; }
+    bool Full() const noexcept { return _size == N; }
+
+    // Removes every entry. Outstanding handles all become stale.
+    void Clear() noexcept {
+        for (size_t i = 0; i < _size; ++i) {
+            ++_generation[_heap[i].slot];
+        }
+        _size = 0;
+        for (size_t i = 0; i < N; ++i) {
+            _link[i] = static_cast<uint32_t>(i + 1);
+        }
+        _free_head = 0;
+    }
+
+    // The greatest entry. The queue must not be empty.
+    const T& Top() const noexcept { return _heap[0].value; }
+
+    // Returns a null handle if the queue is full.
+    Handle Push(const T& value) noexcept {
+        T copy = value;
+        return Push(ztd::move(copy));
+    }
+
+    Handle Push(T&& value) noexcept {
+        if (Full()) {
+            return Handle();
+        }
+        const uint32_t slot = _free_head;
+        _free_head = _link[slot];
+        const size_t position = _size++;
+        _heap[position].value = ztd::move(value);
+        _heap[position].slot = slot;
+        _link[slot] = static_cast<uint32_t>(position);
+        _SiftUp(position);
+        _TracePush();
+        return Handle(slot, _generation[slot]);
+    }
+
+    // Constructs T and then calls Push.
+    template <typename... Args>
+    Handle Emplace(Args&&... args) noexcept {
+        T value(ztd::forward<Args>(args)...);
+        return Push(ztd::move(value));
+    }
+
+    // Removes and returns the greatest entry. The queue must not be empty.
+    T Pop() noexcept {
+        T value = ztd::move(_heap[0].value);
+        _Erase(0);
+        _TracePop();
+        return value;
+    }
+
+    // Whether the handle refers to an entry in the queue.
+    bool Contains(Handle handle) const noexcept { return _Position(handle) != N; }
+
+    // Returns null if the handle is null or stale.
+    const T* Get(Handle handle) const noexcept {
+        const size_t position = _Position(handle);
+        return (position != N) ? &_heap[position].value : nullptr;
+    }
+
+    // Replaces the entry, and moves it up or down the heap as its priority requires.
+    // This covers both decrease-key and increase-key. Returns false if the handle is null or stale.
+    bool Update(Handle handle, T value) noexcept {
+        const size_t position = _Position(handle);
+        if (position == N) {
+            return false;
+        }
+        _heap[position].value = ztd::move(value);
+        _Restore(position);
+        return true;
+    }
+
+    // Removes the entry, e.g. to cancel an event. Returns false if the handle is null or stale.
+    bool Remove(Handle handle) noexcept {
+        const size_t position = _Position(handle);
+        if (position == N) {
+            return false;
+        }
+        _Erase(position);
+        _TracePop();
+        return true;
+    }
+
+    // Replaces the contents with the first N values, and builds the heap from them in O(N) rather than O(N log N).
+    // If handles is not empty, the handle of values[i] is stored in handles[i], as far as both go.
+    // Returns the number of values taken.
+    size_t Assign(ztd::span<const T> values, ztd::span<Handle> handles = {}) noexcept {
+        Clear();
+        const size_t count = (values.size() < N) ? values.size() : N;
+        for (size_t i = 0; i < count; ++i) {
+            _heap[i].value = values[i];
+            _heap[i].slot = static_cast<uint32_t>(i);
+            _link[i] = static_cast<uint32_t>(i);
+            if (i < handles.size()) {
+                handles[i] = Handle(static_cast<uint32_t>(i), _generation[i]);
+            }
+        }
+        _size = count;
+        _free_head = static_cast<uint32_t>(count);
+        for (size_t i = (_size > 0) ? _size / Arity + 1 : 0; i > 0; --i) {
+            _SiftDown(i - 1);
+        }
+        _TracePush();
+        return count;
+    }
+
+private:
+    struct Entry {
+        T value;
+        uint32_t slot;
+    };
+
+    // The heap, in the first _size entries.
+    Entry _heap[N];
+    // For a slot in use, the position of its entry in _heap. For a free slot, the next free slot (N at the end).
+    uint32_t _link[N];
+    // Incremented whenever the entry of a slot leaves the queue, so that its handles become stale.
+    uint32_t _generation[N] = {};
+    size_t _size = 0;
+    uint32_t _free_head = 0;
+    Compare _compare;
+
+    // The position of the entry the handle refers to, or N if the handle is null or stale.
+    size_t _Position(Handle handle) const noexcept {
+        if (handle._slot >= N || _generation[handle._slot] != handle._generation) {
+            return N;
+        }
+        // A slot keeps its generation while it is free, so make sure that it is in use.
+        const size_t position = _link[handle._slot];
+        return (position < _size && _heap[position].slot == handle._slot) ? position : N;
+    }
+
+    void _Place(size_t position, Entry&& entry) noexcept {
+        _link[entry.slot] = static_cast<uint32_t>(position);
+        _heap[position] = ztd::move(entry);
+    }
+
+    void _SiftUp(size_t position) noexcept {
+        Entry entry = ztd::move(_heap[position]);
+        while (position > 0) {
+            const size_t parent = (position - 1) / Arity;
+            if (!_compare(_heap[parent].value, entry.value)) {
+                break;
+            }
+            _Place(position, ztd::move(_heap[parent]));
+            position = parent;
+        }
+        _Place(position, ztd::move(entry));
+    }
+
+    void _SiftDown(size_t position) noexcept {
+        Entry entry = ztd::move(_heap[position]);
+        while (true) {
+            const size_t first = position * Arity + 1;
+            if (first >= _size) {
+                break;
+            }
+            const size_t last = (first + Arity < _size) ? first + Arity : _size;
+            size_t greatest = first;
+            for (size_t child = first + 1; child < last; ++child) {
+                if (_compare(_heap[greatest].value, _heap[child].value)) {
+                    greatest = child;
+                }
+            }
+            if (!_compare(entry.value, _heap[greatest].value)) {
+                break;
+            }
+            _Place(position, ztd::move(_heap[greatest]));
+            position = greatest;
+        }
+        _Place(position, ztd::move(entry));
+    }
+
+    // Moves the entry at position up or down, after its value changed.
+    void _Restore(size_t position) noexcept {
+        if (position > 0 && _compare(_heap[(position - 1) / Arity].value, _heap[position].value)) {
+            _SiftUp(position);
+        } else {
+            _SiftDown(position);
+        }
+    }
+
+    void _Erase(size_t position) noexcept {
+        const uint32_t slot = _heap[position].slot;
+        ++_generation[slot];
+        _link[slot] = _free_head;
+        _free_head = slot;
+        --_size;
+        if (position != _size) {
+            _Place(position, ztd::move(_heap[_size]));
+            _Restore(position);
+        }
+    }
+
+    void _TracePush() const noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::QueuePush(this, Name(), _size, N);
+#endif
+    }
+
+    void _TracePop() const noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::QueuePop(this, Name(), _size, N);
+#endif
+    }
+};
+
+} // namespace
+
+#endif // _FAVONIUS_PRIORITYQUEUE_HPP_
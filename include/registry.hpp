@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_REGISTRY_HPP_
+#define _FAVONIUS_REGISTRY_HPP_
+
+#include <sys/slist.h>
+#include <kernel.h>
+
+namespace fav {
+namespace _detail {
+
+// An intrusive list of the live instances of a statistics type (LockStats, LatencyHistogram), for the dumps and the
+// shell commands which walk them.
+// Links are edited under a k_spinlock, so registration is short and never preempted. A walk holds a k_mutex, so the
+// callback may print or block; removal takes the same mutex, so the instance being visited stays valid.
+// A Registry has no constructor, so one with static storage duration is zero-initialized and ready to use before any
+// static constructor registers with it. Instances must be created and destroyed by threads in supervisor mode, which
+// can lock interrupts, and never by ISRs.
+class Registry final {
+public:
+    void Add(sys_snode_t* node) noexcept;
+    void Remove(sys_snode_t* node) noexcept;
+
+    // Calls fn for every node. Nodes must not be added or removed from within fn.
+    void ForEach(void (*fn)(sys_snode_t* node, void* user_data), void* user_data) noexcept;
+
+private:
+    sys_slist_t _list;
+    struct k_spinlock _lock;
+    struct k_mutex _walk;
+    bool _walk_ready; // _walk is initialized on first use, under _lock.
+
+    void _LockWalk() noexcept;
+};
+
+} // namespace
+} // namespace
+
+#endif // _FAVONIUS_REGISTRY_HPP_
@@ -7,93 +7,175 @@
 #include <sys/ring_buffer.h>
 #include <kernel.h>
 
+#include "algorithm.hpp"
 #include "memory.hpp"
+#include "span.hpp"
+#include "trace.hpp"
 
 namespace fav {
 
 // Fix-sized ring buffer.
 // Template parameter T should be default-nothrow-constructible and copiable. (Can lead to undefined behaviours in Peek() if not copiable)
 // Template parameter N is the maximum number of entries.
+// Entries are copied as bytes, so the bulk and zero-copy APIs (spans of entries) need no per-entry work.
+// With CONFIG_FAVONIUS_TRACING, pushes and pops are traced with the fill level, under the name given to SetName().
 // TODO incomplete.
-template <typename T = uint32_t, uint32_t Size = 16>
-struct RingBuffer final {
+template <typename T = uint32_t, uint32_t N = 16>
+struct RingBuffer final : public Traceable {
 public:
     using ValueType = T;
-    constexpr static uint32_t BufferSizeBytes = sizeof(T) * Size;
+    constexpr static uint32_t BufferSizeBytes = sizeof(T) * N;
 
     RingBuffer() noexcept {
-        ring_buf_init(&_ring_buf, Size, _ring_buf_data);
+        ring_buf_init(&_ring_buf, BufferSizeBytes, _ring_buf_data);
     }
+    // The ring_buf points into this object's own storage, so it can be neither copied nor moved.
     RingBuffer(const RingBuffer&) = delete;
-    RingBuffer(RingBuffer&& other) noexcept : _buf(other._buf) {
-        other = RingBuffer();
-    }
+    RingBuffer(RingBuffer&&) = delete;
 
     void Reset() noexcept {
-        _buf = ring_buf_reset(_buf);
+        ring_buf_reset(&_ring_buf);
     }
 
     // Get the maximum capacity of the buffer, in terms of number of entries,
     uint32_t Capacity() const noexcept {
-        return ring_buf_capacity_get(_buf) / sizeof(T);
+        return ring_buf_capacity_get(&_ring_buf) / sizeof(T);
     }
 
     // Get the number of entries filled so far.
     uint32_t Size() const noexcept {
-        return ring_buf_size_get(_buf) / sizeof(T);
+        return ring_buf_size_get(&_ring_buf) / sizeof(T);
     }
 
     // Get the amount of free entry slots.
     uint32_t FreeSpace() const noexcept {
-        return ring_buf_space_get(_buf) / sizeof(T);
+        return ring_buf_space_get(&_ring_buf) / sizeof(T);
     }
 
     bool Empty() const noexcept {
-        return ring_buf_is_empty(_buf);
+        return ring_buf_is_empty(&_ring_buf);
     }
 
     // Copy data into this ring buffer.
     void Push(const T& data) noexcept {
-        uint32_t bytes_put = ring_buf_put(_buf, static_cast<uint8_t*>(&data), sizeof(T));
+        [[maybe_unused]] uint32_t bytes_put = ring_buf_put(&_ring_buf, reinterpret_cast<const uint8_t*>(&data), sizeof(T));
         __ASSERT(bytes_put == sizeof(T), "Insufficient space in ring buffer.");
+        _TracePush();
     }
 
     // Write the first value from the read end of this RingBuffer into the provided object.
     // The value in this RingBuffer is then removed.
-    void Pop(T& value) const noexcept {
-        uint32_t bytes_get = ring_buf_get(_buf, static_cast<uint8_t*>(&value), sizeof(T));
+    void Pop(T& value) noexcept {
+        [[maybe_unused]] uint32_t bytes_get = ring_buf_get(&_ring_buf, reinterpret_cast<uint8_t*>(&value), sizeof(T));
         __ASSERT(bytes_get == sizeof(T), "Fewer bytes were fetched than expected.");
+        _TracePop();
     }
 
     // Discard the first read value.
-    void Pop() const noexcept {
-        uint32_t bytes_get = ring_buf_get(_buf, NULL, sizeof(T));
+    void Pop() noexcept {
+        [[maybe_unused]] uint32_t bytes_get = ring_buf_get(&_ring_buf, NULL, sizeof(T));
+        _TracePop();
     }
 
     // Retrieve the entry from the reading end, without removal.
     uint32_t Peek(T* data) const noexcept {
-        return ring_buf_peek(_buf, static_cast<uint8_t*>(data), sizeof(T));
+        return ring_buf_peek(&_ring_buf, reinterpret_cast<uint8_t*>(data), sizeof(T));
     }
 
     // Retrieve a copy of the entry from the reading end, without removal.
     T Peek() const noexcept {
         T value;
-        uint32_t bytes_peek = ring_buf_peek(_buf, static_cast<uint8_t*>(&value), sizeof(T));
+        [[maybe_unused]] uint32_t bytes_peek = ring_buf_peek(&_ring_buf, reinterpret_cast<uint8_t*>(&value), sizeof(T));
         __ASSERT(bytes_peek == sizeof(T), "Fewer bytes were fetched than expected.");
         return T(value); // Explicit copy, we do not want to move
     }
 
+    // Copies as many entries from the front of values as there is space for.
+    // Returns the number of entries written.
+    uint32_t Write(ztd::span<const T> values) noexcept {
+        const uint32_t count = ztd::min(static_cast<uint32_t>(values.size()), FreeSpace());
+        [[maybe_unused]] uint32_t bytes_put = ring_buf_put(&_ring_buf, reinterpret_cast<const uint8_t*>(values.data()), count * sizeof(T));
+        __ASSERT(bytes_put == count * sizeof(T), "Fewer bytes were written than expected.");
+        _TracePush();
+        return count;
+    }
+
+    // Moves as many entries as are available, up to the size of values, out of this RingBuffer.
+    // Returns the front of values which was filled.
+    ztd::span<T> Read(ztd::span<T> values) noexcept {
+        const uint32_t count = ztd::min(static_cast<uint32_t>(values.size()), Size());
+        [[maybe_unused]] uint32_t bytes_get = ring_buf_get(&_ring_buf, reinterpret_cast<uint8_t*>(values.data()), count * sizeof(T));
+        __ASSERT(bytes_get == count * sizeof(T), "Fewer bytes were fetched than expected.");
+        _TracePop();
+        return values.first(count);
+    }
+
+    // Like Read(), but without removal.
+    // Named apart from Peek(T*), which a C array argument would otherwise decay to.
+    ztd::span<T> PeekMany(ztd::span<T> values) const noexcept {
+        const uint32_t count = ztd::min(static_cast<uint32_t>(values.size()), Size());
+        [[maybe_unused]] uint32_t bytes_peek = ring_buf_peek(&_ring_buf, reinterpret_cast<uint8_t*>(values.data()), count * sizeof(T));
+        __ASSERT(bytes_peek == count * sizeof(T), "Fewer bytes were fetched than expected.");
+        return values.first(count);
+    }
+
+    // Zero-copy writing. Returns up to max_count free slots, which are contiguous in the buffer and so may be fewer
+    // than FreeSpace() when they wrap around. Fill them in place, then commit them with PutFinish().
+    // Only one claim may be outstanding at a time.
+    ztd::span<T> PutClaim(uint32_t max_count) noexcept {
+        uint8_t* data = nullptr;
+        const uint32_t bytes = ring_buf_put_claim(&_ring_buf, &data, max_count * sizeof(T));
+        return ztd::span<T>(reinterpret_cast<T*>(data), bytes / sizeof(T));
+    }
+
+    // Commits the first count slots of the last PutClaim(), and returns the rest.
+    // Returns false if count exceeds the claim.
+    bool PutFinish(uint32_t count) noexcept {
+        const bool committed = (ring_buf_put_finish(&_ring_buf, count * sizeof(T)) == 0);
+        _TracePush();
+        return committed;
+    }
+
+    // Zero-copy reading. Returns up to max_count entries, which are contiguous in the buffer and so may be fewer
+    // than Size() when they wrap around. Release them with GetFinish() once consumed.
+    // Only one claim may be outstanding at a time.
+    ztd::span<const T> GetClaim(uint32_t max_count) noexcept {
+        uint8_t* data = nullptr;
+        const uint32_t bytes = ring_buf_get_claim(&_ring_buf, &data, max_count * sizeof(T));
+        return ztd::span<const T>(reinterpret_cast<const T*>(data), bytes / sizeof(T));
+    }
+
+    // Removes the first count entries of the last GetClaim(). Returns false if count exceeds the claim.
+    bool GetFinish(uint32_t count) noexcept {
+        const bool released = (ring_buf_get_finish(&_ring_buf, count * sizeof(T)) == 0);
+        _TracePop();
+        return released;
+    }
+
     // Constructs T and then calls Push.
     // No special in-place construction semantics, this is for convenience only.
     template <typename... Args>
-    void Emplace(Args&&... args) noexcept(noexcept(T(std::forward<Args>(args)...))) {
-        T value(std::forward<Args>(args)...);
+    void Emplace(Args&&... args) noexcept(noexcept(T(ztd::forward<Args>(args)...))) {
+        T value(ztd::forward<Args>(args)...);
         Push(value);
     }
     
 private:
-    struct ring_buf _ring_buf;
-    uint32_t _ring_buf_data[1U << Size];
+    // The ring_buf accessors take a non-const pointer even when they only read.
+    mutable struct ring_buf _ring_buf;
+    alignas(T) uint8_t _ring_buf_data[BufferSizeBytes];
+
+    void _TracePush() const noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::QueuePush(this, Name(), Size(), Capacity());
+#endif
+    }
+
+    void _TracePop() const noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::QueuePop(this, Name(), Size(), Capacity());
+#endif
+    }
 };
 
 } // namespace
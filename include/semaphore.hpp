@@ -6,57 +6,171 @@
 
 #include <kernel.h>
 
-// This header implements the C++20 counting_semaphore on top of semaphore primitives from Zephyr.
+#include "atomic.hpp"
+#include "chrono.hpp"
+#include "futex.hpp"
+#include "lockstat.hpp"
+
+// This header implements the C++20 counting_semaphore.
 // See https://en.cppreference.com/w/cpp/thread/counting_semaphore
+// k_sem can only be given one count per call, so the count is kept in a fav::Futex word instead:
+// acquiring an available count and releasing with no waiters never enter the kernel,
+// and release(n) wakes the waiters with a single kernel call regardless of n. release() may be called from an ISR.
 
 namespace ztd {
 
+namespace _detail {
+
+class counting_semaphore_impl final {
+public:
+    explicit counting_semaphore_impl(int32_t desired) noexcept : _count(desired), _waiters(0), _bulk_waiters(0) {}
+    counting_semaphore_impl(const counting_semaphore_impl&) = delete;
+
+    bool try_acquire(int32_t n) noexcept {
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+        const uint32_t start = k_cycle_get_32();
+        if (!_TryTake(n)) {
+            _stats.RecordFailedAttempt();
+            return false;
+        }
+        _stats.RecordAcquisition(start, false);
+        return true;
+#else
+        return _TryTake(n);
+#endif
+    }
+
+    // Returns false if timeout elapsed before n counts could be taken.
+    bool acquire(int32_t n, k_timeout_t timeout) noexcept {
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+        const uint32_t start = k_cycle_get_32();
+        const bool contended = !_TryTake(n);
+        if (contended && !_AcquireContended(n, timeout)) {
+            _stats.RecordFailedAttempt();
+            return false;
+        }
+        _stats.RecordAcquisition(start, contended);
+        return true;
+#else
+        return _TryTake(n) || _AcquireContended(n, timeout);
+#endif
+    }
+
+    void release(int32_t n) noexcept {
+        atomic_add(_count.Word(), n);
+        if (_waiters.load() > 0) {
+            _Wake(n);
+        }
+    }
+
+    int32_t count() const noexcept {
+        return _count.Load();
+    }
+
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    fav::LockStats& stats() noexcept { return _stats; }
+    const fav::LockStats& stats() const noexcept { return _stats; }
+#endif
+
+private:
+    fav::Futex _count;
+    ztd::atomic<uint32_t> _waiters;
+    ztd::atomic<uint32_t> _bulk_waiters; // Waiters for more than one count.
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    fav::LockStats _stats;
+#endif
+
+    bool _TryTake(int32_t n) noexcept {
+        atomic_val_t count = _count.Load();
+        while (count >= n) {
+            if (atomic_cas(_count.Word(), count, count - n)) {
+                return true;
+            }
+            count = _count.Load();
+        }
+        return false;
+    }
+
+    bool _AcquireContended(int32_t n, k_timeout_t timeout) noexcept;
+    void _Wake(int32_t n) noexcept;
+};
+
+} // namespace _detail
+
 template <int32_t LeastMaxValue>
 class counting_semaphore {
 public:
-    constexpr explicit counting_semaphore(int32_t desired) noexcept {
-        [[maybe_unused]] int ec = k_sem_init(&_sem, desired, LeastMaxValue);
-    }
+    explicit counting_semaphore(int32_t desired) noexcept : _impl(desired) {}
     counting_semaphore(const counting_semaphore&) = delete;
-    ~counting_semaphore() noexcept {
-        k_sem_reset(&_sem);
-    }
+    ~counting_semaphore() noexcept = default;
 
+    // Increments the count by update, and wakes waiting threads with at most one kernel call.
     void release(int32_t update = 1) noexcept {
-        while (update > 0) {
-            k_sem_give(&_sem);
-            update--;
-        }
+        __ASSERT(update >= 0 && _impl.count() <= LeastMaxValue - update, "Semaphore count would exceed max().");
+        _impl.release(update);
     }
 
     // Blocks until successful.
     void acquire() noexcept {
-        k_sem_take(&_sem, K_FOREVER);
+        _impl.acquire(1, K_FOREVER);
     }
 
     bool try_acquire() noexcept {
-        return k_sem_take(&_sem, K_NO_WAIT) == 0;
+        return _impl.try_acquire(1);
     }
 
-    //bool try_acquire_for(/*time*/) noexcept;
+    // Blocks until the count can be decremented, or until rel_time has elapsed.
+    // Returns false on timeout.
+    template <typename Rep, uint64_t Num, uint64_t Denom>
+    bool try_acquire_for(const ztd::duration<Rep, Num, Denom>& rel_time) noexcept {
+        return _impl.acquire(1, fav::ToKTime(rel_time));
+    }
 
-    //bool try_acquire_until(/*time*/) noexcept;
+    // Blocks until the count can be decremented, or until abs_time has been reached.
+    // TimePoint is any type whose clock provides now(), such that abs_time - now() is a ztd::duration.
+    // Returns false on timeout.
+    template <typename TimePoint>
+    bool try_acquire_until(const TimePoint& abs_time) noexcept {
+        return try_acquire_for(abs_time - TimePoint::clock::now());
+    }
+
+    // Non-std extensions
+
+    // Decrements the count by n atomically, blocking until at least n is available.
+    // A bulk acquisition does not hold back single acquisitions, so it may wait indefinitely under sustained load.
+    void AcquireMany(int32_t n) noexcept {
+        _impl.acquire(n, K_FOREVER);
+    }
+
+    bool TryAcquireMany(int32_t n) noexcept {
+        return _impl.try_acquire(n);
+    }
+
+    template <typename Rep, uint64_t Num, uint64_t Denom>
+    bool TryAcquireManyFor(int32_t n, const ztd::duration<Rep, Num, Denom>& rel_time) noexcept {
+        return _impl.acquire(n, fav::ToKTime(rel_time));
+    }
 
-    // Non-std extensions available in Zephyr
     unsigned int Count() const noexcept {
-        return k_sem_count_get(&_sem);
+        return _impl.count();
     }
 
     constexpr static int32_t max() noexcept {
         return LeastMaxValue;
     }
 
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    // Names this semaphore in the contention statistics. The string is not copied.
+    void SetName(const char* name) noexcept { _impl.stats().SetName(name); }
+    const fav::LockStats& Stats() const noexcept { return _impl.stats(); }
+#endif
+
 private:
-    struct k_sem _sem;
+    _detail::counting_semaphore_impl _impl;
 };
 
 using binary_semaphore = counting_semaphore<1>;
 
 } // namespace
 
-#endif // _FAVONIUS_SEMAPHORE_HPP_
\ No newline at end of file
+#endif // _FAVONIUS_SEMAPHORE_HPP_
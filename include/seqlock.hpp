@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_SEQLOCK_HPP_
+#define _FAVONIUS_SEQLOCK_HPP_
+
+#include <kernel.h>
+
+#include "atomic.hpp"
+#include "type_traits.hpp"
+
+namespace fav {
+
+// Sequence lock for publishing a snapshot of T from one writer to any number of readers.
+// The writer never blocks and never waits for readers. Readers never write to shared memory;
+// they copy the value out and retry if a write overlapped the copy, so they never block each other either.
+// Template parameter T must be trivially copyable. It is copied word by word, so keep it small enough to be copied
+// within a fraction of the publication period, otherwise readers may keep retrying.
+// There must be exactly one writer at a time. Concurrent Write() calls corrupt the sequence.
+template <typename T>
+class SeqLock final {
+public:
+    static_assert(ztd::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type.");
+
+    using ValueType = T;
+
+    SeqLock() noexcept : _sequence(0) {
+        _Store(T());
+    }
+    explicit SeqLock(const T& value) noexcept : _sequence(0) {
+        _Store(value);
+    }
+    SeqLock(const SeqLock&) = delete;
+    SeqLock(SeqLock&&) = delete;
+
+    // Publishes a new value. Wait-free.
+    void Write(const T& value) noexcept {
+        const uint32_t sequence = _sequence.load(ztd::memory_order_relaxed);
+        _sequence.store(sequence + 1, ztd::memory_order_relaxed);
+        // Readers must observe the odd sequence before any of the data stores.
+        ztd::atomic_thread_fence(ztd::memory_order_release);
+        _Store(value);
+        _sequence.store(sequence + 2, ztd::memory_order_release);
+    }
+
+    // Copies the latest consistent value into out.
+    // Returns false without retrying if a write was in progress or overlapped the copy.
+    bool TryRead(T& out) const noexcept {
+        const uint32_t sequence = _sequence.load(ztd::memory_order_acquire);
+        if ((sequence & 1) != 0) {
+            return false;
+        }
+        Words words;
+        _Load(words);
+        ztd::atomic_thread_fence(ztd::memory_order_acquire);
+        if (_sequence.load(ztd::memory_order_relaxed) != sequence) {
+            return false;
+        }
+        __builtin_memcpy(&out, words, sizeof(T));
+        return true;
+    }
+
+    // Returns the latest consistent value, retrying until a copy was not torn by the writer.
+    // The thread yields between attempts. Note that on a single core, a reader with a higher priority than the writer
+    // will spin until the writer is scheduled again; use TryRead() if that is unacceptable.
+    T Read() const noexcept {
+        T value;
+        while (!TryRead(value)) {
+            k_yield();
+        }
+        return value;
+    }
+
+    // The number of completed writes. Readers may use this to tell whether anything new was published.
+    uint32_t Version() const noexcept {
+        return _sequence.load(ztd::memory_order_acquire) >> 1;
+    }
+
+private:
+    using Word = unsigned long;
+    static constexpr size_t WordCount = (sizeof(T) + sizeof(Word) - 1) / sizeof(Word);
+    using Words = Word[WordCount];
+
+    ztd::atomic<uint32_t> _sequence; // Odd while a write is in progress.
+    ztd::atomic<Word> _data[WordCount];
+
+    void _Store(const T& value) noexcept {
+        Words words = {};
+        __builtin_memcpy(words, &value, sizeof(T));
+        for (size_t i = 0; i < WordCount; ++i) {
+            _data[i].store(words[i], ztd::memory_order_relaxed);
+        }
+    }
+
+    void _Load(Words& words) const noexcept {
+        for (size_t i = 0; i < WordCount; ++i) {
+            words[i] = _data[i].load(ztd::memory_order_relaxed);
+        }
+    }
+};
+
+} // namespace
+
+#endif // _FAVONIUS_SEQLOCK_HPP_
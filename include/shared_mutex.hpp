@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_SHARED_MUTEX_HPP_
+#define _FAVONIUS_SHARED_MUTEX_HPP_
+
+#include <kernel.h>
+
+#include "chrono.hpp"
+#include "mutex.hpp"
+#include "utility.hpp"
+
+// This header implements the C++17 shared_mutex, shared_timed_mutex and C++14 shared_lock.
+// See https://en.cppreference.com/w/cpp/thread/shared_mutex
+
+namespace ztd {
+
+namespace _detail {
+
+// Reader-writer lock shared by shared_mutex and shared_timed_mutex.
+// The whole lock state lives in one atomic word, so that shared and exclusive acquisition
+// on an uncontended lock are a single CAS each, and concurrent readers never serialize.
+// Threads that have to sleep take the internal k_mutex and wait on one of two condition variables.
+// Writers are preferred: once a writer is waiting, new readers queue behind it.
+// Not recursive; a reader that attempts to lock again while a writer is waiting will deadlock.
+class shared_mutex_impl final {
+public:
+    shared_mutex_impl() noexcept;
+    shared_mutex_impl(const shared_mutex_impl&) = delete;
+    shared_mutex_impl(shared_mutex_impl&&) = delete;
+
+    // Returns false if timeout elapsed before acquisition.
+    bool lock(k_timeout_t timeout) noexcept {
+        return atomic_cas(&_state, 0, WriterLocked) || _LockContended(timeout);
+    }
+
+    bool try_lock() noexcept {
+        return atomic_cas(&_state, 0, WriterLocked);
+    }
+
+    void unlock() noexcept {
+        if (!atomic_cas(&_state, WriterLocked, 0)) {
+            _UnlockContended();
+        }
+    }
+
+    // Returns false if timeout elapsed before acquisition.
+    bool lock_shared(k_timeout_t timeout) noexcept {
+        return try_lock_shared() || _LockSharedContended(timeout);
+    }
+
+    bool try_lock_shared() noexcept {
+        atomic_val_t state = atomic_get(&_state);
+        while ((state & (WriterLocked | WriterPending)) == 0) {
+            if (atomic_cas(&_state, state, state + 1)) {
+                return true;
+            }
+            state = atomic_get(&_state);
+        }
+        return false;
+    }
+
+    void unlock_shared() noexcept {
+        const atomic_val_t previous = atomic_dec(&_state);
+        if (((previous - 1) & ReaderMask) == 0 && (previous & Waiters) != 0) {
+            _UnlockSharedContended();
+        }
+    }
+
+private:
+    // Layout of _state. The low bits count the readers holding the lock.
+    // Waiters and WriterPending are only changed while holding _gate, and mirror the waiter counts below.
+    static constexpr atomic_val_t ReaderMask    = (1 << 28) - 1;
+    static constexpr atomic_val_t WriterLocked  = 1 << 28;
+    static constexpr atomic_val_t WriterPending = 1 << 29;
+    static constexpr atomic_val_t Waiters       = 1 << 30;
+
+    atomic_t _state;
+
+    // Slow path state, guarded by _gate.
+    struct k_mutex _gate;
+    struct k_condvar _readers_cv;
+    struct k_condvar _writers_cv;
+    uint32_t _readers_waiting;
+    uint32_t _writers_waiting;
+
+    bool _LockContended(k_timeout_t timeout) noexcept;
+    void _UnlockContended() noexcept;
+    bool _LockSharedContended(k_timeout_t timeout) noexcept;
+    void _UnlockSharedContended() noexcept;
+    void _UpdateWaiterBits() noexcept;
+};
+
+} // namespace _detail
+
+// Shared mutex. Multiple readers may hold the lock simultaneously, writers hold it exclusively.
+// Fulfills C++ SharedMutex( Mutex, Lockable ( BasicLockable ), DefaultConstructible, Destructible, NonCopyable, NonMovable ) concept.
+class shared_mutex final {
+public:
+    shared_mutex() noexcept = default;
+    shared_mutex(const shared_mutex&) = delete;
+    shared_mutex(shared_mutex&&) = delete;
+    ~shared_mutex() noexcept = default;
+
+    // Locks the mutex exclusively.
+    // Blocks until all readers and any other writer have released the lock.
+    void lock() noexcept { _impl.lock(K_FOREVER); }
+
+    // Tries to lock the mutex exclusively. Returns immediately.
+    // On successful lock acquisition returns true, otherwise returns false.
+    bool try_lock() noexcept { return _impl.try_lock(); }
+
+    // Releases exclusive ownership.
+    void unlock() noexcept { _impl.unlock(); }
+
+    // Locks the mutex for shared ownership.
+    // Blocks while a writer holds the lock or is waiting for it.
+    void lock_shared() noexcept { _impl.lock_shared(K_FOREVER); }
+
+    // Tries to lock the mutex for shared ownership. Returns immediately.
+    // On successful lock acquisition returns true, otherwise returns false.
+    bool try_lock_shared() noexcept { return _impl.try_lock_shared(); }
+
+    // Releases shared ownership.
+    void unlock_shared() noexcept { _impl.unlock_shared(); }
+
+private:
+    _detail::shared_mutex_impl _impl;
+};
+
+// Shared mutex with timed acquisition.
+// Fulfills C++ SharedTimedMutex( SharedMutex, TimedMutex ) concept.
+class shared_timed_mutex final {
+public:
+    shared_timed_mutex() noexcept = default;
+    shared_timed_mutex(const shared_timed_mutex&) = delete;
+    shared_timed_mutex(shared_timed_mutex&&) = delete;
+    ~shared_timed_mutex() noexcept = default;
+
+    void lock() noexcept { _impl.lock(K_FOREVER); }
+
+    bool try_lock() noexcept { return _impl.try_lock(); }
+
+    // Tries to lock the mutex exclusively.
+    // Blocks until specified timeout_duration has elapsed or the lock is acquired, whichever comes first.
+    // On successful lock acquisition returns true, otherwise returns false.
+    template <typename Rep, uint64_t Num, uint64_t Denom>
+    bool try_lock_for(const ztd::duration<Rep, Num, Denom>& timeout_duration) noexcept {
+        return _impl.lock(fav::ToKTime(timeout_duration));
+    }
+
+    // Tries to lock the mutex exclusively.
+    // Blocks until specified timeout_time has been reached or the lock is acquired, whichever comes first.
+    // On successful lock acquisition returns true, otherwise returns false.
+    template <typename Clock, typename Duration>
+    bool try_lock_until(const ztd::time_point<Clock, Duration>& timeout_time) noexcept {
+        return try_lock_for(timeout_time - Clock::now());
+    }
+
+    void unlock() noexcept { _impl.unlock(); }
+
+    void lock_shared() noexcept { _impl.lock_shared(K_FOREVER); }
+
+    bool try_lock_shared() noexcept { return _impl.try_lock_shared(); }
+
+    // Tries to lock the mutex for shared ownership.
+    // Blocks until specified timeout_duration has elapsed or the lock is acquired, whichever comes first.
+    // On successful lock acquisition returns true, otherwise returns false.
+    template <typename Rep, uint64_t Num, uint64_t Denom>
+    bool try_lock_shared_for(const ztd::duration<Rep, Num, Denom>& timeout_duration) noexcept {
+        return _impl.lock_shared(fav::ToKTime(timeout_duration));
+    }
+
+    // Tries to lock the mutex for shared ownership.
+    // Blocks until specified timeout_time has been reached or the lock is acquired, whichever comes first.
+    // On successful lock acquisition returns true, otherwise returns false.
+    template <typename Clock, typename Duration>
+    bool try_lock_shared_until(const ztd::time_point<Clock, Duration>& timeout_time) noexcept {
+        return try_lock_shared_for(timeout_time - Clock::now());
+    }
+
+    void unlock_shared() noexcept { _impl.unlock_shared(); }
+
+private:
+    _detail::shared_mutex_impl _impl;
+};
+
+// Shared ownership counterpart of unique_lock.
+template <typename Mutex>
+struct shared_lock final {
+public:
+    using mutex_type = Mutex;
+
+    explicit shared_lock(mutex_type& mutex) noexcept : _mutex(mutex), _owns(true) { _mutex.lock_shared(); }
+    shared_lock(mutex_type& mutex, ztd::defer_lock_t t)  noexcept : _mutex(mutex), _owns(false) {}
+    shared_lock(mutex_type& mutex, ztd::try_to_lock_t t) noexcept : _mutex(mutex), _owns(_mutex.try_lock_shared()) {}
+    shared_lock(mutex_type& mutex, ztd::adopt_lock_t t)  noexcept : _mutex(mutex), _owns(true) {}
+
+    template <typename Rep, uint64_t Num, uint64_t Denom>
+    shared_lock(mutex_type& mutex, const ztd::duration<Rep, Num, Denom>& timeout_duration) noexcept
+        : _mutex(mutex), _owns(_mutex.try_lock_shared_for(timeout_duration)) {}
+
+    shared_lock(const shared_lock&) = delete;
+    shared_lock(shared_lock&& other) noexcept : _mutex(other._mutex), _owns(other._owns) { other._owns = false; }
+    ~shared_lock() noexcept {
+        if (_owns) {
+            _mutex.unlock_shared();
+        }
+    }
+
+    void lock() noexcept {
+        _mutex.lock_shared();
+        _owns = true;
+    }
+
+    bool try_lock() noexcept {
+        _owns = _mutex.try_lock_shared();
+        return _owns;
+    }
+
+    template <typename Rep, uint64_t Num, uint64_t Denom>
+    bool try_lock_for(const ztd::duration<Rep, Num, Denom>& timeout_duration) noexcept {
+        _owns = _mutex.try_lock_shared_for(timeout_duration);
+        return _owns;
+    }
+
+    template <typename Clock, typename Duration>
+    bool try_lock_until(const ztd::time_point<Clock, Duration>& timeout_time) noexcept {
+        _owns = _mutex.try_lock_shared_until(timeout_time);
+        return _owns;
+    }
+
+    void unlock() noexcept {
+        _mutex.unlock_shared();
+        _owns = false;
+    }
+
+    mutex_type* mutex() const noexcept {
+        return &_mutex;
+    }
+
+    bool owns_lock() const noexcept {
+        return _owns;
+    }
+
+    operator bool() const noexcept {
+        return owns_lock();
+    }
+
+private:
+    mutex_type& _mutex;
+    bool _owns;
+};
+
+} // namespace
+
+#endif // _FAVONIUS_SHARED_MUTEX_HPP_
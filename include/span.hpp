@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_SPAN_HPP_
+#define _FAVONIUS_SPAN_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "array.hpp"
+#include "type_traits.hpp"
+
+// This header implements the C++20 span.
+// See https://en.cppreference.com/w/cpp/container/span
+// Byte views are spans of uint8_t, as there is no ztd::byte.
+// Preconditions (e.g. an offset within the span) are not checked, like std::span without a debug library.
+
+namespace ztd {
+
+inline constexpr size_t dynamic_extent = static_cast<size_t>(-1);
+
+template <typename T, size_t Extent = dynamic_extent>
+class span;
+
+namespace _detail {
+
+// A span with a static extent only stores its pointer: span_extent is then an empty base.
+template <size_t Extent>
+struct span_extent {
+    constexpr span_extent(size_t) noexcept {}
+    constexpr size_t _extent_size() const noexcept { return Extent; }
+};
+
+template <>
+struct span_extent<dynamic_extent> {
+    constexpr span_extent(size_t size) noexcept : _size(size) {}
+    constexpr size_t _extent_size() const noexcept { return _size; }
+
+private:
+    size_t _size;
+};
+
+// U can be viewed as T if U(*)[] converts to T(*)[], i.e. only by adding const or volatile.
+template <typename U, typename T>
+struct is_span_convertible : integral_constant<bool,
+    is_same<typename remove_cv<U>::type, typename remove_cv<T>::type>::value &&
+    (!is_same<U, const typename remove_cv<U>::type>::value || is_same<T, const typename remove_cv<T>::type>::value) &&
+    (!is_same<U, volatile typename remove_cv<U>::type>::value ||
+     is_same<T, volatile typename remove_cv<T>::type>::value)> {};
+
+constexpr size_t subspan_extent(size_t extent, size_t offset, size_t count) noexcept {
+    return (count != dynamic_extent) ? count : ((extent != dynamic_extent) ? extent - offset : dynamic_extent);
+}
+
+} // namespace
+
+// Non-owning view of a contiguous sequence of T.
+// Extent is the number of elements if known at compile time, otherwise dynamic_extent.
+template <typename T, size_t Extent>
+class span final : private _detail::span_extent<Extent> {
+public:
+    using element_type = T;
+    using value_type = typename remove_cv<T>::type;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+
+    static constexpr size_t extent = Extent;
+
+    // Empty span. Only spans of dynamic or zero extent can be empty.
+    template <size_t E = Extent, typename = enable_if_t<E == dynamic_extent || E == 0>>
+    constexpr span() noexcept : _detail::span_extent<Extent>(0), _data(nullptr) {}
+
+    constexpr span(pointer first, size_type count) noexcept : _detail::span_extent<Extent>(count), _data(first) {}
+
+    constexpr span(pointer first, pointer last) noexcept : _detail::span_extent<Extent>(static_cast<size_t>(last - first)), _data(first) {}
+
+    template <size_t N, typename = enable_if_t<Extent == dynamic_extent || Extent == N>>
+    constexpr span(element_type (&arr)[N]) noexcept : _detail::span_extent<Extent>(N), _data(arr) {}
+
+    template <typename U, size_t N,
+              typename = enable_if_t<(Extent == dynamic_extent || Extent == N) && _detail::is_span_convertible<U, T>::value>>
+    constexpr span(array<U, N>& arr) noexcept : _detail::span_extent<Extent>(N), _data(arr.data()) {}
+
+    template <typename U, size_t N,
+              typename = enable_if_t<(Extent == dynamic_extent || Extent == N) &&
+                                     _detail::is_span_convertible<const U, T>::value>>
+    constexpr span(const array<U, N>& arr) noexcept : _detail::span_extent<Extent>(N), _data(arr.data()) {}
+
+    // E.g. span<T> to span<const T>, or a static extent to a dynamic one.
+    // A dynamic extent converts to a static one (explicitly in std) only if the sizes match, which is not checked.
+    template <typename U, size_t N,
+              typename = enable_if_t<(Extent == dynamic_extent || N == dynamic_extent || Extent == N) &&
+                                     _detail::is_span_convertible<U, T>::value>>
+    constexpr span(const span<U, N>& other) noexcept : _detail::span_extent<Extent>(other.size()), _data(other.data()) {}
+
+    constexpr span(const span& other) noexcept = default;
+    constexpr span& operator=(const span& other) noexcept = default;
+
+    constexpr iterator begin() const noexcept { return _data; }
+    constexpr iterator end() const noexcept { return _data + size(); }
+
+    constexpr reference front() const noexcept { return _data[0]; }
+    constexpr reference back() const noexcept { return _data[size() - 1]; }
+    constexpr reference operator[](size_type idx) const noexcept { return _data[idx]; }
+    constexpr pointer data() const noexcept { return _data; }
+
+    constexpr size_type size() const noexcept { return this->_extent_size(); }
+    constexpr size_type size_bytes() const noexcept { return size() * sizeof(element_type); }
+    [[nodiscard]] constexpr bool empty() const noexcept { return size() == 0; }
+
+    template <size_t Count>
+    constexpr span<element_type, Count> first() const noexcept {
+        static_assert(Extent == dynamic_extent || Count <= Extent, "Count exceeds the extent.");
+        return span<element_type, Count>(_data, Count);
+    }
+
+    constexpr span<element_type, dynamic_extent> first(size_type count) const noexcept {
+        return span<element_type, dynamic_extent>(_data, count);
+    }
+
+    template <size_t Count>
+    constexpr span<element_type, Count> last() const noexcept {
+        static_assert(Extent == dynamic_extent || Count <= Extent, "Count exceeds the extent.");
+        return span<element_type, Count>(_data + (size() - Count), Count);
+    }
+
+    constexpr span<element_type, dynamic_extent> last(size_type count) const noexcept {
+        return span<element_type, dynamic_extent>(_data + (size() - count), count);
+    }
+
+    template <size_t Offset, size_t Count = dynamic_extent>
+    constexpr span<element_type, _detail::subspan_extent(Extent, Offset, Count)> subspan() const noexcept {
+        static_assert(Extent == dynamic_extent || Offset <= Extent, "Offset exceeds the extent.");
+        static_assert(Extent == dynamic_extent || Count == dynamic_extent || Count <= Extent - Offset,
+                      "Count exceeds the extent.");
+        return span<element_type, _detail::subspan_extent(Extent, Offset, Count)>(
+            _data + Offset, (Count != dynamic_extent) ? Count : size() - Offset);
+    }
+
+    constexpr span<element_type, dynamic_extent> subspan(size_type offset, size_type count = dynamic_extent) const noexcept {
+        return span<element_type, dynamic_extent>(_data + offset, (count != dynamic_extent) ? count : size() - offset);
+    }
+
+private:
+    pointer _data;
+};
+
+// Deduction guides, as in std.
+template <typename T, size_t N>
+span(T (&)[N]) -> span<T, N>;
+
+template <typename T, size_t N>
+span(array<T, N>&) -> span<T, N>;
+
+template <typename T, size_t N>
+span(const array<T, N>&) -> span<const T, N>;
+
+template <typename T>
+span(T*, size_t) -> span<T>;
+
+template <typename T>
+span(T*, T*) -> span<T>;
+
+template <typename T, size_t N>
+span<const uint8_t, (N == dynamic_extent) ? dynamic_extent : N * sizeof(T)> as_bytes(span<T, N> s) noexcept {
+    return {reinterpret_cast<const uint8_t*>(s.data()), s.size_bytes()};
+}
+
+template <typename T, size_t N, typename = enable_if_t<!is_same<T, const typename remove_cv<T>::type>::value>>
+span<uint8_t, (N == dynamic_extent) ? dynamic_extent : N * sizeof(T)> as_writable_bytes(span<T, N> s) noexcept {
+    return {reinterpret_cast<uint8_t*>(s.data()), s.size_bytes()};
+}
+
+} // namespace
+
+#endif // _FAVONIUS_SPAN_HPP_
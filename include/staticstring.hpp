@@ -0,0 +1,227 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_STATICSTRING_HPP_
+#define _FAVONIUS_STATICSTRING_HPP_
+
+#include <stdarg.h>
+#include <sys/printk.h>
+
+#include "algorithm.hpp"
+#include "string_view.hpp"
+#include "type_traits.hpp"
+
+namespace fav {
+
+// String of at most N characters, stored inline and always null-terminated.
+// Nothing allocates: operations which would exceed the capacity store as much as fits, return false,
+// and set the Truncated() flag, which stays set until the string is cleared or assigned.
+// Size() is O(1); appending is O(length appended). Formatting uses Zephyr's snprintk, so the conversions
+// available are those of printk (e.g. floating point requires CONFIG_CBPRINTF_FP_SUPPORT).
+// Member functions are NOT thread safe.
+template <size_t N>
+class StaticString final {
+public:
+    using ValueType = char;
+    using iterator = char*;
+    using const_iterator = const char*;
+
+    constexpr StaticString() noexcept : _data{}, _size(0), _truncated(false) {}
+
+    // Truncates str if it is longer than N.
+    constexpr StaticString(ztd::string_view str) noexcept : _data{}, _size(0), _truncated(false) {
+        Append(str);
+    }
+
+    constexpr StaticString(const char* str) noexcept : StaticString(ztd::string_view(str)) {}
+
+    // Copies between capacities, truncating if needed.
+    template <size_t M>
+    constexpr StaticString(const StaticString<M>& other) noexcept : StaticString(other.View()) {}
+
+    constexpr StaticString(const StaticString& other) noexcept = default;
+    constexpr StaticString& operator=(const StaticString& other) noexcept = default;
+
+    constexpr size_t Size() const noexcept { return _size; }
+    static constexpr size_t Capacity() noexcept { return N; }
+    constexpr size_t FreeSpace() const noexcept { return N - _size; }
+    constexpr bool Empty() const noexcept { return _size == 0; }
+    constexpr bool Full() const noexcept { return _size == N; }
+
+    // Whether any operation since the last Clear() or Assign() had to truncate.
+    constexpr bool Truncated() const noexcept { return _truncated; }
+
+    constexpr const char* CStr() const noexcept { return _data; }
+    constexpr char* Data() noexcept { return _data; }
+    constexpr const char* Data() const noexcept { return _data; }
+
+    constexpr ztd::string_view View() const noexcept { return ztd::string_view(_data, _size); }
+    constexpr operator ztd::string_view() const noexcept { return View(); }
+
+    constexpr char& operator[](size_t index) noexcept { return _data[index]; }
+    constexpr const char& operator[](size_t index) const noexcept { return _data[index]; }
+
+    constexpr iterator begin() noexcept { return _data; }
+    constexpr const_iterator begin() const noexcept { return _data; }
+    constexpr iterator end() noexcept { return _data + _size; }
+    constexpr const_iterator end() const noexcept { return _data + _size; }
+
+    constexpr void Clear() noexcept {
+        _size = 0;
+        _data[0] = '\0';
+        _truncated = false;
+    }
+
+    // Shortens the string to length, if it is longer.
+    constexpr void Truncate(size_t length) noexcept {
+        if (length < _size) {
+            _size = length;
+            _data[_size] = '\0';
+        }
+    }
+
+    constexpr void PopBack() noexcept {
+        if (_size > 0) {
+            _data[--_size] = '\0';
+        }
+    }
+
+    // Replaces the contents. Returns false if str was truncated.
+    constexpr bool Assign(ztd::string_view str) noexcept {
+        Clear();
+        return Append(str);
+    }
+
+    // Returns false if str was truncated.
+    constexpr bool Append(ztd::string_view str) noexcept {
+        const size_t count = ztd::min(str.size(), FreeSpace());
+        ztd::copy(str.begin(), str.begin() + count, _data + _size);
+        _size += count;
+        _data[_size] = '\0';
+        return _Report(count == str.size());
+    }
+
+    // Returns false if there was no space for c.
+    constexpr bool Append(char c) noexcept {
+        if (Full()) {
+            return _Report(false);
+        }
+        _data[_size++] = c;
+        _data[_size] = '\0';
+        return true;
+    }
+
+    // Appends the decimal representation of an integer, without going through printk.
+    // Returns false if it did not fit, in which case nothing is appended.
+    template <typename Integer, typename = ztd::enable_if_t<ztd::is_integral<Integer>::value>>
+    constexpr bool AppendInteger(Integer value) noexcept {
+        char digits[3 * sizeof(Integer) + 1] = {};
+        size_t count = 0;
+        const bool negative = (value < 0);
+        do {
+            const int digit = static_cast<int>(value % 10);
+            digits[count++] = static_cast<char>('0' + (negative ? -digit : digit));
+            value /= 10;
+        } while (value != 0);
+        if (negative) {
+            digits[count++] = '-';
+        }
+        if (count > FreeSpace()) {
+            return _Report(false);
+        }
+        for (size_t i = count; i > 0; --i) {
+            _data[_size++] = digits[i - 1];
+        }
+        _data[_size] = '\0';
+        return true;
+    }
+
+    // Replaces the contents with printk-style formatted output. Returns false if the output was truncated.
+    __attribute__((format(printf, 2, 3))) bool Format(const char* fmt, ...) noexcept {
+        va_list args;
+        va_start(args, fmt);
+        Clear();
+        const bool complete = AppendFormatV(fmt, args);
+        va_end(args);
+        return complete;
+    }
+
+    // Appends printk-style formatted output. Returns false if the output was truncated.
+    __attribute__((format(printf, 2, 3))) bool AppendFormat(const char* fmt, ...) noexcept {
+        va_list args;
+        va_start(args, fmt);
+        const bool complete = AppendFormatV(fmt, args);
+        va_end(args);
+        return complete;
+    }
+
+    bool AppendFormatV(const char* fmt, va_list args) noexcept {
+        const int written = vsnprintk(_data + _size, FreeSpace() + 1, fmt, args);
+        if (written < 0) {
+            _data[_size] = '\0';
+            return _Report(false);
+        }
+        if (static_cast<size_t>(written) > FreeSpace()) {
+            _size = N;
+            return _Report(false);
+        }
+        _size += static_cast<size_t>(written);
+        return true;
+    }
+
+    StaticString& operator+=(ztd::string_view str) noexcept {
+        Append(str);
+        return *this;
+    }
+
+    StaticString& operator+=(char c) noexcept {
+        Append(c);
+        return *this;
+    }
+
+private:
+    char _data[N + 1];
+    size_t _size;
+    bool _truncated;
+
+    constexpr bool _Report(bool complete) noexcept {
+        _truncated = _truncated || !complete;
+        return complete;
+    }
+};
+
+// Comparisons by content, with each other and with anything that converts to ztd::string_view.
+
+template <size_t N, size_t M>
+constexpr bool operator==(const StaticString<N>& lhs, const StaticString<M>& rhs) noexcept {
+    return lhs.View() == rhs.View();
+}
+
+template <size_t N>
+constexpr bool operator==(const StaticString<N>& lhs, ztd::string_view rhs) noexcept {
+    return lhs.View() == rhs;
+}
+
+template <size_t N>
+constexpr bool operator==(ztd::string_view lhs, const StaticString<N>& rhs) noexcept {
+    return lhs == rhs.View();
+}
+
+template <size_t N, size_t M>
+constexpr bool operator!=(const StaticString<N>& lhs, const StaticString<M>& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+template <size_t N>
+constexpr bool operator!=(const StaticString<N>& lhs, ztd::string_view rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+template <size_t N>
+constexpr bool operator!=(ztd::string_view lhs, const StaticString<N>& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+} // namespace
+
+#endif // _FAVONIUS_STATICSTRING_HPP_
@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_STRING_VIEW_HPP_
+#define _FAVONIUS_STRING_VIEW_HPP_
+
+#include <stddef.h>
+
+#include "algorithm.hpp"
+#include "span.hpp"
+
+// This header implements the C++17 string_view, for char only.
+// See https://en.cppreference.com/w/cpp/string/basic_string_view
+// Nothing throws: substr() and copy() clamp a position past the end to the end, where std would throw out_of_range.
+// starts_with() and ends_with() from C++20 are included.
+
+namespace ztd {
+
+class string_view final {
+public:
+    using value_type = char;
+    using pointer = char*;
+    using const_pointer = const char*;
+    using reference = char&;
+    using const_reference = const char&;
+    using const_iterator = const char*;
+    using iterator = const_iterator;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    constexpr string_view() noexcept : _data(nullptr), _size(0) {}
+    constexpr string_view(const char* s, size_type count) noexcept : _data(s), _size(count) {}
+    // s must be null-terminated.
+    constexpr string_view(const char* s) noexcept : _data(s), _size(__builtin_strlen(s)) {}
+    constexpr string_view(span<const char> s) noexcept : _data(s.data()), _size(s.size()) {}
+    constexpr string_view(const string_view& other) noexcept = default;
+    constexpr string_view& operator=(const string_view& view) noexcept = default;
+
+    constexpr const_iterator begin() const noexcept { return _data; }
+    constexpr const_iterator cbegin() const noexcept { return _data; }
+    constexpr const_iterator end() const noexcept { return _data + _size; }
+    constexpr const_iterator cend() const noexcept { return _data + _size; }
+
+    constexpr const_reference operator[](size_type pos) const noexcept { return _data[pos]; }
+    constexpr const_reference front() const noexcept { return _data[0]; }
+    constexpr const_reference back() const noexcept { return _data[_size - 1]; }
+    // Not null-terminated in general.
+    constexpr const_pointer data() const noexcept { return _data; }
+
+    constexpr size_type size() const noexcept { return _size; }
+    constexpr size_type length() const noexcept { return _size; }
+    constexpr size_type max_size() const noexcept { return npos - 1; }
+    [[nodiscard]] constexpr bool empty() const noexcept { return _size == 0; }
+
+    constexpr void remove_prefix(size_type n) noexcept {
+        _data += n;
+        _size -= n;
+    }
+
+    constexpr void remove_suffix(size_type n) noexcept {
+        _size -= n;
+    }
+
+    constexpr void swap(string_view& v) noexcept {
+        const string_view temp = *this;
+        *this = v;
+        v = temp;
+    }
+
+    // Copies at most count characters from pos into dest, without a null terminator. Returns the number copied.
+    constexpr size_type copy(char* dest, size_type count, size_type pos = 0) const noexcept {
+        const string_view source = substr(pos, count);
+        ztd::copy(source.begin(), source.end(), dest);
+        return source.size();
+    }
+
+    constexpr string_view substr(size_type pos = 0, size_type count = npos) const noexcept {
+        pos = (pos < _size) ? pos : _size;
+        const size_type remaining = _size - pos;
+        return string_view(_data + pos, (count < remaining) ? count : remaining);
+    }
+
+    // The characters as a span, e.g. for APIs which take bytes.
+    constexpr span<const char> as_span() const noexcept {
+        return span<const char>(_data, _size);
+    }
+
+    constexpr int compare(string_view v) const noexcept {
+        const size_type n = (_size < v._size) ? _size : v._size;
+        for (size_type i = 0; i < n; ++i) {
+            if (_data[i] != v._data[i]) {
+                return (static_cast<unsigned char>(_data[i]) < static_cast<unsigned char>(v._data[i])) ? -1 : 1;
+            }
+        }
+        return (_size == v._size) ? 0 : ((_size < v._size) ? -1 : 1);
+    }
+
+    constexpr bool starts_with(string_view sv) const noexcept {
+        return (_size >= sv._size) && (substr(0, sv._size).compare(sv) == 0);
+    }
+
+    constexpr bool starts_with(char c) const noexcept {
+        return !empty() && (front() == c);
+    }
+
+    constexpr bool ends_with(string_view sv) const noexcept {
+        return (_size >= sv._size) && (substr(_size - sv._size).compare(sv) == 0);
+    }
+
+    constexpr bool ends_with(char c) const noexcept {
+        return !empty() && (back() == c);
+    }
+
+    constexpr size_type find(char ch, size_type pos = 0) const noexcept {
+        if (pos >= _size) {
+            return npos;
+        }
+        const_iterator found = ztd::find(begin() + pos, end(), ch);
+        return (found != end()) ? static_cast<size_type>(found - begin()) : npos;
+    }
+
+    constexpr size_type find(string_view v, size_type pos = 0) const noexcept {
+        if (v._size == 0) {
+            return (pos <= _size) ? pos : npos;
+        }
+        while (v._size <= _size && pos <= _size - v._size) {
+            pos = find(v._data[0], pos);
+            if (pos == npos || pos > _size - v._size) {
+                return npos;
+            }
+            if (substr(pos, v._size).compare(v) == 0) {
+                return pos;
+            }
+            ++pos;
+        }
+        return npos;
+    }
+
+    constexpr size_type rfind(char ch, size_type pos = npos) const noexcept {
+        if (_size == 0) {
+            return npos;
+        }
+        for (size_type i = (pos < _size) ? pos + 1 : _size; i > 0; --i) {
+            if (_data[i - 1] == ch) {
+                return i - 1;
+            }
+        }
+        return npos;
+    }
+
+    constexpr size_type find_first_of(string_view v, size_type pos = 0) const noexcept {
+        for (; pos < _size; ++pos) {
+            if (v.find(_data[pos]) != npos) {
+                return pos;
+            }
+        }
+        return npos;
+    }
+
+    constexpr size_type find_first_not_of(string_view v, size_type pos = 0) const noexcept {
+        for (; pos < _size; ++pos) {
+            if (v.find(_data[pos]) == npos) {
+                return pos;
+            }
+        }
+        return npos;
+    }
+
+    constexpr bool contains(char c) const noexcept { return find(c) != npos; }
+    constexpr bool contains(string_view sv) const noexcept { return find(sv) != npos; }
+
+private:
+    const char* _data;
+    size_type _size;
+};
+
+constexpr bool operator==(string_view lhs, string_view rhs) noexcept {
+    return (lhs.size() == rhs.size()) && (lhs.compare(rhs) == 0);
+}
+
+constexpr bool operator!=(string_view lhs, string_view rhs) noexcept { return !(lhs == rhs); }
+constexpr bool operator<(string_view lhs, string_view rhs) noexcept { return lhs.compare(rhs) < 0; }
+constexpr bool operator>(string_view lhs, string_view rhs) noexcept { return lhs.compare(rhs) > 0; }
+constexpr bool operator<=(string_view lhs, string_view rhs) noexcept { return lhs.compare(rhs) <= 0; }
+constexpr bool operator>=(string_view lhs, string_view rhs) noexcept { return lhs.compare(rhs) >= 0; }
+
+} // namespace
+
+#endif // _FAVONIUS_STRING_VIEW_HPP_
@@ -8,70 +8,95 @@
 #include <kernel/thread.h>
 #include <kernel/thread_stack.h>
 
+#include "chrono.hpp"
+#include "inplacefunction.hpp"
+#include "staticstring.hpp"
+#include "string_view.hpp"
+#include "trace.hpp"
+#include "type_traits.hpp"
 #include "utility.hpp"
 
 namespace ztd {
 
+namespace _detail {
+
+// The arguments of a thread's callable, stored after it. Calls fn(args...) with each argument moved, as std::thread does.
+template <typename... Args>
+struct thread_args;
+
+template <>
+struct thread_args<> {
+    template <typename Function, typename... Done>
+    void apply(Function& fn, Done&&... done) noexcept {
+        fn(ztd::forward<Done>(done)...);
+    }
+};
+
+template <typename Head, typename... Tail>
+struct thread_args<Head, Tail...> {
+    template <typename H, typename... T>
+    thread_args(H&& head_, T&&... tail_) noexcept : head(ztd::forward<H>(head_)), tail(ztd::forward<T>(tail_)...) {}
+
+    template <typename Function, typename... Done>
+    void apply(Function& fn, Done&&... done) noexcept {
+        tail.apply(fn, ztd::forward<Done>(done)..., ztd::move(head));
+    }
+
+    Head head;
+    thread_args<Tail...> tail;
+};
+
+template <typename Function, typename... Args>
+struct thread_invoker {
+    template <typename F, typename... A>
+    thread_invoker(F&& fn_, A&&... args_) noexcept : fn(ztd::forward<F>(fn_)), args(ztd::forward<A>(args_)...) {}
+
+    void operator()() noexcept { args.apply(fn); }
+
+    Function fn;
+    thread_args<Args...> args;
+};
+
+} // namespace
+
 class thread final {
 public:
     // Threads have 1 megabyte of stack. In the future this may become adjustable.
     static constexpr uint32_t stack_size = 1024 * 1024;
 
+#if defined(CONFIG_THREAD_MAX_NAME_LEN)
+    static constexpr size_t max_name_length = CONFIG_THREAD_MAX_NAME_LEN - 1;
+#else
+    static constexpr size_t max_name_length = 31;
+#endif
+
+    // Capacity of the callable and its arguments, which are stored in the thread object.
+    static constexpr size_t entry_capacity = 16 * sizeof(void*);
+
     // Creates new thread object which does not represent a thread.
     thread() noexcept;
 
-    // Creates new ztd::thread object and associates it with a thread of execution.
-    // Threads in Zephyr are limited to max 3 parameters.
-    template <typename Function, typename Arg1, typename Arg2, typename Arg3>
-    explicit thread(Function&& fn, Arg1&& arg1, Arg2&& arg2, Arg3&& arg3) noexcept {
-        // k_thread_entry_t is a function pointer with signature void(*)(void*, void*, void*)
-        // So we must adapt the input fn to that signature.
-        auto thread_entry = [fn = ztd::forward<Function>(fn)] (void* p1, void* p2, void* p3) -> void {
-            return fn(*p1, *p2, *p3);
-        };
-        k_tid_t threadptr = k_thread_create(&_thread, &_stack, stack_size, thread_entry, &arg1, &arg2, &arg3, 0, K_USER, K_NO_WAIT);
-    }
-
-    // Creates new ztd::thread object and associates it with a thread of execution.
-    // Threads in Zephyr are limited to max 3 parameters.
-    template <typename Function, typename Arg1, typename Arg2>
-    explicit thread(Function&& fn, Arg1&& arg1, Arg2&& arg2) noexcept {
-        // k_thread_entry_t is a function pointer with signature void(*)(void*, void*, void*)
-        // So we must adapt the input fn to that signature.
-        auto thread_entry = [fn = ztd::forward<Function>(fn)] (void* p1, void* p2, void* p3) -> void {
-            return fn(*p1, *p2);
-        };
-        k_tid_t threadptr = k_thread_create(&_thread, &_stack, stack_size, thread_entry, &arg1, &arg2, NULL, 0, K_USER, K_NO_WAIT);
-    }
-
-    // Creates new ztd::thread object and associates it with a thread of execution.
-    // Threads in Zephyr are limited to max 3 parameters.
-    template <typename Function, typename Arg1>
-    explicit thread(Function&& fn, Arg1&& arg1) noexcept {
-        // k_thread_entry_t is a function pointer with signature void(*)(void*, void*, void*)
-        // So we must adapt the input fn to that signature.
-        auto thread_entry = [fn = ztd::forward<Function>(fn)] (void* p1, void* p2, void* p3) -> void {
-            return fn(*p1);
-        };
-        k_tid_t threadptr = k_thread_create(&_thread, &_stack, stack_size, thread_entry, &arg1, NULL, NULL, 0, K_USER, K_NO_WAIT);
-    }
-
-    // Creates new ztd::thread object and associates it with a thread of execution.
-    // Threads in Zephyr are limited to max 3 parameters.
-    template <typename Function>
-    explicit thread(Function&& fn) noexcept {
-        // k_thread_entry_t is a function pointer with signature void(*)(void*, void*, void*)
-        // So we must adapt the input fn to that signature.
-        auto thread_entry = [fn = ztd::forward<Function>(fn)] (void* p1, void* p2, void* p3) -> void {
-            return fn();
-        };
-        k_tid_t threadptr = k_thread_create(&_thread, &_stack, stack_size, thread_entry, NULL, NULL, NULL, 0, K_USER, K_NO_WAIT);
-    }
-
-    // The copy constructor is deleted; threads are not copyable.
+    // Creates new ztd::thread object and associates it with a thread of execution, which calls fn(args...).
+    // As with std::thread, fn and args are copied or moved into the thread object, so a reference argument must be
+    // passed as a pointer. Nothing is allocated: a callable with its arguments larger than entry_capacity is a
+    // compile-time error. The thread runs the callable in place, so the object must outlive the thread; join() it first.
+    template <typename Function, typename... Args,
+              typename = ztd::enable_if_t<!ztd::is_same<ztd::decay_t<Function>, thread>::value>>
+    explicit thread(Function&& fn, Args&&... args) noexcept
+        : _entry(_detail::thread_invoker<ztd::decay_t<Function>, ztd::decay_t<Args>...>(
+            ztd::forward<Function>(fn), ztd::forward<Args>(args)...)), _joinable(true) {
+        k_thread_create(&_thread, _stack, stack_size, &thread::_Trampoline, this, NULL, NULL, 0, K_USER, K_NO_WAIT);
+        _TraceCreate();
+    }
+
+    // Threads are neither copyable nor movable: the kernel refers to the k_thread and the callable inside the object.
     thread(const thread&) = delete;
-    thread(thread&&) noexcept;
+    thread(thread&&) = delete;
 
+    // Whether this object represents a thread of execution which has not been joined yet.
+    bool joinable() const noexcept { return _joinable; }
+
+    // Returns -EINVAL if the thread is not joinable, e.g. default-constructed or already joined.
     int join() noexcept;
     k_tid_t native_handle() noexcept;
 
@@ -84,6 +109,13 @@ public:
         return k_thread_name_set(&_thread, str);
     }
 
+    // The kernel needs a null-terminated name, so name is copied first.
+    // It is truncated to CONFIG_THREAD_MAX_NAME_LEN, as the kernel would.
+    int SetName(ztd::string_view name) noexcept {
+        const fav::StaticString<max_name_length> terminated(name);
+        return SetName(terminated.CStr());
+    }
+
     int GetPriority() noexcept {
         return k_thread_priority_get(&_thread);
     }
@@ -104,27 +136,63 @@ public:
         k_thread_suspend(&_thread);
     }
 
-    bool StateString(char* buffer, size_t buffer_size) noexcept {
+    // Points into the kernel's static state names, so it need not be copied.
+    ztd::string_view StateString() noexcept {
         return k_thread_state_str(&_thread);
     }
 
+    // Copies the state name into buffer, null-terminated.
+    // Returns false if the name had to be truncated to fit.
+    bool StateString(char* buffer, size_t buffer_size) noexcept {
+        if (buffer_size == 0) {
+            return false;
+        }
+        const ztd::string_view state = StateString();
+        buffer[state.copy(buffer, buffer_size - 1)] = '\0';
+        return state.size() < buffer_size;
+    }
+
     // Time delta in cycle units
     void SetDeadline(int deadline) noexcept {
         k_thread_deadline_set(&_thread, deadline);
     }
 
+    // Deadline relative to now. Rounded up to whole cycles, and saturated at INT32_MAX cycles.
+    template <typename Rep, uint64_t Num, uint64_t Denom>
+    void SetDeadline(const ztd::duration<Rep, Num, Denom>& deadline) noexcept {
+        const uint64_t ns = static_cast<uint64_t>(fav::_detail::CeilSaturated<ztd::nanoseconds>(deadline).count());
+        // Compared in nanoseconds first, so that the conversion to cycles cannot overflow either.
+        if (ns >= k_cyc_to_ns_floor64(INT32_MAX)) {
+            SetDeadline(INT32_MAX);
+            return;
+        }
+        const uint64_t cycles = k_ns_to_cyc_ceil64(ns);
+        SetDeadline(static_cast<int>(cycles < INT32_MAX ? cycles : INT32_MAX));
+    }
+
 private:
     k_thread _thread;
     K_KERNEL_STACK_MEMBER(_stack, stack_size);
+    fav::InplaceFunction<void(), entry_capacity> _entry;
+    bool _joinable;
+
+    // The entry point of every ztd::thread, which runs the callable stored in the thread object.
+    static void _Trampoline(void* self, void*, void*) noexcept;
+
+    void _TraceCreate() noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+        fav::trace::ThreadCreate(&_thread, stack_size);
+#endif
+    }
 };
 
 namespace this_thread {
 
-void yield() noexcept { k_yield(); }
+inline void yield() noexcept { k_yield(); }
 
-void sleep_for(uint64_t us) noexcept { k_usleep(us); }
+inline void sleep_for(uint64_t us) noexcept { k_usleep(us); }
 
-k_tid_t get_id() noexcept { return k_current_get(); }
+inline k_tid_t get_id() noexcept { return k_current_get(); }
 
 // \brief Sets the custom data for the current thread.
 template <typename T>
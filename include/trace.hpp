@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#ifndef _FAVONIUS_TRACE_HPP_
+#define _FAVONIUS_TRACE_HPP_
+
+#include <kernel.h>
+
+// Tracing events of favonius objects, compiled in with CONFIG_FAVONIUS_TRACING.
+// Zephyr's tracing subsystem already sees the k_mutex, k_sem and k_heap calls underneath the wrappers;
+// these events add the favonius object, its name and sizes, so that they can be put on the same timeline.
+// With the CTF backend (CONFIG_TRACING_CTF) the events are described by tracing/favonius.tsdl.
+// With other backends, the functions in fav::trace are weak no-ops which the application may override.
+// When disabled, none of the functions below exist and the call sites in favonius compile to nothing.
+
+namespace fav {
+
+// The name of an object in trace events. Empty unless CONFIG_FAVONIUS_TRACING,
+// so that as a base class it adds nothing to the size of the object.
+class Traceable {
+public:
+#if defined(CONFIG_FAVONIUS_TRACING)
+    const char* Name() const noexcept { return _name; }
+    // The string is not copied and must outlive the object.
+    void SetName(const char* name) noexcept { _name = name; }
+
+private:
+    const char* _name = nullptr;
+#else
+    const char* Name() const noexcept { return nullptr; }
+    void SetName(const char*) noexcept {}
+#endif
+};
+
+#if defined(CONFIG_FAVONIUS_TRACING)
+
+namespace trace {
+
+// Objects are identified by their address. Names may be null.
+// Sizes are in bytes for allocations and in entries for queues; a capacity of 0 means unbounded.
+
+// ptr is null if the allocation failed.
+void Alloc(const void* allocator, const char* name, uint32_t bytes, const void* ptr) noexcept;
+void Free(const void* allocator, const char* name, uint32_t bytes, const void* ptr) noexcept;
+
+// depth is the number of entries after the operation.
+void QueuePush(const void* queue, const char* name, uint32_t depth, uint32_t capacity) noexcept;
+void QueuePop(const void* queue, const char* name, uint32_t depth, uint32_t capacity) noexcept;
+
+// MutexLock() is emitted before waiting for the lock, MutexLocked() once lock() has returned.
+// ret is 0 if the lock was acquired, otherwise the error of the underlying kernel call.
+void MutexLock(const void* mutex, const char* name) noexcept;
+void MutexLocked(const void* mutex, const char* name, int ret) noexcept;
+void MutexUnlock(const void* mutex, const char* name) noexcept;
+
+void ThreadCreate(k_tid_t thread, uint32_t stack_size) noexcept;
+void ThreadJoin(k_tid_t thread, int ret) noexcept;
+
+} // namespace
+
+#endif // defined(CONFIG_FAVONIUS_TRACING)
+
+namespace _detail {
+
+// Names obj if it has SetName(const char*), e.g. the allocator of a container.
+template <typename T>
+auto SetTraceName(T& obj, const char* name, int) noexcept -> decltype(obj.SetName(name)) {
+    return obj.SetName(name);
+}
+
+template <typename T>
+void SetTraceName(T&, const char*, long) noexcept {}
+
+} // namespace
+
+} // namespace
+
+#endif // _FAVONIUS_TRACE_HPP_
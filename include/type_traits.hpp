@@ -10,6 +10,8 @@ namespace ztd = std;
 
 #else
 
+#include <stddef.h>
+
 namespace ztd {
 
 template<typename T, T v>
@@ -51,6 +53,7 @@ struct is_integral : integral_constant<bool,
     is_same<bool, typename remove_cv<T>::type>::value ||
     // signed
     is_same<char,      typename remove_cv<T>::type>::value ||
+    is_same<signed char, typename remove_cv<T>::type>::value ||
     is_same<char16_t,  typename remove_cv<T>::type>::value ||
     is_same<char32_t,  typename remove_cv<T>::type>::value ||
     is_same<wchar_t,   typename remove_cv<T>::type>::value ||
@@ -78,6 +81,83 @@ struct enable_if {};
 template<class T>
 struct enable_if<true, T> { typedef T type; };
 
+template<bool B, class T = void>
+using enable_if_t = typename enable_if<B, T>::type;
+
+template<bool B, class T, class F>
+struct conditional { typedef T type; };
+
+template<class T, class F>
+struct conditional<false, T, F> { typedef F type; };
+
+template<typename T> struct is_pointer_helper     : false_type {};
+template<typename T> struct is_pointer_helper<T*> : true_type {};
+template<typename T> struct is_pointer : is_pointer_helper<typename remove_cv<T>::type> {};
+
+template<typename T> struct remove_reference      { typedef T type; };
+template<typename T> struct remove_reference<T&>  { typedef T type; };
+template<typename T> struct remove_reference<T&&> { typedef T type; };
+
+template<typename T> struct is_reference      : false_type {};
+template<typename T> struct is_reference<T&>  : true_type {};
+template<typename T> struct is_reference<T&&> : true_type {};
+
+template<typename T>           struct is_array       : false_type {};
+template<typename T>           struct is_array<T[]>  : true_type {};
+template<typename T, size_t N> struct is_array<T[N]> : true_type {};
+
+template<typename T>           struct remove_extent       { using type = T; };
+template<typename T>           struct remove_extent<T[]>  { using type = T; };
+template<typename T, size_t N> struct remove_extent<T[N]> { using type = T; };
+
+// Functions and references are the only types which const does not apply to.
+template<typename T>
+struct is_function : integral_constant<bool, is_same<const T, T>::value && !is_reference<T>::value> {};
+
+// The type of a by-value parameter initialized from a T.
+template<typename T>
+struct decay {
+private:
+    using U = typename remove_reference<T>::type;
+public:
+    using type = typename conditional<is_array<U>::value, typename remove_extent<U>::type*,
+                 typename conditional<is_function<U>::value, U*, typename remove_cv<U>::type>::type>::type;
+};
+
+template<typename T>
+using decay_t = typename decay<T>::type;
+
+template<typename T> struct remove_pointer                     { using type = T; };
+template<typename T> struct remove_pointer<T*>                 { using type = T; };
+template<typename T> struct remove_pointer<T* const>           { using type = T; };
+template<typename T> struct remove_pointer<T* volatile>        { using type = T; };
+template<typename T> struct remove_pointer<T* const volatile>  { using type = T; };
+
+// Requires compiler support; GCC and Clang both provide this intrinsic.
+template<typename T>
+struct is_trivially_copyable : integral_constant<bool, __is_trivially_copyable(T)> {};
+
+template<typename T> struct is_empty : integral_constant<bool, __is_empty(T)> {};
+template<typename T> struct is_final : integral_constant<bool, __is_final(T)> {};
+template<typename Base, typename Derived> struct is_base_of : integral_constant<bool, __is_base_of(Base, Derived)> {};
+
+namespace _detail {
+
+template<typename T> T&& declval_convertible() noexcept;
+template<typename To> void accept_convertible(To) noexcept;
+
+template<typename From, typename To, typename = void>
+struct is_convertible_helper : false_type {};
+
+template<typename From, typename To>
+struct is_convertible_helper<From, To, decltype(accept_convertible<To>(declval_convertible<From>()))> : true_type {};
+
+} // namespace
+
+// Whether From converts implicitly to To. Unlike std, void and array or function types are not handled.
+template<typename From, typename To>
+struct is_convertible : _detail::is_convertible_helper<From, To> {};
+
 } // namespace
 
 #endif // FAVONIUS_ALLOW_STD_HEADERS
@@ -12,14 +12,12 @@ namespace ztd = std;
 
 #else
 
-namespace ztd {
+#include <stddef.h>
 
-template <typename T> struct remove_reference      { typedef T type; };
-template <typename T> struct remove_reference<T&>  { typedef T type; };
-template <typename T> struct remove_reference<T&&> { typedef T type; };
+namespace ztd {
 
 template <typename T>
-typename remove_reference<T>::type&& move(T&& arg) {
+constexpr typename remove_reference<T>::type&& move(T&& arg) noexcept {
     return static_cast<typename remove_reference<T>::type&&>(arg);
 }
 
@@ -34,6 +32,20 @@ inline constexpr T&& forward(typename remove_reference<T>::type&& t) noexcept {
     return static_cast<T&&>(t);
 }
 
+template <typename T>
+constexpr void swap(T& a, T& b) noexcept {
+    T temp = move(a);
+    a = move(b);
+    b = move(temp);
+}
+
+template <typename T, size_t N>
+constexpr void swap(T (&a)[N], T (&b)[N]) noexcept {
+    for (size_t i = 0; i < N; ++i) {
+        swap(a[i], b[i]);
+    }
+}
+
 template <typename T1, typename T2>
 struct pair {
 public:
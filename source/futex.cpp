@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include "futex.hpp"
+
+namespace fav {
+
+#if defined(CONFIG_USERSPACE)
+
+Futex::Futex(atomic_val_t value) noexcept {
+    atomic_set(&_futex.val, value);
+}
+
+bool Futex::Wait(atomic_val_t expected, k_timeout_t timeout) noexcept {
+    // -EAGAIN means the word no longer held expected, which is a successful wakeup for the caller.
+    return k_futex_wait(&_futex, expected, timeout) != -ETIMEDOUT;
+}
+
+void Futex::WakeOne() noexcept {
+    [[maybe_unused]] int woken = k_futex_wake(&_futex, false);
+}
+
+void Futex::WakeAll() noexcept {
+    [[maybe_unused]] int woken = k_futex_wake(&_futex, true);
+}
+
+#else
+
+Futex::Futex(atomic_val_t value) noexcept : _lock(), _sleepers(0) {
+    atomic_set(&_word, value);
+    [[maybe_unused]] int ec = k_sem_init(&_wakeups, 0, K_SEM_MAX_LIMIT);
+}
+
+// The word is compared and the sleeper counted under _lock, and wakers take _lock after modifying the word,
+// so a wakeup between the comparison and the sleep is not lost: it is left in _wakeups.
+// Nothing here blocks or locks a mutex on the waking side, so that Wake*() stay usable from ISRs.
+bool Futex::Wait(atomic_val_t expected, k_timeout_t timeout) noexcept {
+    k_spinlock_key_t key = k_spin_lock(&_lock);
+    if (atomic_get(&_word) != expected) {
+        k_spin_unlock(&_lock, key);
+        return true;
+    }
+    ++_sleepers;
+    k_spin_unlock(&_lock, key);
+
+    if (k_sem_take(&_wakeups, timeout) == 0) {
+        return true;
+    }
+    // Timed out, unless a waker counted this thread as woken in the meantime. Its wakeup then stays in _wakeups and
+    // ends a later Wait() early, which callers tolerate as a spurious wakeup.
+    key = k_spin_lock(&_lock);
+    const bool timed_out = (_sleepers > 0);
+    if (timed_out) {
+        --_sleepers;
+    }
+    k_spin_unlock(&_lock, key);
+    return !timed_out;
+}
+
+void Futex::WakeOne() noexcept {
+    const k_spinlock_key_t key = k_spin_lock(&_lock);
+    const bool wake = (_sleepers > 0);
+    if (wake) {
+        --_sleepers;
+    }
+    k_spin_unlock(&_lock, key);
+    if (wake) {
+        k_sem_give(&_wakeups);
+    }
+}
+
+void Futex::WakeAll() noexcept {
+    const k_spinlock_key_t key = k_spin_lock(&_lock);
+    uint32_t woken = _sleepers;
+    _sleepers = 0;
+    k_spin_unlock(&_lock, key);
+    for (; woken > 0; --woken) {
+        k_sem_give(&_wakeups);
+    }
+}
+
+#endif // defined(CONFIG_USERSPACE)
+
+} // namespace
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include "latency.hpp"
+
+#if defined(CONFIG_FAVONIUS_LATENCY_PROBES)
+
+#include <sys/printk.h>
+
+namespace fav {
+
+namespace {
+
+_detail::Registry registry;
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram(const char* name) noexcept
+    : _node({nullptr}), _name(name), _count(0), _min(UINT32_MAX), _max(0) {
+    for (auto& bucket : _buckets) {
+        bucket.store(0, ztd::memory_order_relaxed);
+    }
+    registry.Add(&_node);
+}
+
+LatencyHistogram::~LatencyHistogram() noexcept {
+    registry.Remove(&_node);
+}
+
+uint32_t LatencyHistogram::Percentile(uint32_t numerator, uint32_t denominator) const noexcept {
+    // Sum the buckets rather than reading _count, so that the rank is consistent with what is walked below.
+    uint64_t total = 0;
+    for (const auto& bucket : _buckets) {
+        total += bucket.load(ztd::memory_order_relaxed);
+    }
+    if (total == 0 || denominator == 0) {
+        return 0;
+    }
+    uint64_t rank = (total * numerator + denominator - 1) / denominator;
+    rank = (rank == 0) ? 1 : rank;
+
+    const uint32_t max = Max();
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BucketCount; ++i) {
+        seen += _buckets[i].load(ztd::memory_order_relaxed);
+        if (seen >= rank) {
+            const uint32_t upper = (i == 0) ? 0 : static_cast<uint32_t>((uint64_t(1) << i) - 1);
+            return (upper < max) ? upper : max;
+        }
+    }
+    return max;
+}
+
+void LatencyHistogram::Reset() noexcept {
+    _count.store(0, ztd::memory_order_relaxed);
+    _min.store(UINT32_MAX, ztd::memory_order_relaxed);
+    _max.store(0, ztd::memory_order_relaxed);
+    for (auto& bucket : _buckets) {
+        bucket.store(0, ztd::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::Dump() const noexcept {
+    printk("%s: count %u min %u p50 %u p90 %u p99 %u max %u (cycles)\n", Name(), Count(), Min(), Percentile(50),
+           Percentile(90), Percentile(99), Max());
+    for (size_t i = 0; i < BucketCount; ++i) {
+        const uint32_t count = Bucket(i);
+        if (count != 0) {
+            const uint32_t lower = (i == 0) ? 0 : static_cast<uint32_t>(uint64_t(1) << (i - 1));
+            const uint32_t upper = (i == 0) ? 0 : static_cast<uint32_t>((uint64_t(1) << i) - 1);
+            printk("  [%10u, %10u] %u\n", lower, upper, count);
+        }
+    }
+}
+
+void LatencyHistogram::ForEach(void (*fn)(const LatencyHistogram& histogram, void* user_data), void* user_data) noexcept {
+    struct Visit {
+        void (*fn)(const LatencyHistogram& histogram, void* user_data);
+        void* user_data;
+    } visit {fn, user_data};
+    registry.ForEach([](sys_snode_t* node, void* visit_data) {
+        const Visit& visit = *static_cast<const Visit*>(visit_data);
+        visit.fn(*CONTAINER_OF(node, LatencyHistogram, _node), visit.user_data);
+    }, &visit);
+}
+
+void LatencyHistogram::ResetAll() noexcept {
+    registry.ForEach([](sys_snode_t* node, void*) {
+        CONTAINER_OF(node, LatencyHistogram, _node)->Reset();
+    }, nullptr);
+}
+
+} // namespace
+
+#endif // defined(CONFIG_FAVONIUS_LATENCY_PROBES)
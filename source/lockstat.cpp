@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include "lockstat.hpp"
+
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+
+#include <sys/printk.h>
+
+namespace fav {
+
+namespace {
+
+_detail::Registry registry;
+
+} // namespace
+
+LockStats::LockStats(const char* name) noexcept
+    : _node({nullptr}), _name(name), _acquisitions(0), _contentions(0), _total_wait_low(0), _total_wait_high(0),
+      _max_wait(0), _max_hold(0) {
+    registry.Add(&_node);
+}
+
+LockStats::~LockStats() noexcept {
+    registry.Remove(&_node);
+}
+
+void LockStats::Reset() noexcept {
+    _acquisitions.store(0, ztd::memory_order_relaxed);
+    _contentions.store(0, ztd::memory_order_relaxed);
+    _total_wait_low.store(0, ztd::memory_order_relaxed);
+    _total_wait_high.store(0, ztd::memory_order_relaxed);
+    _max_wait.store(0, ztd::memory_order_relaxed);
+    _max_hold.store(0, ztd::memory_order_relaxed);
+}
+
+void LockStats::ForEach(void (*fn)(const LockStats& stats, void* user_data), void* user_data) noexcept {
+    struct Visit {
+        void (*fn)(const LockStats& stats, void* user_data);
+        void* user_data;
+    } visit {fn, user_data};
+    registry.ForEach([](sys_snode_t* node, void* visit_data) {
+        const Visit& visit = *static_cast<const Visit*>(visit_data);
+        visit.fn(*CONTAINER_OF(node, LockStats, _node), visit.user_data);
+    }, &visit);
+}
+
+void LockStats::ResetAll() noexcept {
+    registry.ForEach([](sys_snode_t* node, void*) {
+        CONTAINER_OF(node, LockStats, _node)->Reset();
+    }, nullptr);
+}
+
+void LockStats::DumpAll() noexcept {
+    printk("%-24s %10s %10s %12s %10s %10s\n", "lock", "acquired", "contended", "wait_total", "wait_max", "hold_max");
+    ForEach([](const LockStats& stats, void*) {
+        printk("%-24s %10u %10u %12llu %10u %10u\n", stats.Name(), stats.Acquisitions(), stats.Contentions(),
+               static_cast<unsigned long long>(stats.TotalWaitCycles()), stats.MaxWaitCycles(), stats.MaxHoldCycles());
+    }, nullptr);
+}
+
+} // namespace
+
+#endif // defined(CONFIG_FAVONIUS_LOCK_PROFILING)
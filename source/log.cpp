@@ -0,0 +1,312 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include "log.hpp"
+
+#if defined(CONFIG_FAVONIUS_LOG)
+
+#include <sys/printk.h>
+
+#include "algorithm.hpp"
+#include "atomic.hpp"
+
+namespace fav {
+
+namespace {
+
+#if defined(CONFIG_MP_NUM_CPUS) && (CONFIG_MP_NUM_CPUS > 1)
+constexpr size_t cpu_count = CONFIG_MP_NUM_CPUS;
+// A thread may migrate right after reading this, and then write to the ring of another CPU. That is still correct,
+// only contended.
+uint32_t current_cpu() noexcept { return arch_curr_cpu()->id; }
+#else
+constexpr size_t cpu_count = 1;
+uint32_t current_cpu() noexcept { return 0; }
+#endif
+
+constexpr uint32_t ring_words = CONFIG_FAVONIUS_LOG_BUFFER_SIZE / sizeof(uint32_t);
+static_assert(ring_words >= 32 && (ring_words & (ring_words - 1)) == 0,
+              "CONFIG_FAVONIUS_LOG_BUFFER_SIZE must be a power of two of at least 128 bytes.");
+constexpr uint32_t ring_mask = ring_words - 1;
+
+// See Log::Drain() for the layout of a record.
+constexpr uint32_t committed_bit = uint32_t(1) << 31;
+constexpr uint32_t length_shift = 24;
+constexpr uint32_t length_mask = 0x1F;
+constexpr uint32_t level_shift = 21;
+constexpr uint32_t level_mask = 0x7;
+constexpr uint32_t types_mask = (uint32_t(1) << level_shift) - 1;
+constexpr uint32_t max_record_words = length_mask;
+constexpr size_t max_line_length = 128;
+
+// Writers reserve space by advancing head, fill in the record and then publish it by storing its header, which is the
+// only word that is nonzero once committed. The consumer stops at the first header that is still zero, copies the
+// record out, zeroes it and then advances tail, so that the space is clean when writers see it free again.
+struct Ring {
+    ztd::atomic<uint32_t> head;
+    ztd::atomic<uint32_t> tail;
+    ztd::atomic<uint32_t> words[ring_words];
+};
+
+Ring rings[cpu_count];
+ztd::atomic<uint32_t> dropped;
+ztd::atomic_flag consumer_guard;
+
+// Copies the next record of ring into record, and frees it. Returns its length, or 0 if there is none.
+uint32_t take_record(Ring& ring, uint32_t* record) noexcept {
+    const uint32_t tail = ring.tail.load(ztd::memory_order_relaxed);
+    const uint32_t header = ring.words[tail & ring_mask].load(ztd::memory_order_acquire);
+    if ((header & committed_bit) == 0) {
+        return 0;
+    }
+    const uint32_t length = (header >> length_shift) & length_mask;
+    for (uint32_t i = 0; i < length; ++i) {
+        record[i] = ring.words[(tail + i) & ring_mask].load(ztd::memory_order_relaxed);
+        ring.words[(tail + i) & ring_mask].store(0, ztd::memory_order_relaxed);
+    }
+    ring.tail.store(tail + length, ztd::memory_order_release);
+    return length;
+}
+
+// The ring whose next record is the oldest, or cpu_count if all are empty.
+size_t oldest_ring() noexcept {
+    size_t oldest = cpu_count;
+    uint32_t oldest_cycles = 0;
+    for (size_t cpu = 0; cpu < cpu_count; ++cpu) {
+        const uint32_t tail = rings[cpu].tail.load(ztd::memory_order_relaxed);
+        const uint32_t header = rings[cpu].words[tail & ring_mask].load(ztd::memory_order_acquire);
+        if ((header & committed_bit) == 0) {
+            continue;
+        }
+        const uint32_t cycles = rings[cpu].words[(tail + 1) & ring_mask].load(ztd::memory_order_relaxed);
+        // Compared as a difference, so that the timestamps may wrap around.
+        if (oldest == cpu_count || static_cast<int32_t>(cycles - oldest_cycles) < 0) {
+            oldest = cpu;
+            oldest_cycles = cycles;
+        }
+    }
+    return oldest;
+}
+
+struct ConsumerLock {
+    ConsumerLock() noexcept : locked(!consumer_guard.test_and_set(ztd::memory_order_acquire)) {}
+    ~ConsumerLock() noexcept {
+        if (locked) {
+            consumer_guard.clear(ztd::memory_order_release);
+        }
+    }
+    const bool locked;
+};
+
+bool contains(const char* chars, char c) noexcept {
+    for (; *chars != '\0'; ++chars) {
+        if (*chars == c) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+T read_arg(const uint32_t*& args) noexcept {
+    T value;
+    __builtin_memcpy(&value, args, sizeof(T));
+    args += sizeof(T) / sizeof(uint32_t);
+    return value;
+}
+
+// Formats one conversion, given without its length modifiers in spec, with the next argument.
+// An argument whose type does not suit the conversion is printed as <?> instead.
+int format_arg(char* out, size_t size, char* spec, size_t spec_length, char conversion, _detail::LogArgType type,
+               const uint32_t*& args) noexcept {
+    using _detail::LogArgType;
+    const bool wants_integer = contains("diouxXc", conversion);
+    const bool wants_double = contains("fFeEgGaA", conversion);
+    const bool wants_pointer = contains("sp", conversion);
+    const bool is_integer = (type == LogArgType::Int32 || type == LogArgType::Uint32 || type == LogArgType::Int64 ||
+                             type == LogArgType::Uint64);
+    const bool suits = (wants_integer && is_integer) || (wants_double && type == LogArgType::Double) ||
+                       (wants_pointer && type == LogArgType::Pointer);
+
+    if (type == LogArgType::Int64 || type == LogArgType::Uint64) {
+        spec[spec_length++] = 'l';
+        spec[spec_length++] = 'l';
+    }
+    spec[spec_length++] = conversion;
+    spec[spec_length] = '\0';
+
+    switch (type) {
+    case LogArgType::Int32: {
+        const int32_t value = read_arg<int32_t>(args);
+        return suits ? snprintk(out, size, spec, value) : snprintk(out, size, "<?>");
+    }
+    case LogArgType::Uint32: {
+        const uint32_t value = read_arg<uint32_t>(args);
+        return suits ? snprintk(out, size, spec, value) : snprintk(out, size, "<?>");
+    }
+    case LogArgType::Int64: {
+        const long long value = read_arg<int64_t>(args);
+        return suits ? snprintk(out, size, spec, value) : snprintk(out, size, "<?>");
+    }
+    case LogArgType::Uint64: {
+        const unsigned long long value = read_arg<uint64_t>(args);
+        return suits ? snprintk(out, size, spec, value) : snprintk(out, size, "<?>");
+    }
+    case LogArgType::Double: {
+        const double value = read_arg<double>(args);
+        return suits ? snprintk(out, size, spec, value) : snprintk(out, size, "<?>");
+    }
+    case LogArgType::Pointer: {
+        const void* value = read_arg<const void*>(args);
+        if (!suits) {
+            return snprintk(out, size, "<?>");
+        }
+        if (conversion == 's' && value == nullptr) {
+            return snprintk(out, size, "(null)");
+        }
+        return snprintk(out, size, spec, value);
+    }
+    default:
+        return snprintk(out, size, "<missing>");
+    }
+}
+
+// Formats the message of a record into out, which always ends up terminated.
+void format_record(char* out, size_t size, const char* format, uint32_t types, const uint32_t* args) noexcept {
+    size_t pos = 0;
+    const char* p = format;
+    while (*p != '\0' && pos + 1 < size) {
+        if (*p != '%') {
+            out[pos++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            out[pos++] = '%';
+            p += 2;
+            continue;
+        }
+        // Flags, width and precision are kept; length modifiers are dropped and replaced according to the type.
+        const char* const start = p++;
+        char spec[24] = {'%'};
+        size_t spec_length = 1;
+        while (contains("-+ #0123456789.hlLzjt", *p)) {
+            if (!contains("hlLzjt", *p) && spec_length < sizeof(spec) - 4) {
+                spec[spec_length++] = *p;
+            }
+            ++p;
+        }
+        const char conversion = *p;
+        if (!contains("diouxXcfFeEgGaAsp", conversion)) {
+            // Not a supported conversion: print it as text, without consuming an argument.
+            out[pos++] = '%';
+            p = start + 1;
+            continue;
+        }
+        ++p;
+        const auto type = static_cast<_detail::LogArgType>(types & ((1u << _detail::LogArgTypeBits) - 1));
+        types >>= _detail::LogArgTypeBits;
+        const int written = format_arg(out + pos, size - pos, spec, spec_length, conversion, type, args);
+        if (written > 0) {
+            pos += ztd::min(static_cast<size_t>(written), size - pos - 1);
+        }
+    }
+    out[pos] = '\0';
+}
+
+const char* level_name(LogLevel level) noexcept {
+    switch (level) {
+    case LogLevel::Error:
+        return "err";
+    case LogLevel::Warning:
+        return "wrn";
+    case LogLevel::Info:
+        return "inf";
+    default:
+        return "dbg";
+    }
+}
+
+void print_entry(const LogEntry& entry, const char* text, void*) noexcept {
+    printk("[%10u] <%s> %s\n", entry.cycles, level_name(entry.level), text);
+}
+
+struct ProcessContext {
+    Log::OutputFunction output;
+    void* user_data;
+};
+
+void format_and_output(ztd::span<const uint32_t> record, uint32_t cpu, void* user_data) noexcept {
+    const ProcessContext& context = *static_cast<const ProcessContext*>(user_data);
+    const uint32_t header = record[0];
+    LogEntry entry;
+    entry.cycles = record[1];
+    entry.cpu = cpu;
+    entry.level = static_cast<LogLevel>((header >> level_shift) & level_mask);
+    const uint32_t* args = record.data() + 2;
+    entry.format = static_cast<const char*>(read_arg<const void*>(args));
+
+    char text[max_line_length];
+    format_record(text, sizeof(text), entry.format, header & types_mask, args);
+    context.output(entry, text, context.user_data);
+}
+
+} // namespace
+
+void Log::_Commit(LogLevel level, uint32_t types, const uint32_t* payload, size_t words) noexcept {
+    const uint32_t cycles = k_cycle_get_32();
+    Ring& ring = rings[current_cpu()];
+    const uint32_t length = static_cast<uint32_t>(words) + 2;
+
+    uint32_t head = ring.head.load(ztd::memory_order_relaxed);
+    do {
+        // Acquire the tail, so that the consumer has finished zeroing the space before it is written.
+        if (head + length - ring.tail.load(ztd::memory_order_acquire) > ring_words) {
+            dropped.fetch_add(1, ztd::memory_order_relaxed);
+            return;
+        }
+    } while (!ring.head.compare_exchange_weak(head, head + length, ztd::memory_order_relaxed, ztd::memory_order_relaxed));
+
+    ring.words[(head + 1) & ring_mask].store(cycles, ztd::memory_order_relaxed);
+    for (size_t i = 0; i < words; ++i) {
+        ring.words[(head + 2 + i) & ring_mask].store(payload[i], ztd::memory_order_relaxed);
+    }
+    const uint32_t header = committed_bit | (length << length_shift) |
+                            (static_cast<uint32_t>(level) << level_shift) | types;
+    ring.words[head & ring_mask].store(header, ztd::memory_order_release);
+}
+
+size_t Log::Drain(DrainFunction fn, void* user_data, size_t max_records) noexcept {
+    ConsumerLock guard;
+    if (!guard.locked) {
+        return 0;
+    }
+    size_t count = 0;
+    uint32_t record[max_record_words];
+    while (count < max_records) {
+        const size_t cpu = oldest_ring();
+        if (cpu == cpu_count) {
+            break;
+        }
+        const uint32_t length = take_record(rings[cpu], record);
+        fn(ztd::span<const uint32_t>(record, length), static_cast<uint32_t>(cpu), user_data);
+        ++count;
+    }
+    return count;
+}
+
+size_t Log::Process(OutputFunction output, void* user_data, size_t max_messages) noexcept {
+    ProcessContext context {output, user_data};
+    return Drain(&format_and_output, &context, max_messages);
+}
+
+size_t Log::Process(size_t max_messages) noexcept {
+    return Process(&print_entry, nullptr, max_messages);
+}
+
+uint32_t Log::Dropped() noexcept {
+    return dropped.load(ztd::memory_order_relaxed);
+}
+
+} // namespace
+
+#endif // defined(CONFIG_FAVONIUS_LOG)
@@ -3,9 +3,98 @@
 
 #include "mutex.hpp"
 
+namespace {
+
+// Trace events around the k_mutex calls of ztd::mutex and ztd::timed_mutex.
+// Without CONFIG_FAVONIUS_TRACING these are empty.
+
+inline void TraceLock([[maybe_unused]] const void* mutex, [[maybe_unused]] const char* name) noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+    fav::trace::MutexLock(mutex, name);
+#endif
+}
+
+inline void TraceLocked([[maybe_unused]] const void* mutex, [[maybe_unused]] const char* name, [[maybe_unused]] int ret) noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+    fav::trace::MutexLocked(mutex, name, ret);
+#endif
+}
+
+inline void TraceUnlock([[maybe_unused]] const void* mutex, [[maybe_unused]] const char* name) noexcept {
+#if defined(CONFIG_FAVONIUS_TRACING)
+    fav::trace::MutexUnlock(mutex, name);
+#endif
+}
+
+} // namespace
+
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+namespace {
+
+// Locks a k_mutex, recording whether it had to wait and for how long.
+// Only the outermost lock of a recursive k_mutex starts the hold time. The recursion depth is counted in depth rather
+// than read from the k_mutex, which is kernel memory that user threads cannot access.
+int ProfiledLock(k_mutex* mutex, k_timeout_t timeout, fav::LockStats& stats, uint32_t& acquired_at,
+                 uint32_t& depth) noexcept {
+    const uint32_t start = k_cycle_get_32();
+    int ec = k_mutex_lock(mutex, K_NO_WAIT);
+    const bool contended = (ec != 0);
+    if (contended && !K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+        ec = k_mutex_lock(mutex, timeout);
+    }
+    if (ec != 0) {
+        stats.RecordFailedAttempt();
+        return ec;
+    }
+    const uint32_t now = stats.RecordAcquisition(start, contended);
+    if (++depth == 1) {
+        acquired_at = now;
+    }
+    return ec;
+}
+
+int ProfiledUnlock(k_mutex* mutex, fav::LockStats& stats, uint32_t acquired_at, uint32_t& depth) noexcept {
+    if (depth != 0 && --depth == 0) {
+        stats.RecordRelease(acquired_at);
+    }
+    return k_mutex_unlock(mutex);
+}
+
+} // namespace
+#endif // defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+
+#if defined(CONFIG_USERSPACE)
+namespace fav {
+
+FutexMutex::FutexMutex() noexcept {
+    atomic_set(&_futex.val, Unlocked);
+}
+
+void FutexMutex::_LockContended() noexcept {
+    // Mark the lock as contended before sleeping, so that the owner knows it must wake us on unlock.
+    // If the swap returns Unlocked, we have acquired the lock (in the contended state, which is merely pessimistic).
+    while (atomic_set(&_futex.val, Contended) != Unlocked) {
+        // Returns immediately with -EAGAIN if the lock word changed in the meantime.
+        [[maybe_unused]] int ec = k_futex_wait(&_futex, Contended, K_FOREVER);
+    }
+}
+
+void FutexMutex::_UnlockContended() noexcept {
+    atomic_set(&_futex.val, Unlocked);
+    [[maybe_unused]] int woken = k_futex_wake(&_futex, false);
+}
+
+} // namespace
+#endif // defined(CONFIG_USERSPACE)
+
 namespace ztd {
 
+#if !defined(CONFIG_FAVONIUS_FUTEX_MUTEX)
+
 mutex::mutex() noexcept {
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    _lock_depth = 0;
+#endif
     int ec = k_mutex_init(&_mutex);
     if (ec != 0) {
         // TODO: Error-handling, but don't throw
@@ -17,19 +106,41 @@ mutex::~mutex() noexcept {
 }
 
 void mutex::lock() noexcept {
+    TraceLock(this, Name());
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    [[maybe_unused]] int ec = ProfiledLock(&_mutex, K_FOREVER, _stats, _acquired_at, _lock_depth);
+#else
     [[maybe_unused]] int ec = k_mutex_lock(&_mutex, K_FOREVER);
+#endif
+    TraceLocked(this, Name(), ec);
 }
 
 bool mutex::try_lock() noexcept {
+    TraceLock(this, Name());
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    int ec = ProfiledLock(&_mutex, K_NO_WAIT, _stats, _acquired_at, _lock_depth);
+#else
     int ec = k_mutex_lock(&_mutex, K_NO_WAIT);
+#endif
+    TraceLocked(this, Name(), ec);
     return (ec == 0);
 }
 
 void mutex::unlock() noexcept {
+    TraceUnlock(this, Name());
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    [[maybe_unused]] int ec = ProfiledUnlock(&_mutex, _stats, _acquired_at, _lock_depth);
+#else
     [[maybe_unused]] int ec = k_mutex_unlock(&_mutex);
+#endif
 }
 
+#endif // !defined(CONFIG_FAVONIUS_FUTEX_MUTEX)
+
 timed_mutex::timed_mutex() noexcept {
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    _lock_depth = 0;
+#endif
     [[maybe_unused]] int ec = k_mutex_init(&_mutex);
 }
 
@@ -38,21 +149,44 @@ timed_mutex::~timed_mutex() noexcept {
 }
 
 void timed_mutex::lock() noexcept {
+    TraceLock(this, Name());
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    [[maybe_unused]] int ec = ProfiledLock(&_mutex, K_FOREVER, _stats, _acquired_at, _lock_depth);
+#else
     [[maybe_unused]] int ec = k_mutex_lock(&_mutex, K_FOREVER);
+#endif
+    TraceLocked(this, Name(), ec);
 }
 
 bool timed_mutex::try_lock() noexcept {
+    TraceLock(this, Name());
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    int ec = ProfiledLock(&_mutex, K_NO_WAIT, _stats, _acquired_at, _lock_depth);
+#else
     int ec = k_mutex_lock(&_mutex, K_NO_WAIT);
+#endif
+    TraceLocked(this, Name(), ec);
     return (ec == 0);
 }
 
 bool timed_mutex::try_lock_for(uint64_t timeout_duration_ms) noexcept {
+    TraceLock(this, Name());
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    int ec = ProfiledLock(&_mutex, K_MSEC(timeout_duration_ms), _stats, _acquired_at, _lock_depth);
+#else
     int ec = k_mutex_lock(&_mutex, K_MSEC(timeout_duration_ms));
+#endif
+    TraceLocked(this, Name(), ec);
     return (ec == 0);
 }
 
 void timed_mutex::unlock() noexcept {
+    TraceUnlock(this, Name());
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING)
+    [[maybe_unused]] int ec = ProfiledUnlock(&_mutex, _stats, _acquired_at, _lock_depth);
+#else
     [[maybe_unused]] int ec = k_mutex_unlock(&_mutex);
+#endif
 }
 
 } // namespace
\ No newline at end of file
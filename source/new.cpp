@@ -0,0 +1,7 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include "new.hpp"
+
+void* operator new  (size_t count) noexcept { return k_malloc(count); }
+void* operator new[](size_t count) noexcept { return k_malloc(count); }
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include "periodic.hpp"
+
+namespace fav {
+
+PeriodicTask::PeriodicTask(Ticks period, Ticks deadline) noexcept
+    : _period(period.count() > 0 ? period : Ticks(1)), _deadline(deadline.count() > 0 ? deadline : _period), _release(0),
+      _activations(0), _misses(0), _overruns(0), _skipped(0), _max_jitter(0) {}
+
+void PeriodicTask::Start() noexcept {
+    _release = k_uptime_ticks();
+    _activations.fetch_add(1, ztd::memory_order_relaxed);
+    _ArmDeadline(_release);
+}
+
+bool PeriodicTask::WaitForNextPeriod() noexcept {
+    const int64_t now = k_uptime_ticks();
+    const bool met = now <= _release + _deadline.count();
+    if (!met) {
+        _misses.fetch_add(1, ztd::memory_order_relaxed);
+    }
+
+    int64_t next = _release + _period.count();
+    if (now > next) {
+        // Skip to the first release that has not passed yet.
+        const int64_t skipped = (now - next) / _period.count() + 1;
+        next += skipped * _period.count();
+        _overruns.fetch_add(1, ztd::memory_order_relaxed);
+        _skipped.fetch_add(static_cast<uint32_t>(skipped), ztd::memory_order_relaxed);
+    }
+
+#if defined(CONFIG_TIMEOUT_64BIT)
+    [[maybe_unused]] int32_t remaining = k_sleep(K_TIMEOUT_ABS_TICKS(next));
+#else
+    const int64_t delay = next - k_uptime_ticks();
+    if (delay > 0) {
+        [[maybe_unused]] int32_t remaining = k_sleep(K_TICKS(delay));
+    }
+#endif
+
+    const int64_t woken = k_uptime_ticks();
+    const uint32_t jitter = static_cast<uint32_t>(woken - next);
+    uint32_t max_jitter = _max_jitter.load(ztd::memory_order_relaxed);
+    while (jitter > max_jitter && !_max_jitter.compare_exchange_weak(max_jitter, jitter, ztd::memory_order_relaxed)) {}
+
+    _release = next;
+    _activations.fetch_add(1, ztd::memory_order_relaxed);
+    _ArmDeadline(woken);
+    return met;
+}
+
+void PeriodicTask::ResetStatistics() noexcept {
+    _activations.store(0, ztd::memory_order_relaxed);
+    _misses.store(0, ztd::memory_order_relaxed);
+    _overruns.store(0, ztd::memory_order_relaxed);
+    _skipped.store(0, ztd::memory_order_relaxed);
+    _max_jitter.store(0, ztd::memory_order_relaxed);
+}
+
+void PeriodicTask::_ArmDeadline([[maybe_unused]] int64_t now) noexcept {
+#if defined(CONFIG_SCHED_DEADLINE)
+    // k_thread_deadline_set() takes a deadline relative to now, in cycles. Late wake-ups shorten it accordingly.
+    const int64_t remaining = _release + _deadline.count() - now;
+    const uint32_t cycles = k_ticks_to_cyc_ceil32(remaining > 0 ? remaining : 1);
+    k_thread_deadline_set(k_current_get(), static_cast<int>(cycles < INT32_MAX ? cycles : INT32_MAX));
+#endif
+}
+
+} // namespace
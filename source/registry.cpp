@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include "registry.hpp"
+
+namespace fav {
+namespace _detail {
+
+void Registry::Add(sys_snode_t* node) noexcept {
+    const k_spinlock_key_t key = k_spin_lock(&_lock);
+    sys_slist_append(&_list, node);
+    k_spin_unlock(&_lock, key);
+}
+
+void Registry::Remove(sys_snode_t* node) noexcept {
+    _LockWalk();
+    const k_spinlock_key_t key = k_spin_lock(&_lock);
+    sys_slist_find_and_remove(&_list, node);
+    k_spin_unlock(&_lock, key);
+    [[maybe_unused]] int ec = k_mutex_unlock(&_walk);
+}
+
+void Registry::ForEach(void (*fn)(sys_snode_t* node, void* user_data), void* user_data) noexcept {
+    _LockWalk();
+    k_spinlock_key_t key = k_spin_lock(&_lock);
+    sys_snode_t* node = sys_slist_peek_head(&_list);
+    k_spin_unlock(&_lock, key);
+    while (node != nullptr) {
+        fn(node, user_data);
+        key = k_spin_lock(&_lock);
+        node = sys_slist_peek_next(node);
+        k_spin_unlock(&_lock, key);
+    }
+    [[maybe_unused]] int ec = k_mutex_unlock(&_walk);
+}
+
+void Registry::_LockWalk() noexcept {
+    const k_spinlock_key_t key = k_spin_lock(&_lock);
+    if (!_walk_ready) {
+        [[maybe_unused]] int ec = k_mutex_init(&_walk);
+        _walk_ready = true;
+    }
+    k_spin_unlock(&_lock, key);
+    [[maybe_unused]] int ec = k_mutex_lock(&_walk, K_FOREVER);
+}
+
+} // namespace
+} // namespace
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include "semaphore.hpp"
+
+namespace ztd {
+namespace _detail {
+
+bool counting_semaphore_impl::_AcquireContended(int32_t n, k_timeout_t timeout) noexcept {
+    const int64_t deadline = fav::ToDeadline(timeout);
+    bool acquired = false;
+
+    // Registering as a waiter before re-checking the count pairs with release(), which adds to the count
+    // before checking for waiters: either the count is seen here, or the waiter is seen there.
+    _waiters.fetch_add(1);
+    if (n > 1) {
+        _bulk_waiters.fetch_add(1);
+    }
+    while (!(acquired = _TryTake(n))) {
+        const atomic_val_t count = _count.Load();
+        if (count >= n) {
+            continue;
+        }
+        if (!_count.Wait(count, fav::FromDeadline(deadline))) {
+            acquired = _TryTake(n);
+            break;
+        }
+    }
+    if (n > 1) {
+        _bulk_waiters.fetch_sub(1);
+    }
+    _waiters.fetch_sub(1);
+    return acquired;
+}
+
+void counting_semaphore_impl::_Wake(int32_t n) noexcept {
+    // A single count can satisfy exactly one single-count waiter. Anything else may satisfy several waiters,
+    // or a waiter that needs more than we would wake with WakeOne(), so every waiter re-checks the count.
+    if (n == 1 && _bulk_waiters.load() == 0) {
+        _count.WakeOne();
+    } else {
+        _count.WakeAll();
+    }
+}
+
+} // namespace _detail
+} // namespace
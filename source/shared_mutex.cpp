@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include "shared_mutex.hpp"
+
+namespace ztd {
+namespace _detail {
+
+shared_mutex_impl::shared_mutex_impl() noexcept : _readers_waiting(0), _writers_waiting(0) {
+    atomic_clear(&_state);
+    [[maybe_unused]] int ec = k_mutex_init(&_gate);
+    ec = k_condvar_init(&_readers_cv);
+    ec = k_condvar_init(&_writers_cv);
+}
+
+// Must be called with _gate held.
+void shared_mutex_impl::_UpdateWaiterBits() noexcept {
+    if (_writers_waiting > 0) {
+        atomic_or(&_state, WriterPending | Waiters);
+    } else if (_readers_waiting > 0) {
+        atomic_and(&_state, ~WriterPending);
+        atomic_or(&_state, Waiters);
+    } else {
+        atomic_and(&_state, ~(WriterPending | Waiters));
+    }
+}
+
+bool shared_mutex_impl::_LockContended(k_timeout_t timeout) noexcept {
+    const int64_t deadline = fav::ToDeadline(timeout);
+    bool acquired = false;
+
+    [[maybe_unused]] int ec = k_mutex_lock(&_gate, K_FOREVER);
+    _writers_waiting++;
+    // Publishing WriterPending stops new readers, and Waiters forces the current owners to the slow unlock path.
+    _UpdateWaiterBits();
+    while (true) {
+        const atomic_val_t state = atomic_get(&_state);
+        if ((state & (ReaderMask | WriterLocked)) == 0) {
+            if (atomic_cas(&_state, state, state | WriterLocked)) {
+                acquired = true;
+                break;
+            }
+            continue;
+        }
+        if (k_condvar_wait(&_writers_cv, &_gate, fav::FromDeadline(deadline)) != 0) {
+            break;
+        }
+    }
+    _writers_waiting--;
+    _UpdateWaiterBits();
+    if (!acquired && _writers_waiting == 0) {
+        // Readers may have been held back only by this writer.
+        [[maybe_unused]] int woken_threads = k_condvar_broadcast(&_readers_cv);
+    }
+    ec = k_mutex_unlock(&_gate);
+    return acquired;
+}
+
+void shared_mutex_impl::_UnlockContended() noexcept {
+    [[maybe_unused]] int ec = k_mutex_lock(&_gate, K_FOREVER);
+    atomic_and(&_state, ~WriterLocked);
+    if (_writers_waiting > 0) {
+        ec = k_condvar_signal(&_writers_cv);
+    } else {
+        [[maybe_unused]] int woken_threads = k_condvar_broadcast(&_readers_cv);
+    }
+    ec = k_mutex_unlock(&_gate);
+}
+
+bool shared_mutex_impl::_LockSharedContended(k_timeout_t timeout) noexcept {
+    const int64_t deadline = fav::ToDeadline(timeout);
+    bool acquired = false;
+
+    [[maybe_unused]] int ec = k_mutex_lock(&_gate, K_FOREVER);
+    _readers_waiting++;
+    _UpdateWaiterBits();
+    while (true) {
+        if (try_lock_shared()) {
+            acquired = true;
+            break;
+        }
+        if (k_condvar_wait(&_readers_cv, &_gate, fav::FromDeadline(deadline)) != 0) {
+            break;
+        }
+    }
+    _readers_waiting--;
+    _UpdateWaiterBits();
+    ec = k_mutex_unlock(&_gate);
+    return acquired;
+}
+
+void shared_mutex_impl::_UnlockSharedContended() noexcept {
+    // The last reader has left. Only writers can be waiting on readers.
+    [[maybe_unused]] int ec = k_mutex_lock(&_gate, K_FOREVER);
+    if (_writers_waiting > 0) {
+        ec = k_condvar_signal(&_writers_cv);
+    }
+    ec = k_mutex_unlock(&_gate);
+}
+
+} // namespace _detail
+} // namespace
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include "latency.hpp"
+#include "lockstat.hpp"
+
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING_SHELL) || defined(CONFIG_FAVONIUS_LATENCY_PROBES_SHELL)
+
+#include <shell/shell.h>
+
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING_SHELL)
+
+static int cmd_favonius_locks(const struct shell* shell, size_t argc, char** argv) {
+    shell_print(shell, "%-24s %10s %10s %12s %10s %10s", "lock", "acquired", "contended", "wait_total", "wait_max", "hold_max");
+    fav::LockStats::ForEach([](const fav::LockStats& stats, void* user_data) {
+        shell_print(static_cast<const struct shell*>(user_data), "%-24s %10u %10u %12llu %10u %10u", stats.Name(),
+                    stats.Acquisitions(), stats.Contentions(), static_cast<unsigned long long>(stats.TotalWaitCycles()),
+                    stats.MaxWaitCycles(), stats.MaxHoldCycles());
+    }, const_cast<struct shell*>(shell));
+    return 0;
+}
+
+static int cmd_favonius_locks_reset(const struct shell* shell, size_t argc, char** argv) {
+    fav::LockStats::ResetAll();
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_favonius_locks,
+    SHELL_CMD(reset, NULL, "Reset lock contention statistics.", cmd_favonius_locks_reset),
+    SHELL_SUBCMD_SET_END
+);
+
+#endif // defined(CONFIG_FAVONIUS_LOCK_PROFILING_SHELL)
+
+#if defined(CONFIG_FAVONIUS_LATENCY_PROBES_SHELL)
+
+static int cmd_favonius_latency(const struct shell* shell, size_t argc, char** argv) {
+    shell_print(shell, "%-24s %10s %10s %10s %10s %10s %10s", "probe", "count", "min", "p50", "p90", "p99", "max");
+    fav::LatencyHistogram::ForEach([](const fav::LatencyHistogram& histogram, void* user_data) {
+        shell_print(static_cast<const struct shell*>(user_data), "%-24s %10u %10u %10u %10u %10u %10u", histogram.Name(),
+                    histogram.Count(), histogram.Min(), histogram.Percentile(50), histogram.Percentile(90),
+                    histogram.Percentile(99), histogram.Max());
+    }, const_cast<struct shell*>(shell));
+    return 0;
+}
+
+static int cmd_favonius_latency_reset(const struct shell* shell, size_t argc, char** argv) {
+    fav::LatencyHistogram::ResetAll();
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_favonius_latency,
+    SHELL_CMD(reset, NULL, "Reset latency histograms.", cmd_favonius_latency_reset),
+    SHELL_SUBCMD_SET_END
+);
+
+#endif // defined(CONFIG_FAVONIUS_LATENCY_PROBES_SHELL)
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_favonius,
+#if defined(CONFIG_FAVONIUS_LOCK_PROFILING_SHELL)
+    SHELL_CMD(locks, &sub_favonius_locks, "Print lock contention statistics (cycles).", cmd_favonius_locks),
+#endif
+#if defined(CONFIG_FAVONIUS_LATENCY_PROBES_SHELL)
+    SHELL_CMD(latency, &sub_favonius_latency, "Print latency histograms (cycles).", cmd_favonius_latency),
+#endif
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(favonius, &sub_favonius, "Favonius library commands", NULL);
+
+#endif // defined(CONFIG_FAVONIUS_LOCK_PROFILING_SHELL) || defined(CONFIG_FAVONIUS_LATENCY_PROBES_SHELL)
@@ -5,14 +5,29 @@
 
 namespace ztd {
 
-thread::thread() noexcept : _thread({}) {}
+thread::thread() noexcept : _thread({}), _joinable(false) {}
 
 int thread::join() noexcept {
-    return k_thread_join(&_thread, K_NO_WAIT);
+    // A k_thread which was never created has no join queue to wait on.
+    if (!_joinable) {
+        return -EINVAL;
+    }
+    const int ec = k_thread_join(&_thread, K_FOREVER);
+    if (ec == 0) {
+        _joinable = false;
+    }
+#if defined(CONFIG_FAVONIUS_TRACING)
+    fav::trace::ThreadJoin(&_thread, ec);
+#endif
+    return ec;
 }
 
 k_tid_t thread::native_handle() noexcept {
     return &_thread;
 }
 
+void thread::_Trampoline(void* self, void*, void*) noexcept {
+    static_cast<thread*>(self)->_entry();
+}
+
 };
\ No newline at end of file
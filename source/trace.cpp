@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+#include "trace.hpp"
+
+#if defined(CONFIG_FAVONIUS_TRACING)
+
+#if defined(CONFIG_TRACING_CTF)
+
+#include <string.h>
+#include <tracing/tracing_format.h>
+
+namespace {
+
+// Event IDs, which must match tracing/favonius.tsdl.
+// They are kept clear of the IDs used by Zephyr's own CTF events.
+enum EventId : uint8_t {
+    EventAlloc = 0xE0,
+    EventFree = 0xE1,
+    EventQueuePush = 0xE2,
+    EventQueuePop = 0xE3,
+    EventMutexLock = 0xE4,
+    EventMutexLocked = 0xE5,
+    EventMutexUnlock = 0xE6,
+    EventThreadCreate = 0xE7,
+    EventThreadJoin = 0xE8,
+};
+
+// Same layout as ctf_bounded_string_t.
+struct __packed Name {
+    char buf[20];
+};
+
+Name MakeName(const char* name) noexcept {
+    Name bounded = {};
+    if (name != nullptr) {
+        strncpy(bounded.buf, name, sizeof(bounded.buf) - 1);
+    }
+    return bounded;
+}
+
+// Objects are identified by their address, like threads and kernel objects in Zephyr's CTF events.
+uint32_t Id(const void* object) noexcept {
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(object));
+}
+
+// Emits one event the way Zephyr's CTF_EVENT() does: the same header, with the timestamp in nanoseconds like the
+// metadata clock, and under irq_lock() so that no other event is interleaved into its bytes.
+template <typename Fields>
+void Emit(EventId id, const Fields& fields) noexcept {
+    const unsigned int key = irq_lock();
+    struct __packed {
+        uint32_t timestamp;
+        uint8_t id;
+        Fields fields;
+    } event = {static_cast<uint32_t>(k_cyc_to_ns_floor64(k_cycle_get_32())), id, fields};
+    tracing_format_raw_data(reinterpret_cast<uint8_t*>(&event), sizeof(event));
+    irq_unlock(key);
+}
+
+struct __packed AllocFields {
+    uint32_t allocator;
+    Name name;
+    uint32_t bytes;
+    uint32_t ptr;
+};
+
+struct __packed QueueFields {
+    uint32_t queue;
+    Name name;
+    uint32_t depth;
+    uint32_t capacity;
+};
+
+struct __packed MutexFields {
+    uint32_t mutex;
+    Name name;
+};
+
+struct __packed MutexLockedFields {
+    uint32_t mutex;
+    Name name;
+    int32_t ret;
+};
+
+struct __packed ThreadCreateFields {
+    uint32_t thread;
+    uint32_t stack_size;
+};
+
+struct __packed ThreadJoinFields {
+    uint32_t thread;
+    int32_t ret;
+};
+
+} // namespace
+
+namespace fav {
+namespace trace {
+
+void Alloc(const void* allocator, const char* name, uint32_t bytes, const void* ptr) noexcept {
+    Emit(EventAlloc, AllocFields {Id(allocator), MakeName(name), bytes, Id(ptr)});
+}
+
+void Free(const void* allocator, const char* name, uint32_t bytes, const void* ptr) noexcept {
+    Emit(EventFree, AllocFields {Id(allocator), MakeName(name), bytes, Id(ptr)});
+}
+
+void QueuePush(const void* queue, const char* name, uint32_t depth, uint32_t capacity) noexcept {
+    Emit(EventQueuePush, QueueFields {Id(queue), MakeName(name), depth, capacity});
+}
+
+void QueuePop(const void* queue, const char* name, uint32_t depth, uint32_t capacity) noexcept {
+    Emit(EventQueuePop, QueueFields {Id(queue), MakeName(name), depth, capacity});
+}
+
+void MutexLock(const void* mutex, const char* name) noexcept {
+    Emit(EventMutexLock, MutexFields {Id(mutex), MakeName(name)});
+}
+
+void MutexLocked(const void* mutex, const char* name, int ret) noexcept {
+    Emit(EventMutexLocked, MutexLockedFields {Id(mutex), MakeName(name), ret});
+}
+
+void MutexUnlock(const void* mutex, const char* name) noexcept {
+    Emit(EventMutexUnlock, MutexFields {Id(mutex), MakeName(name)});
+}
+
+void ThreadCreate(k_tid_t thread, uint32_t stack_size) noexcept {
+    Emit(EventThreadCreate, ThreadCreateFields {Id(thread), stack_size});
+}
+
+void ThreadJoin(k_tid_t thread, int ret) noexcept {
+    Emit(EventThreadJoin, ThreadJoinFields {Id(thread), ret});
+}
+
+} // namespace
+} // namespace
+
+#else
+
+// Backends other than CTF have no format for these events. The application may provide its own definitions.
+namespace fav {
+namespace trace {
+
+__weak void Alloc(const void*, const char*, uint32_t, const void*) noexcept {}
+__weak void Free(const void*, const char*, uint32_t, const void*) noexcept {}
+__weak void QueuePush(const void*, const char*, uint32_t, uint32_t) noexcept {}
+__weak void QueuePop(const void*, const char*, uint32_t, uint32_t) noexcept {}
+__weak void MutexLock(const void*, const char*) noexcept {}
+__weak void MutexLocked(const void*, const char*, int) noexcept {}
+__weak void MutexUnlock(const void*, const char*) noexcept {}
+__weak void ThreadCreate(k_tid_t, uint32_t) noexcept {}
+__weak void ThreadJoin(k_tid_t, int) noexcept {}
+
+} // namespace
+} // namespace
+
+#endif // defined(CONFIG_TRACING_CTF)
+
+#endif // defined(CONFIG_FAVONIUS_TRACING)
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+// Writes to fav::Log from several threads while it is drained, and checks that every message is either drained intact
+// or counted as dropped, that records survive wrapping around the ring, and how arguments are formatted.
+// Log is compiled out of the host library, so this test builds source/log.cpp itself, with a ring small enough to
+// wrap around and overflow often.
+
+#define CONFIG_FAVONIUS_LOG 1
+#define CONFIG_FAVONIUS_LOG_BUFFER_SIZE 256
+#define CONFIG_FAVONIUS_LOG_LEVEL 4
+
+#include "../../source/log.cpp"
+
+#include <string.h>
+
+#include "thread.hpp"
+
+namespace {
+
+constexpr uint32_t writer_count = 4;
+constexpr uint32_t messages_per_writer = 20000;
+// The arguments of a record follow its header, its timestamp and the address of its format string.
+constexpr size_t first_arg_word = 2 + fav::_detail::LogPointerWords;
+
+ztd::atomic<uint32_t> writers_done(0);
+
+struct Drained {
+    uint32_t count;
+    uint32_t corrupt;
+    uint32_t next[writer_count]; // The lowest sequence number each writer may still have pending.
+};
+
+void CheckRecord(ztd::span<const uint32_t> record, uint32_t, void* user_data) {
+    Drained& drained = *static_cast<Drained*>(user_data);
+    ++drained.count;
+    if (record.size() != first_arg_word + 2) {
+        ++drained.corrupt;
+        return;
+    }
+    const uint32_t writer = record[first_arg_word];
+    const uint32_t sequence = record[first_arg_word + 1];
+    // Messages of one writer stay in order, although dropped ones leave gaps.
+    if (writer >= writer_count || sequence < drained.next[writer]) {
+        ++drained.corrupt;
+        return;
+    }
+    drained.next[writer] = sequence + 1;
+}
+
+void Write(uint32_t writer) {
+    for (uint32_t sequence = 0; sequence < messages_per_writer; ++sequence) {
+        fav::Log::Info("writer %u message %u", writer, sequence);
+    }
+    writers_done.fetch_add(1);
+}
+
+struct Output {
+    char text[8][fav::max_line_length];
+    fav::LogLevel level[8];
+    size_t count;
+};
+
+void Collect(const fav::LogEntry& entry, const char* text, void* user_data) {
+    Output& output = *static_cast<Output*>(user_data);
+    if (output.count < 8) {
+        strncpy(output.text[output.count], text, sizeof(output.text[0]) - 1);
+        output.text[output.count][sizeof(output.text[0]) - 1] = '\0';
+        output.level[output.count] = entry.level;
+    }
+    ++output.count;
+}
+
+int Check(bool condition, const char* what) {
+    if (!condition) {
+        printk("FAIL: %s\n", what);
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+
+    // Records wrap around the end of the ring many times, and are read back intact.
+    {
+        bool intact = true;
+        for (uint32_t round = 0; round < 200; ++round) {
+            for (uint32_t i = 0; i < 3; ++i) {
+                fav::Log::Info("n=%u m=%u", round * 3 + i, (round * 3 + i) * 7);
+            }
+            Output output = {};
+            intact = intact && (fav::Log::Process(&Collect, &output) == 3);
+            for (uint32_t i = 0; i < 3 && intact; ++i) {
+                char expected[32];
+                snprintk(expected, sizeof(expected), "n=%u m=%u", round * 3 + i, (round * 3 + i) * 7);
+                intact = (strcmp(output.text[i], expected) == 0);
+            }
+        }
+        failures += Check(intact, "records are intact after wrapping around the ring");
+        failures += Check(fav::Log::Dropped() == 0, "nothing is dropped while the ring has space");
+    }
+
+    // A full ring drops and counts the messages which do not fit.
+    {
+        constexpr uint32_t words_per_message = first_arg_word + 1;
+        constexpr uint32_t fit = fav::ring_words / words_per_message;
+        for (uint32_t i = 0; i < fit + 5; ++i) {
+            fav::Log::Warning("%u", i);
+        }
+        Output output = {};
+        failures += Check(fav::Log::Process(&Collect, &output) == fit, "a full ring keeps what fits");
+        failures += Check(fav::Log::Dropped() == 5, "messages which do not fit are counted as dropped");
+        failures += Check(output.level[0] == fav::LogLevel::Warning, "the level is kept");
+    }
+
+    // Several writers race each other and the consumer.
+    {
+        const uint32_t dropped_before = fav::Log::Dropped();
+        Drained drained = {};
+        static_assert(writer_count == 4, "One thread object per writer.");
+        ztd::thread first(&Write, 0u);
+        ztd::thread second(&Write, 1u);
+        ztd::thread third(&Write, 2u);
+        ztd::thread fourth(&Write, 3u);
+        while (writers_done.load() < writer_count) {
+            fav::Log::Drain(&CheckRecord, &drained);
+        }
+        first.join();
+        second.join();
+        third.join();
+        fourth.join();
+        fav::Log::Drain(&CheckRecord, &drained);
+        const uint32_t dropped = fav::Log::Dropped() - dropped_before;
+        failures += Check(drained.corrupt == 0, "drained records are intact and in order per writer");
+        failures += Check(drained.count + dropped == writer_count * messages_per_writer,
+                          "every message is either drained or counted as dropped");
+    }
+
+    // Arguments are formatted by their recorded type, whatever the length modifiers say.
+    {
+        fav::Log::Info("%s|%5.2f|%d|%x|%%|%c", "hi", 3.14159, int64_t(-5), 255u, 'A');
+        fav::Log::Info("a=%ld b=%d", 1);
+        fav::Log::Info("%s %d", 5, "text");
+        fav::Log::Info("%s", static_cast<const char*>(nullptr));
+        fav::Log::Info("%y %hhu", 300);
+        Output output = {};
+        fav::Log::Process(&Collect, &output);
+        failures += Check(output.count == 5, "every formatted message is processed");
+        failures += Check(strcmp(output.text[0], "hi| 3.14|-5|ff|%|A") == 0, "conversions of every type");
+        failures += Check(strcmp(output.text[1], "a=1 b=<missing>") == 0, "a missing argument");
+        failures += Check(strcmp(output.text[2], "<?> <?>") == 0, "arguments which do not suit the conversion");
+        failures += Check(strcmp(output.text[3], "(null)") == 0, "a null string");
+        failures += Check(strcmp(output.text[4], "%y 300") == 0, "an unsupported conversion is printed as text");
+    }
+
+    printk("%s\n", (failures == 0) ? "PASS" : "FAIL");
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+// Creates and destroys objects in a fav::ObjectPool, and checks that handles to destroyed objects are detected as
+// stale, also once their slot has been reused, and that objects are constructed and destroyed exactly once.
+
+#include <kernel.h>
+
+#include "objectpool.hpp"
+
+namespace {
+
+int live_objects = 0;
+
+struct Counted {
+    explicit Counted(int value) : value(value) { ++live_objects; }
+    ~Counted() { --live_objects; }
+    int value;
+};
+
+using Pool = fav::ObjectPool<Counted, 4>;
+
+int Check(bool condition, const char* what) {
+    if (!condition) {
+        printk("FAIL: %s\n", what);
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+
+    {
+        Pool pool;
+
+        // A destroyed object's handle goes stale, and stays stale when the slot is reused.
+        const Pool::Handle first = pool.Create(1);
+        failures += Check(!first.IsNull() && pool.Get(first)->value == 1, "Create() returns a live handle");
+        failures += Check(pool.Destroy(first), "Destroy() of a live handle");
+        failures += Check(pool.Get(first) == nullptr && !pool.Contains(first), "a destroyed handle is stale");
+        failures += Check(!pool.Destroy(first), "Destroy() of a stale handle fails");
+        const Pool::Handle reused = pool.Create(2);
+        failures += Check(reused != first, "a reused slot gets a new handle");
+        failures += Check(pool.Get(first) == nullptr, "a stale handle does not reach the object in the reused slot");
+        failures += Check(pool.Get(reused)->value == 2, "the handle of the reused slot is live");
+
+        // Handles survive a round trip through an integer; null and forged handles refer to nothing.
+        failures += Check(pool.Get(Pool::Handle::FromValue(reused.Value())) == pool.Get(reused),
+                          "Handle::FromValue(Value()) refers to the same object");
+        failures += Check(pool.Get(Pool::Handle()) == nullptr && !pool.Destroy(Pool::Handle()),
+                          "the null handle refers to nothing");
+        failures += Check(pool.Get(Pool::Handle::FromValue(reused.Value() + 1)) == nullptr,
+                          "a handle to a free slot refers to nothing");
+        failures += Check(pool.Get(Pool::Handle::FromValue(reused.Value() ^ 0x100)) == nullptr,
+                          "a handle with another generation refers to nothing");
+
+        // A full pool refuses, and iteration visits exactly the live objects.
+        const Pool::Handle b = pool.Create(3);
+        const Pool::Handle c = pool.Create(4);
+        const Pool::Handle d = pool.Create(5);
+        failures += Check(pool.Full() && pool.Create(6).IsNull(), "Create() on a full pool returns a null handle");
+        failures += Check(pool.Destroy(c), "Destroy() in the middle of the dense list");
+        int sum = 0;
+        bool handles_match = true;
+        for (auto it = pool.begin(); it != pool.end(); ++it) {
+            sum += it->value;
+            handles_match = handles_match && (pool.Get(it.GetHandle()) == &*it) &&
+                            (pool.GetHandle(*it) == it.GetHandle());
+        }
+        failures += Check(sum == 2 + 3 + 5 && pool.Size() == 3, "iteration visits the live objects");
+        failures += Check(handles_match, "iterator and object handles agree");
+        const Counted outside(0);
+        failures += Check(pool.GetHandle(outside).IsNull(), "GetHandle() of an object outside the pool is null");
+
+        // Clear() destroys everything and makes every handle stale.
+        pool.Clear();
+        failures += Check(pool.Empty() && live_objects == 1, "Clear() destroys every object");
+        failures += Check(pool.Get(reused) == nullptr && pool.Get(b) == nullptr && pool.Get(d) == nullptr,
+                          "Clear() makes every handle stale");
+
+        // Many reuses of one slot never bring back an old handle.
+        const Pool::Handle oldest = pool.Create(7);
+        Pool::Handle latest = oldest;
+        bool distinct = true;
+        for (int i = 0; i < 10000; ++i) {
+            pool.Destroy(latest);
+            const Pool::Handle next = pool.Create(i);
+            distinct = distinct && (next != latest) && (next != oldest) && (pool.Get(oldest) == nullptr);
+            latest = next;
+        }
+        failures += Check(distinct, "reusing a slot many times never revives an old handle");
+    }
+    failures += Check(live_objects == 0, "the pool destroys its objects");
+
+    printk("%s\n", (failures == 0) ? "PASS" : "FAIL");
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+// Pushes, pops, updates and removes entries of a fav::PriorityQueue at random, against a plain array as reference,
+// and checks that handles of entries which have left the queue are detected as stale.
+
+#include <kernel.h>
+
+#include "functional.hpp"
+#include "priorityqueue.hpp"
+
+namespace {
+
+constexpr size_t capacity = 64;
+
+using Queue = fav::PriorityQueue<uint32_t, capacity, ztd::greater<uint32_t>>;
+
+uint32_t random_state = 4242;
+
+uint32_t Random() {
+    random_state = random_state * 1103515245u + 12345u;
+    return random_state >> 8;
+}
+
+uint32_t UniqueValue(uint32_t step) {
+    return ((Random() % 1000) << 18) | step;
+}
+
+// What the queue should hold: the value and handle of each entry, in no particular order.
+struct Reference {
+    uint32_t values[capacity];
+    Queue::Handle handles[capacity];
+    size_t size;
+
+    size_t Smallest() const {
+        size_t smallest = 0;
+        for (size_t i = 1; i < size; ++i) {
+            if (values[i] < values[smallest]) {
+                smallest = i;
+            }
+        }
+        return smallest;
+    }
+
+    void Erase(size_t i) {
+        values[i] = values[size - 1];
+        handles[i] = handles[size - 1];
+        --size;
+    }
+};
+
+int Check(bool condition, const char* what) {
+    if (!condition) {
+        printk("FAIL: %s\n", what);
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    static Queue queue;
+    static Reference reference;
+
+    // Handles go stale when their entry leaves by Pop(), Remove() or Clear(), also once the slot is reused.
+    {
+        const Queue::Handle popped = queue.Push(5);
+        failures += Check(queue.Pop() == 5, "Pop() returns the only entry");
+        failures += Check(!queue.Contains(popped) && queue.Get(popped) == nullptr, "a popped handle is stale");
+        failures += Check(!queue.Update(popped, 1) && !queue.Remove(popped), "a popped handle cannot be used");
+        const Queue::Handle reused = queue.Push(6);
+        failures += Check(reused != popped && queue.Get(popped) == nullptr,
+                          "a stale handle does not reach the entry in the reused slot");
+        failures += Check(queue.Remove(reused) && !queue.Remove(reused), "a removed handle is stale");
+        const Queue::Handle cleared = queue.Push(7);
+        queue.Clear();
+        failures += Check(queue.Get(cleared) == nullptr && queue.Empty(), "Clear() makes every handle stale");
+        failures += Check(queue.Get(Queue::Handle()) == nullptr && !queue.Remove(Queue::Handle()),
+                          "the null handle refers to nothing");
+    }
+
+    // Random operations agree with the reference, and stale handles stay stale throughout.
+    // Every value is unique, made so by the step in its low bits, so that the entry Pop() removes is known.
+    {
+        Queue::Handle stale[16] = {};
+        size_t stale_count = 0;
+        bool agrees = true;
+        bool stays_stale = true;
+        for (uint32_t step = 0; step < (uint32_t(1) << 18) && agrees; ++step) {
+            const uint32_t operation = Random() % 8;
+            if (operation < 3 && reference.size < capacity) {
+                const uint32_t value = UniqueValue(step);
+                reference.values[reference.size] = value;
+                reference.handles[reference.size] = queue.Push(value);
+                ++reference.size;
+            } else if (operation < 5 && reference.size > 0) {
+                const size_t smallest = reference.Smallest();
+                agrees = (queue.Top() == reference.values[smallest]) && (queue.Pop() == reference.values[smallest]);
+                stale[stale_count++ % 16] = reference.handles[smallest];
+                reference.Erase(smallest);
+            } else if (operation < 7 && reference.size > 0) {
+                const size_t i = Random() % reference.size;
+                const uint32_t value = UniqueValue(step);
+                agrees = queue.Update(reference.handles[i], value);
+                reference.values[i] = value;
+            } else if (reference.size > 0) {
+                const size_t i = Random() % reference.size;
+                agrees = queue.Remove(reference.handles[i]);
+                stale[stale_count++ % 16] = reference.handles[i];
+                reference.Erase(i);
+            }
+            agrees = agrees && (queue.Size() == reference.size);
+            for (const Queue::Handle& handle : stale) {
+                stays_stale = stays_stale && (handle.IsNull() || !queue.Contains(handle));
+            }
+        }
+        failures += Check(agrees, "random operations agree with the reference");
+        failures += Check(stays_stale, "removed handles stay stale while their slots are reused");
+    }
+
+    // Assign() builds a heap, and hands out a live handle per value.
+    {
+        const uint32_t values[] = {9, 3, 7, 1, 8, 2, 6};
+        Queue::Handle handles[7];
+        failures += Check(queue.Assign(values, handles) == 7, "Assign() takes every value");
+        bool linked = true;
+        for (size_t i = 0; i < 7; ++i) {
+            linked = linked && (queue.Get(handles[i]) != nullptr) && (*queue.Get(handles[i]) == values[i]);
+        }
+        failures += Check(linked, "Assign() hands out the handle of each value");
+        queue.Update(handles[0], 0);
+        const uint32_t expected[] = {0, 1, 2, 3, 6, 7, 8};
+        bool ordered = true;
+        for (uint32_t value : expected) {
+            ordered = ordered && (queue.Pop() == value);
+        }
+        failures += Check(ordered && queue.Empty(), "entries leave in order after Assign() and Update()");
+        failures += Check(queue.Get(handles[3]) == nullptr, "handles from Assign() go stale");
+    }
+
+    printk("%s\n", (failures == 0) ? "PASS" : "FAIL");
+    return (failures == 0) ? 0 : 1;
+}
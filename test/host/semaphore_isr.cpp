@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+// Releases semaphores from irq_offload(), in which the kernel stand-in asserts on anything Zephyr forbids in an ISR,
+// such as locking a k_mutex.
+
+#include <irq_offload.h>
+#include <kernel.h>
+
+#include "atomic.hpp"
+#include "semaphore.hpp"
+#include "thread.hpp"
+
+namespace {
+
+ztd::counting_semaphore<8> semaphore(0);
+ztd::atomic<uint32_t> acquired(0);
+
+void Release(const void* update) {
+    semaphore.release(*static_cast<const int32_t*>(update));
+}
+
+void AcquireOne() {
+    semaphore.acquire();
+    acquired.fetch_add(1);
+}
+
+void AcquireTwo() {
+    semaphore.AcquireMany(2);
+    acquired.fetch_add(2);
+}
+
+int Check(bool condition, const char* what) {
+    if (!condition) {
+        printk("FAIL: %s\n", what);
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+
+    // A single waiter, woken with WakeOne().
+    {
+        ztd::thread waiter(&AcquireOne);
+        k_msleep(20);
+        const int32_t one = 1;
+        irq_offload(&Release, &one);
+        waiter.join();
+        failures += Check(acquired.load() == 1, "release(1) from an ISR wakes the waiter");
+    }
+
+    // Several waiters, including a bulk one, woken with WakeAll().
+    {
+        ztd::thread first(&AcquireOne);
+        ztd::thread second(&AcquireOne);
+        ztd::thread bulk(&AcquireTwo);
+        k_msleep(20);
+        const int32_t four = 4;
+        irq_offload(&Release, &four);
+        first.join();
+        second.join();
+        bulk.join();
+        failures += Check(acquired.load() == 5, "release(4) from an ISR wakes every waiter");
+        failures += Check(semaphore.Count() == 0, "every count was taken");
+    }
+
+    // No waiters: the count is only added to.
+    {
+        const int32_t one = 1;
+        irq_offload(&Release, &one);
+        failures += Check(semaphore.try_acquire(), "release(1) from an ISR without waiters");
+    }
+
+    printk("%s\n", (failures == 0) ? "PASS" : "FAIL");
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2022 Tan Li Boon
+
+// Sorts inputs of many sizes and shapes with ztd::sort, and checks that the result is ordered, is a permutation of the
+// input, and took O(n log n) comparisons even on inputs which defeat the choice of pivot.
+
+#include <kernel.h>
+
+#include "algorithm.hpp"
+#include "array.hpp"
+
+namespace {
+
+constexpr size_t max_size = 1024;
+
+struct Entry {
+    uint32_t key;
+    uint32_t origin; // Index in the input, to check that the output is a permutation of it.
+};
+
+uint32_t random_state = 12345;
+
+uint32_t Random() {
+    random_state = random_state * 1103515245u + 12345u;
+    return random_state >> 8;
+}
+
+enum class Shape { Random, FewKeys, Sorted, Reversed, OrganPipe, Equal, Sawtooth };
+
+void Fill(Entry* entries, size_t n, Shape shape) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t key = 0;
+        switch (shape) {
+        case Shape::Random: key = Random(); break;
+        case Shape::FewKeys: key = Random() % 4; break;
+        case Shape::Sorted: key = static_cast<uint32_t>(i); break;
+        case Shape::Reversed: key = static_cast<uint32_t>(n - i); break;
+        case Shape::OrganPipe: key = static_cast<uint32_t>((i < n / 2) ? i : n - i); break;
+        case Shape::Equal: key = 7; break;
+        case Shape::Sawtooth: key = static_cast<uint32_t>(i % 17); break;
+        }
+        entries[i] = Entry {key, static_cast<uint32_t>(i)};
+    }
+}
+
+// McIlroy's adversary ("A Killer Adversary for Quicksort"): values start as gas and are frozen lazily, so that the
+// pivot always turns out to be among the smallest. The comparisons stay consistent with one input, the one a plain
+// quicksort is quadratic on, so only the fallback to heapsort keeps the count down.
+struct Adversary {
+    uint32_t values[max_size];
+    uint32_t gas;
+    uint32_t solid;
+    uint32_t candidate;
+    size_t comparisons;
+
+    bool Less(uint32_t x, uint32_t y) {
+        ++comparisons;
+        if (values[x] == gas && values[y] == gas) {
+            values[(x == candidate) ? x : y] = solid++;
+        }
+        if (values[x] == gas) {
+            candidate = x;
+        } else if (values[y] == gas) {
+            candidate = y;
+        }
+        return values[x] < values[y];
+    }
+};
+
+// Whether sorted holds the entries of input, each exactly once, in order of key.
+bool IsSortedPermutation(const Entry* input, const Entry* sorted, size_t n) {
+    bool seen[max_size] = {};
+    for (size_t i = 0; i < n; ++i) {
+        const Entry& entry = sorted[i];
+        if (entry.origin >= n || seen[entry.origin] || input[entry.origin].key != entry.key) {
+            return false;
+        }
+        seen[entry.origin] = true;
+        if (i > 0 && sorted[i - 1].key > entry.key) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int Check(bool condition, const char* what) {
+    if (!condition) {
+        printk("FAIL: %s\n", what);
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    static Entry input[max_size];
+    static Entry sorted[max_size];
+
+    // Every shape at every size up to a few times the insertion sort threshold, and some larger ones.
+    bool ordered = true;
+    bool bounded = true;
+    const Shape shapes[] = {Shape::Random, Shape::FewKeys, Shape::Sorted, Shape::Reversed,
+                            Shape::OrganPipe, Shape::Equal, Shape::Sawtooth};
+    for (Shape shape : shapes) {
+        for (size_t n = 0; n <= max_size; n = (n < 80) ? n + 1 : n * 2) {
+            Fill(input, n, shape);
+            for (size_t i = 0; i < n; ++i) {
+                sorted[i] = input[i];
+            }
+            size_t comparisons = 0;
+            ztd::sort(sorted, sorted + n, [&comparisons](const Entry& a, const Entry& b) {
+                ++comparisons;
+                return a.key < b.key;
+            });
+            ordered = ordered && IsSortedPermutation(input, sorted, n);
+            size_t log2 = 1;
+            while ((size_t(1) << log2) < n) {
+                ++log2;
+            }
+            // Generous, but far below the n * n / 4 of a quadratic quicksort at the larger sizes.
+            bounded = bounded && (comparisons <= 8 * n * log2 + 64);
+        }
+    }
+    failures += Check(ordered, "sort() orders every input and keeps every entry");
+    failures += Check(bounded, "sort() takes O(n log n) comparisons");
+
+    // An input built against the choice of pivot.
+    {
+        static Adversary adversary;
+        static uint32_t indices[max_size];
+        const uint32_t n = max_size;
+        adversary.gas = n;
+        adversary.solid = 0;
+        adversary.candidate = 0;
+        adversary.comparisons = 0;
+        for (uint32_t i = 0; i < n; ++i) {
+            adversary.values[i] = n;
+            indices[i] = i;
+        }
+        ztd::sort(indices, indices + n, [](uint32_t x, uint32_t y) { return adversary.Less(x, y); });
+        bool killer_ordered = true;
+        for (uint32_t i = 1; i < n; ++i) {
+            killer_ordered = killer_ordered && !(adversary.values[indices[i]] < adversary.values[indices[i - 1]]);
+        }
+        failures += Check(killer_ordered, "sort() orders the adversarial input");
+        // log2(1024) is 10.
+        failures += Check(adversary.comparisons <= 8 * n * 10 + 64,
+                          "sort() falls back to heapsort on the adversarial input");
+    }
+
+    // The default comparison, a custom one, and a ztd::array.
+    {
+        int values[] = {5, -3, 9, 0, 9, -3, 1};
+        ztd::sort(values, values + 7);
+        failures += Check(ztd::is_sorted(values, values + 7), "sort() with operator<");
+        ztd::sort(values, values + 7, [](int a, int b) { return a > b; });
+        failures += Check(values[0] == 9 && values[6] == -3 && ztd::is_sorted(values, values + 7,
+                          [](int a, int b) { return a > b; }), "sort() with a custom comparison");
+        ztd::array<uint8_t, 5> bytes = {{4, 2, 255, 0, 2}};
+        ztd::sort(bytes.begin(), bytes.end());
+        failures += Check(bytes[0] == 0 && bytes[4] == 255 && ztd::is_sorted(bytes.begin(), bytes.end()),
+                          "sort() over ztd::array iterators");
+    }
+
+    printk("%s\n", (failures == 0) ? "PASS" : "FAIL");
+    return (failures == 0) ? 0 : 1;
+}